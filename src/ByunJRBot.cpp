@@ -27,10 +27,13 @@ void ByunJRBot::OnGameStart()
     // Ignore file extension of the local_map_path.
     config_.MapName = config_.MapName.substr(0, config_.MapName.find('.'));
 
+    // Everything below looks up unit type data through this table, so it has to be filled first.
+    unit_types_.Build(Observation());
     strategy_.OnStart();
     map_.OnStart();
     information_manager_.OnStart();
     bases_.OnStart();
+    information_manager_.BuildingPlacer().IndexBaseLocations();
 
     production_manager_.OnStart();
     scout_manager_.OnStart();
@@ -84,6 +87,7 @@ void ByunJRBot::OnUnitDestroyed(const sc2::Unit* unit)
 {
     information_manager_.OnUnitDestroyed(unit);
     production_manager_.OnUnitDestroyed(unit);
+    path_cache_.Remove(unit);
 }
 
 void ByunJRBot::OnUnitEnterVision(const sc2::Unit* unit) {
@@ -116,6 +120,21 @@ const MapTools & ByunJRBot::Map() const
     return map_;
 }
 
+const UnitTypeTable & ByunJRBot::UnitTypes() const
+{
+    return unit_types_;
+}
+
+ThreadPool & ByunJRBot::Threads()
+{
+    return thread_pool_;
+}
+
+PathCache & ByunJRBot::Paths()
+{
+    return path_cache_;
+}
+
 const StrategyManager & ByunJRBot::Strategy() const
 {
     return strategy_;
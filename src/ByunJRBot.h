@@ -3,6 +3,7 @@
 #include <sc2api/sc2_api.h>
 
 #include "InformationManager.h"
+#include "ai/PathCache.h"
 #include "global/BotConfig.h"
 #include "global/Debug.h"
 #include "StrategyManager.h"
@@ -13,7 +14,9 @@
 #include "micro/ScoutManager.h"
 #include "micro/CombatCommander.h"
 #include "information/BaseLocationManager.h"
+#include "information/UnitTypeTable.h"
 #include "util/MapTools.h"
+#include "util/ThreadPool.h"
 
 #define DllExport   __declspec( dllexport )  
 
@@ -22,6 +25,7 @@ class ByunJRBot : public sc2::Agent
     CombatCommander          combat_commander_;
     InformationManager       information_manager_;
 
+    UnitTypeTable            unit_types_;
     MapTools                 map_;
     BaseLocationManager      bases_;
     StrategyManager          strategy_;
@@ -32,6 +36,8 @@ class ByunJRBot : public sc2::Agent
     ProxyManager             proxy_manager_;
     DebugManager             debug_;
     WorkerManager            workers_;
+    ThreadPool               thread_pool_;
+    PathCache                path_cache_;
 
     bool                     is_willing_to_fight_;
     int                      frame_skip_;
@@ -58,6 +64,9 @@ public:
     DebugManager& DebugHelper();
     InformationManager & InformationManager();
     const MapTools & Map() const;
+    const UnitTypeTable & UnitTypes() const;
+    ThreadPool & Threads();
+    PathCache & Paths();
     ProxyManager & GetProxyManager();
     const StrategyManager & Strategy() const;
     sc2::Point2D GetStartLocation() const;
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <sc2api/sc2_api.h>
 
 #include "ByunJRBot.h"
@@ -7,6 +8,17 @@
 #include "information/unitInfo.h"
 #include "util/Util.h"
 
+namespace
+{
+    const float flee_lookahead = 2.0f;
+
+    // About one marine. Anything less than this and we can pick off workers without getting hurt much.
+    const float safe_dps = 10.0f;
+
+    // Anything flatter than this is just rounding, run straight away instead.
+    const float min_flee_gradient = 0.1f;
+}
+
 InformationManager::InformationManager(ByunJRBot & bot)
     : bot_(bot)
     , building_placer_(bot)
@@ -34,14 +46,13 @@ void InformationManager::OnStart()
         }
     }
 
+    threat_map_.Reset(bot_.Map().TrueMapWidth(), bot_.Map().TrueMapHeight());
     for (int y = 0; y < bot_.Map().TrueMapHeight(); ++y)
     {
-        dps_map_.push_back(std::vector<int>());
         for (int x = 0; x < bot_.Map().TrueMapWidth(); ++x)
         {
-            // There is an inherit "danger" for traveling through any square. 
-            // Don't use 0, otherwise we won't find the "shortest and safest path"
-            dps_map_[y].push_back(1);
+            if (!bot_.Map().IsWalkable(x, y))
+                threat_map_.SetUnwalkable(x, y);
         }
     }
 }
@@ -58,48 +69,42 @@ void InformationManager::OnUnitDestroyed(const sc2::Unit* unit)
 void InformationManager::OnFrame()
 {
     unit_info_.OnFrame();
+    building_placer_.OnFrame();
 
-    // Reset dps_map_
-    for (const auto & unit : unit_info_.GetUnits(PlayerArrayIndex::Enemy))
+    // Only enemies that moved (or showed up, or died) change the threat map.
+    const uint32_t game_loop = bot_.Observation()->GetGameLoop();
+    threat_map_.BeginFrame(game_loop);
+    for (const ::UnitInfo & unit_info : unit_info_.GetUnitInfoMap(PlayerArrayIndex::Enemy))
     {
-        for (int y = 0; y < dps_map_.size(); ++y)
-        {
-            for (int x = 0; x < dps_map_[y].size(); ++x)
-            {
-                dps_map_[y][x] = 1;
-            }
-        }
-    }
+        const sc2::Unit* unit = unit_info.unit;
+        const bool visible = unit->last_seen_game_loop == game_loop;
+
+        // Enemies we lost track of a while ago could be anywhere by now.
+        if (!visible && game_loop - unit->last_seen_game_loop > ThreatMap::memory_game_loops) continue;
+
+        const UnitTypeTraits & traits = bot_.UnitTypes().Get(unit_info.type);
+        UnitThreat threat;
+        threat.damage = static_cast<int>(traits.max_damage);
+        threat.radius = static_cast<int>(traits.max_range);
+        threat.ground_dps = traits.ground_dps;
+        threat.ground_radius = static_cast<int>(std::ceil(traits.ground_range));
+        threat.air_dps = traits.air_dps;
+        threat.air_radius = static_cast<int>(std::ceil(traits.air_range));
+        if (threat.damage == 0 && threat.ground_dps == 0 && threat.air_dps == 0) continue;
 
-    // Update dps_map_
-    for(const auto & unit : unit_info_.GetUnits(PlayerArrayIndex::Enemy))
-    {
-        const int damage = Util::GetAttackDamage(unit->unit_type, bot_);
-        if (damage == 0) continue;
-        int range = Util::GetAttackRange(unit->unit_type, bot_);
         //  Melee units are dangerous too.
-        if (range == 0 && !Util::IsBuilding(unit->unit_type)) range = 2;
-
-        for (int y = 0; y < dps_map_.size(); ++y)
+        if (!traits.is_building)
         {
-            for (int x = 0; x < dps_map_[y].size(); ++x)
-            {
-                if( Util::DistSq(sc2::Point2D(x,y),unit->pos) <= (range*range) )
-                {
-                    dps_map_[y][x] += damage;
-                }
-            }
+            if (threat.radius == 0) threat.radius = 2;
+            if (threat.ground_dps > 0 && threat.ground_radius < 2) threat.ground_radius = 2;
         }
-    }
 
-    for (int y = 0; y < bot_.Map().TrueMapHeight(); ++y)
-    {
-        for (int x = 0; x < bot_.Map().TrueMapWidth(); ++x)
-        {
-            if (!bot_.Map().IsWalkable(x, y))
-                dps_map_[y][x] = 999;
-        }
+        if (visible)
+            threat_map_.StampUnit(unit->tag, unit->pos, threat);
+        else
+            threat_map_.StampMemory(unit->tag, unit_info.lastPosition, threat, unit->last_seen_game_loop);
     }
+    threat_map_.EndFrame();
 }
 
 BuildingPlacer & InformationManager::BuildingPlacer()
@@ -141,141 +146,62 @@ const sc2::Unit* InformationManager::GetBuilder(Building& b, const bool set_job_
 // Does not look for flying bases. Only landed bases. 
 const sc2::Unit* InformationManager::GetClosestBase(const sc2::Unit* reference_unit) const
 {
-    const sc2::Unit* closest_unit = nullptr;
-    double closest_distance = std::numeric_limits<double>::max();
-
-    for (auto unit : bot_.InformationManager().UnitInfo().GetUnits(PlayerArrayIndex::Self))
+    return unit_info_.GetUnitGrid(PlayerArrayIndex::Self).GetClosest(reference_unit->pos, [](const sc2::Unit* unit)
     {
-        if (unit->unit_type == sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER
-        ||  unit->unit_type == sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND
-        ||  unit->unit_type == sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS
-        ||  unit->unit_type == sc2::UNIT_TYPEID::PROTOSS_NEXUS
-        ||  unit->unit_type == sc2::UNIT_TYPEID::ZERG_HATCHERY
-        ||  unit->unit_type == sc2::UNIT_TYPEID::ZERG_LAIR
-        ||  unit->unit_type == sc2::UNIT_TYPEID::ZERG_HIVE)
-        {
-            const double distance = Util::DistSq(unit->pos, reference_unit->pos);
-            if (!closest_unit || distance < closest_distance)
-            {
-                closest_unit = unit;
-                closest_distance = distance;
-            }
-        }
-    }
-
-    return closest_unit;
+        return unit->unit_type == sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER
+            || unit->unit_type == sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND
+            || unit->unit_type == sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS
+            || unit->unit_type == sc2::UNIT_TYPEID::PROTOSS_NEXUS
+            || unit->unit_type == sc2::UNIT_TYPEID::ZERG_HATCHERY
+            || unit->unit_type == sc2::UNIT_TYPEID::ZERG_LAIR
+            || unit->unit_type == sc2::UNIT_TYPEID::ZERG_HIVE;
+    });
 }
 
 const ::UnitInfo * InformationManager::GetClosestUnitInfoWithJob(const sc2::Point2D reference_point, const UnitMission unit_mission) const
 {
-    const ::UnitInfo * closest_unit = nullptr;
-    double closest_distance = std::numeric_limits<double>::max();
-
-    for (auto & unit_info_pair : bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self))
-    {
-        const ::UnitInfo & unit_info = unit_info_pair.second;
-        if (unit_info.mission == unit_mission)
-        {
-            const double distance = Util::DistSq(reference_point, unit_info.unit->pos);
-            if (!closest_unit || distance < closest_distance)
-            {
-                closest_unit = &unit_info;
-                closest_distance = distance;
-            }
-        }
-    }
-
-    return closest_unit;
+    return GetClosestUnitInfoWithJob(reference_point, std::vector<UnitMission>{ unit_mission });
 }
 
 const sc2::Unit * InformationManager::GetClosestUnitWithJob(const sc2::Point2D reference_point, const UnitMission unit_mission) const
 {
-    const sc2::Unit * closest_unit = nullptr;
-    double closest_distance = std::numeric_limits<double>::max();
-
-    for (auto & unit_info_pair : bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self))
-    {
-        const ::UnitInfo & unit_info = unit_info_pair.second;
-        if (unit_info.mission == unit_mission)
-        {
-            const double distance = Util::DistSq(reference_point, unit_info.unit->pos);
-            if (distance < closest_distance)
-            {
-                closest_unit = unit_info.unit;
-                closest_distance = distance;
-            }
-        }
-    }
-
-    return closest_unit;
+    return GetClosestUnitWithJob(reference_point, std::vector<UnitMission>{ unit_mission });
 }
 
 const UnitInfo* InformationManager::GetClosestUnitInfoWithJob(const sc2::Point2D point,
                                                           const std::vector<UnitMission> mission_vector) const
 {
     const ::UnitInfo * closest_unit = nullptr;
-    double closest_distance = std::numeric_limits<double>::max();
+    float closest_distance = std::numeric_limits<float>::max();
 
-    for (auto & unit_info_pair : bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self))
+    // Only the units with one of the missions we want get looked at.
+    for (const UnitMission mission : mission_vector)
     {
-        if (std::find(mission_vector.begin(), mission_vector.end(), unit_info_pair.second.mission) != mission_vector.end())
+        const ::UnitInfo * unit_info = unit_info_.GetUnitsWithMission(mission).GetClosest(point);
+        if (unit_info && Util::DistSq(unit_info->unit->pos, point) < closest_distance)
         {
-            const double distance = Util::DistSq(unit_info_pair.second.unit->pos, point);
-            if (distance < closest_distance)
-            {
-                closest_unit = &unit_info_pair.second;
-                closest_distance = distance;
-            }
+            closest_unit = unit_info;
+            closest_distance = Util::DistSq(unit_info->unit->pos, point);
         }
     }
 
     return closest_unit;
 }
 
-
 const sc2::Unit* InformationManager::GetClosestUnitWithJob(const sc2::Point2D point,
     const std::vector<UnitMission> mission_vector) const
 {
-    const sc2::Unit * closest_unit = nullptr;
-    double closest_distance = std::numeric_limits<double>::max();
-
-    for (auto & unit_info_pair : bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self))
-    {
-        const ::UnitInfo & unit_info = unit_info_pair.second;
-        if (std::find(mission_vector.begin(), mission_vector.end(), unit_info.mission) != mission_vector.end())
-        {
-            const double distance = Util::DistSq(unit_info_pair.second.unit->pos, point);
-            if (distance < closest_distance)
-            {
-                closest_unit = unit_info.unit;
-                closest_distance = distance;
-            }
-        }
-    }
-
-    return closest_unit;
+    const ::UnitInfo * closest_unit = GetClosestUnitInfoWithJob(point, mission_vector);
+    return closest_unit ? closest_unit->unit : nullptr;
 }
 
 const sc2::Unit* InformationManager::GetClosestUnitOfType(const sc2::Unit* reference_unit,
     const sc2::UnitTypeID reference_type_id) const
 {
-    const sc2::Unit* closest_unit = nullptr;
-    double closest_distance = std::numeric_limits<double>::max();
-
-    for (auto unit : bot_.InformationManager().UnitInfo().GetUnits(PlayerArrayIndex::Self))
+    return unit_info_.GetUnitGrid(PlayerArrayIndex::Self).GetClosest(reference_unit->pos, [reference_type_id](const sc2::Unit* unit)
     {
-        if (unit->unit_type == reference_type_id)
-        {
-            const double distance = Util::DistSq(unit->pos, reference_unit->pos);
-            if (!closest_unit || distance < closest_distance)
-            {
-                closest_unit = unit;
-                closest_distance = distance;
-            }
-        }
-    }
-
-    return closest_unit;
+        return unit->unit_type == reference_type_id;
+    });
 }
 
 const sc2::Unit* InformationManager::GetClosestNotOptimalRefinery(const sc2::Unit* reference_unit) const
@@ -309,7 +235,54 @@ size_t UnitInfoManager::UnitsInProductionOfType(sc2::UnitTypeID unit_type) const
     return bot_.ProductionManager().NumberOfUnitsInProductionOfType(unit_type);
 }
 
-vvi InformationManager::GetDPSMap() const
+// Don't copy this! It's the full map. Use GetThreatAt if you only need one tile.
+const vvi & InformationManager::GetDPSMap() const
+{
+    return threat_map_.GetDPSMap();
+}
+
+int InformationManager::GetThreatAt(const sc2::Point2D & pos) const
+{
+    return threat_map_.ThreatAt(pos);
+}
+
+// Uses the air or ground layer depending on the unit, plus whatever we remember but can't see.
+float InformationManager::GetDPSAt(const sc2::Unit* unit) const
+{
+    return threat_map_.DPSAt(unit->pos, unit->is_flying);
+}
+
+bool InformationManager::IsSafe(const sc2::Unit* unit) const
+{
+    return GetDPSAt(unit) < safe_dps;
+}
+
+sc2::Point2D InformationManager::GetFleePosition(const sc2::Unit* unit, const sc2::Point2D & threat_position, const float distance) const
+{
+    // Look a bit further out than we're going to run, so we don't run into the next threat.
+    const sc2::Point2D gradient = threat_map_.GetThreatGradient(unit->pos, unit->is_flying, distance + flee_lookahead);
+    sc2::Point2D direction(-gradient.x, -gradient.y);
+
+    if (direction.x * direction.x + direction.y * direction.y < min_flee_gradient * min_flee_gradient)
+    {
+        direction = sc2::Point2D(unit->pos.x - threat_position.x, unit->pos.y - threat_position.y);
+    }
+
+    const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    if (length == 0.0f)
+    {
+        return unit->pos;
+    }
+
+    return sc2::Point2D(unit->pos.x + direction.x / length * distance, unit->pos.y + direction.y / length * distance);
+}
+
+uint32_t InformationManager::GetDPSMapVersion() const
+{
+    return threat_map_.GetVersion();
+}
+
+const ThreatMap & InformationManager::GetThreatMap() const
 {
-    return dps_map_;
+    return threat_map_;
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <sc2api/sc2_api.h>
 
+#include "information/ThreatMap.h"
 #include "information/UnitInfoManager.h"
 #include "macro/BuildingPlacer.h"
 
@@ -15,7 +16,7 @@ class InformationManager
     UnitInfoManager          unit_info_;
 
     sc2::Race                player_race_[2];
-    vvi                      dps_map_;
+    ThreatMap                threat_map_;
 
 public:
     InformationManager(ByunJRBot & bot);
@@ -39,5 +40,15 @@ public:
                                             const std::vector<UnitMission> mission_vector) const;
     const sc2::Unit* GetClosestUnitOfType(const sc2::Unit* unit, const sc2::UnitTypeID) const;
     const sc2::Unit* GetClosestNotOptimalRefinery(const sc2::Unit* reference_unit) const;
-    vvi GetDPSMap() const;
+    const vvi & GetDPSMap() const;
+    int GetThreatAt(const sc2::Point2D & pos) const;
+    float GetDPSAt(const sc2::Unit* unit) const;
+    // Whether so little can shoot the unit where it stands that it can go after workers.
+    bool IsSafe(const sc2::Unit* unit) const;
+
+    // Where the unit should run to get away from the threat, distance tiles away. Downhill on the threat map when there is a hill,
+    // straight away from threat_position when it's flat.
+    sc2::Point2D GetFleePosition(const sc2::Unit* unit, const sc2::Point2D & threat_position, float distance) const;
+    uint32_t GetDPSMapVersion() const;
+    const ThreatMap & GetThreatMap() const;
 };
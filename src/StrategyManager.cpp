@@ -193,15 +193,13 @@ bool StrategyManager::ShouldSendInitialScout() const
 
 bool StrategyManager::AreBasesSafe()
 {
-    for (const auto & enemy_unit : bot_.InformationManager().UnitInfo().GetUnits(PlayerArrayIndex::Enemy))
+    const UnitGrid & enemy_units = bot_.InformationManager().UnitInfo().GetUnitGrid(PlayerArrayIndex::Enemy);
+    for (const auto & potential_base : bot_.InformationManager().UnitInfo().GetUnits(PlayerArrayIndex::Self))
     {
-        for (const auto & potential_base : bot_.InformationManager().UnitInfo().GetUnits(PlayerArrayIndex::Self))
+        if( Util::IsTownHall(potential_base)
+         && enemy_units.IsAnyInRadius(potential_base->pos, 30))
         {
-            if( Util::IsTownHall(potential_base)
-             && Util::DistSq(potential_base->pos, enemy_unit->pos) < (30*30))
-            {
-                return false;
-            }
+            return false;
         }
     }
     return true;
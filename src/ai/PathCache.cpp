@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ai/PathCache.h"
+#include "information/ThreatMap.h"
+#include "util/Util.h"
+
+namespace
+{
+    // Lines are checked every this many tiles. Small enough not to skip over the corner of a wall.
+    const float line_step = 0.25f;
+
+    // Anything closer than this to where we were going is still the same target.
+    const float target_tolerance = 1.0f;
+
+    // Further than this from the line it should be walking along, the unit got pushed off its path.
+    const float deviation_distance = 3.0f;
+
+    // Close enough to the end to be done.
+    const float arrive_distance = 1.0f;
+
+    float DistanceToSegment(const sc2::Point2D & p, const sc2::Point2D & a, const sc2::Point2D & b)
+    {
+        const float abx = b.x - a.x;
+        const float aby = b.y - a.y;
+        const float length_sq = abx * abx + aby * aby;
+        float t = 0.0f;
+        if (length_sq > 0.0f)
+        {
+            t = std::min(std::max(((p.x - a.x) * abx + (p.y - a.y) * aby) / length_sq, 0.0f), 1.0f);
+        }
+        return Util::Dist(p, sc2::Point2D(a.x + abx * t, a.y + aby * t));
+    }
+}
+
+PathCache::PathCache()
+    : searches_(0)
+    , reused_(0)
+{
+}
+
+// Off the map is as bad as a wall.
+int PathCache::CostAt(const vvi & cost_map, const sc2::Point2D & pos)
+{
+    const int x = static_cast<int>(pos.x);
+    const int y = static_cast<int>(pos.y);
+    if (pos.x < 0.0f || pos.y < 0.0f || y >= static_cast<int>(cost_map.size()) || x >= static_cast<int>(cost_map[y].size()))
+    {
+        return ThreatMap::unwalkable_danger;
+    }
+    return cost_map[y][x];
+}
+
+bool PathCache::IsLineClear(const vvi & cost_map, const sc2::Point2D & from, const sc2::Point2D & to, const int max_cost)
+{
+    const int steps = static_cast<int>(std::ceil(Util::Dist(from, to) / line_step));
+    for (int k = 0; k <= steps; ++k)
+    {
+        const float t = steps == 0 ? 0.0f : static_cast<float>(k) / steps;
+        const int cost = CostAt(cost_map, sc2::Point2D(from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t));
+        if (cost >= ThreatMap::unwalkable_danger || cost > max_cost)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PathCache::AddLineTiles(const vvi & cost_map, const sc2::Point2D & from, const sc2::Point2D & to, UnitPath & path)
+{
+    const int steps = static_cast<int>(std::ceil(Util::Dist(from, to) / line_step));
+    for (int k = 0; k <= steps; ++k)
+    {
+        const float t = steps == 0 ? 0.0f : static_cast<float>(k) / steps;
+        const sc2::Point2D pos(from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t);
+        const sc2::Point2DI tile(static_cast<int>(pos.x), static_cast<int>(pos.y));
+        if (path.tiles.empty() || !(path.tiles.back() == tile))
+        {
+            path.tiles.push_back(tile);
+            path.tile_costs.push_back(CostAt(cost_map, pos));
+        }
+    }
+}
+
+void PathCache::Compress(const sc2::Point2D & start, const sc2::Point2D & target, const std::vector<sc2::Point2D> & tile_path,
+                         const vvi & cost_map, const uint32_t cost_version, UnitPath & path)
+{
+    path.target = target;
+    path.waypoints.clear();
+    path.waypoint_tiles.clear();
+    path.tiles.clear();
+    path.tile_costs.clear();
+    path.cost_version = cost_version;
+    path.next = 1;
+    path.sent = 0;
+
+    // The path is every tile after the start, ending on the target's tile. Walk through the middle of the tiles, and end on the target itself.
+    std::vector<sc2::Point2D> points;
+    points.push_back(start);
+    for (size_t i = 0; i + 1 < tile_path.size(); ++i)
+    {
+        points.push_back(sc2::Point2D(tile_path[i].x + 0.5f, tile_path[i].y + 0.5f));
+    }
+    points.push_back(target);
+
+    std::vector<int> costs(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        costs[i] = CostAt(cost_map, points[i]);
+    }
+
+    const auto visible = [&](const size_t from, const size_t to)
+    {
+        const int section_max = *std::max_element(costs.begin() + from, costs.begin() + to + 1);
+        return IsLineClear(cost_map, points[from], points[to], section_max);
+    };
+
+    // Checking every point along the way is quadratic in the length of the path. Instead gallop out until a line fails, then bisect back.
+    // Walls don't come and go along a path much, so this nearly always finds the same point the slow way would.
+    const size_t last = points.size() - 1;
+    path.waypoints.push_back(start);
+    size_t anchor = 0;
+    while (anchor < last)
+    {
+        // The next point on the path is always fine, it's right next to this one.
+        size_t good = anchor + 1;
+        size_t bad = last + 1;
+        for (size_t step = 2; good < last; step *= 2)
+        {
+            const size_t probe = std::min(anchor + step, last);
+            if (!visible(anchor, probe))
+            {
+                bad = probe;
+                break;
+            }
+            good = probe;
+        }
+        while (bad - good > 1)
+        {
+            const size_t probe = (good + bad) / 2;
+            if (visible(anchor, probe))
+            {
+                good = probe;
+            }
+            else
+            {
+                bad = probe;
+            }
+        }
+
+        path.waypoints.push_back(points[good]);
+        anchor = good;
+    }
+
+    for (size_t w = 0; w + 1 < path.waypoints.size(); ++w)
+    {
+        path.waypoint_tiles.push_back(path.tiles.size());
+        AddLineTiles(cost_map, path.waypoints[w], path.waypoints[w + 1], path);
+    }
+    path.waypoint_tiles.push_back(path.tiles.size());
+}
+
+bool PathCache::IsNearRoute(const UnitPath & path, const sc2::Point2D & pos)
+{
+    return DistanceToSegment(pos, path.waypoints[path.next - 1], path.waypoints[path.next]) <= deviation_distance;
+}
+
+bool PathCache::IsOnRoute(UnitPath & path, const sc2::Point2D & pos, const vvi & cost_map, const uint32_t cost_version)
+{
+    if (!IsNearRoute(path, pos))
+    {
+        return false;
+    }
+
+    // Something changed on the map. Only the part we still have to walk matters.
+    if (cost_version != path.cost_version)
+    {
+        for (size_t t = path.waypoint_tiles[path.next - 1]; t < path.tiles.size(); ++t)
+        {
+            const sc2::Point2DI & tile = path.tiles[t];
+            if (CostAt(cost_map, sc2::Point2D(static_cast<float>(tile.x), static_cast<float>(tile.y))) != path.tile_costs[t])
+            {
+                return false;
+            }
+        }
+        path.cost_version = cost_version;
+    }
+
+    return true;
+}
+
+void PathCache::GetRemainingCost(const UnitPath & path, const vvi & cost_map, int & cost_now, int & cost_then)
+{
+    cost_now = 0;
+    cost_then = 0;
+    for (size_t t = path.waypoint_tiles[path.next - 1]; t < path.tiles.size(); ++t)
+    {
+        const sc2::Point2DI & tile = path.tiles[t];
+        cost_now += CostAt(cost_map, sc2::Point2D(static_cast<float>(tile.x), static_cast<float>(tile.y)));
+        cost_then += path.tile_costs[t];
+    }
+}
+
+UnitPath* PathCache::GetValid(const sc2::Unit* unit, const sc2::Point2D & target, const vvi & cost_map, const uint32_t cost_version)
+{
+    const auto it = paths_.find(unit->tag);
+    if (it == paths_.end())
+    {
+        return nullptr;
+    }
+
+    UnitPath & path = it->second;
+    if (Util::Dist(target, path.target) > target_tolerance)
+    {
+        return nullptr;
+    }
+
+    // Catch up with the unit. The game drops move orders as they're done, so the first one left is the waypoint it's walking to.
+    if (path.sent > 0)
+    {
+        if (unit->orders.empty())
+        {
+            // Either it got there, or something stopped it.
+            if (Util::Dist(unit->pos, path.target) > arrive_distance)
+            {
+                return nullptr;
+            }
+            path.next = path.waypoints.size() - 1;
+        }
+        else
+        {
+            const sc2::UnitOrder & order = unit->orders.front();
+            size_t heading_to = path.next;
+            while (heading_to <= path.sent && !(order.ability_id == sc2::ABILITY_ID::MOVE && order.target_pos == path.waypoints[heading_to]))
+            {
+                ++heading_to;
+            }
+
+            // Someone else gave it something else to do.
+            if (heading_to > path.sent)
+            {
+                return nullptr;
+            }
+            path.next = heading_to;
+        }
+    }
+
+    if (!IsOnRoute(path, unit->pos, cost_map, cost_version))
+    {
+        return nullptr;
+    }
+
+    ++reused_;
+    return &path;
+}
+
+UnitPath & PathCache::Store(const sc2::Unit* unit, const sc2::Point2D & target, const std::vector<sc2::Point2D> & tile_path,
+                            const vvi & cost_map, const uint32_t cost_version)
+{
+    ++searches_;
+    UnitPath & path = paths_[unit->tag];
+    Compress(unit->pos, target, tile_path, cost_map, cost_version, path);
+    return path;
+}
+
+void PathCache::Remove(const sc2::Unit* unit)
+{
+    paths_.erase(unit->tag);
+}
+
+size_t PathCache::GetNumSearches() const
+{
+    return searches_;
+}
+
+size_t PathCache::GetNumReused() const
+{
+    return reused_;
+}
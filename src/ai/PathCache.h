@@ -0,0 +1,66 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+#include "common/Common.h"
+
+// A path cut down to the few points where it actually turns, and how far along it the unit is.
+struct UnitPath
+{
+    sc2::Point2D                target;
+    std::vector<sc2::Point2D>   waypoints;          // waypoints[0] is where the unit was when the path was found
+    std::vector<size_t>         waypoint_tiles;     // index into tiles where the segment starting at each waypoint starts
+    std::vector<sc2::Point2DI>  tiles;              // every tile the straight lines between the waypoints go over
+    std::vector<int>            tile_costs;         // what those tiles cost when the path was found
+    uint32_t                    cost_version;
+    size_t                      next;               // the waypoint the unit is walking to
+    size_t                      sent;               // the last waypoint the unit has been ordered to, 0 when it hasn't been ordered anywhere yet
+};
+
+// Remembers the path every unit is following, so SmartPathfind doesn't search and order the unit around on every frame.
+// A path is only thrown away when the target moves, the unit gets pushed off it, or the cost map changes somewhere along what's left of it.
+class PathCache
+{
+    std::unordered_map<sc2::Tag, UnitPath>  paths_;
+    size_t                                  searches_;
+    size_t                                  reused_;
+
+    static int  CostAt(const vvi & cost_map, const sc2::Point2D & pos);
+    static bool IsLineClear(const vvi & cost_map, const sc2::Point2D & from, const sc2::Point2D & to, int max_cost);
+    static void AddLineTiles(const vvi & cost_map, const sc2::Point2D & from, const sc2::Point2D & to, UnitPath & path);
+
+public:
+
+    PathCache();
+
+    // Turns the tile by tile path from Pathfinding into a few waypoints, with string pulling:
+    // from every waypoint, go straight to the furthest tile on the path we can see from it.
+    // "See" means no tile in between is unwalkable or costs more than the worst tile of the bit of path the line skips.
+    // So a path that goes around danger still goes around it, it just doesn't zig zag tile by tile any more.
+    static void Compress(const sc2::Point2D & start, const sc2::Point2D & target, const std::vector<sc2::Point2D> & tile_path,
+                         const vvi & cost_map, uint32_t cost_version, UnitPath & path);
+
+    // Whether someone at pos is close to the segment it should be walking along.
+    static bool IsNearRoute(const UnitPath & path, const sc2::Point2D & pos);
+
+    // Whether someone at pos can keep following the path: it's near the route,
+    // and nothing changed on the tiles it still has to walk over since cost_version.
+    static bool IsOnRoute(UnitPath & path, const sc2::Point2D & pos, const vvi & cost_map, uint32_t cost_version);
+
+    // What the tiles still to walk over cost now, and what they cost when the path was found.
+    static void GetRemainingCost(const UnitPath & path, const vvi & cost_map, int & cost_now, int & cost_then);
+
+    // The unit's path to target, if it still stands. Moves next along as the unit gets to its waypoints. nullptr means search again.
+    UnitPath* GetValid(const sc2::Unit* unit, const sc2::Point2D & target, const vvi & cost_map, uint32_t cost_version);
+
+    // Compresses the path and remembers it for the unit, replacing whatever it had.
+    UnitPath & Store(const sc2::Unit* unit, const sc2::Point2D & target, const std::vector<sc2::Point2D> & tile_path,
+                     const vvi & cost_map, uint32_t cost_version);
+
+    void Remove(const sc2::Unit* unit);
+
+    // How many paths had to be searched for and how many times one was reused instead, since the start of the game.
+    size_t GetNumSearches() const;
+    size_t GetNumReused() const;
+};
@@ -1,188 +1,142 @@
-#include <map>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
 
 #include "ai/Pathfinding.h"
-#include "util/Timer.hpp"
+#include "information/ThreatMap.h"
 
+Pathfinding::Pathfinding()
+    : width_(0)
+    , height_(0)
+{
+}
 
-inline std::pair<sc2::Point2DI, int> Pathfinding::BestPotentialPair(const std::pair<sc2::Point2DI, int> fallback_pair) const
+void Pathfinding::Init(const std::vector<std::vector<int>>& map_to_path)
 {
-    int smallest_distance = std::numeric_limits<int>::max();
-    std::pair<sc2::Point2DI, int> optimal_pair = fallback_pair;
-    for (const auto & distance_pair : distance_map_)
+    height_ = static_cast<int>(map_to_path.size());
+    width_ = height_ > 0 ? static_cast<int>(map_to_path[0].size()) : 0;
+
+    cost_so_far_.assign(width_ * height_, -1);
+    parent_.assign(width_ * height_, -1);
+    steps_.assign(width_ * height_, 0);
+}
+
+std::vector<sc2::Point2D> Pathfinding::PathTo(int index) const
+{
+    std::vector<sc2::Point2D> path;
+    // The start isn't part of the path.
+    while (parent_[index] != -1)
     {
-        const sc2::Point2DI point = distance_pair.first;
-        const int dist = distance_pair.second;
-        // If the distance to the node is 1, we have not yet found a path that leads to it.
-        if (dist < smallest_distance && dist != 1)
-        {
-            // Find the best pair that we have not yet visited. If we have already visited that point, don't visit it again. 
-            if (visited_.find(point) == visited_.end())
-            {
-                smallest_distance = dist;
-                optimal_pair = distance_pair;
-            }
-        }
+        path.push_back(sc2::Point2D(static_cast<float>(index % width_), static_cast<float>(index / width_)));
+        index = parent_[index];
     }
-    return optimal_pair;
+    std::reverse(path.begin(), path.end());
+    return path;
 }
 
-
-// Will only test and update if the path has not yet been visited, garunteeing that the path will never loop on itself. 
-inline void Pathfinding::TestPointAndUpdateInformation(const int x, const int y, const int current_path_weight,
-                                                       const std::vector<std::vector<int>>& map_to_path,
-                                                       const std::vector<sc2::Point2D>& current_shortest_path)
+// Returns the index of the tile the search stopped on, or -1 if it couldn't start.
+int Pathfinding::Search(const sc2::Point2DI start_point, const sc2::Point2DI* end_point, const int max_run_dist,
+                        const std::vector<std::vector<int>>& map_to_path)
 {
-    Timer t;
-    t.Start();
-    // The second value of the pair is the current weight of the node we are testing. 
-    const int new_weight = current_path_weight + map_to_path[y][x];
-    // If we have visited the node we are about to test, the path we are considering taking loops back on itself. 
-    // Test only the paths that do not loop back on themselves. 
-    const sc2::Point2DI point{ x,y };
-    if (visited_.find(point) == visited_.end())
+    Init(map_to_path);
+
+    const auto on_map = [this](const sc2::Point2DI & p) { return p.x >= 0 && p.y >= 0 && p.x < width_ && p.y < height_; };
+    if (!on_map(start_point) || (end_point && !on_map(*end_point)))
+    {
+        return -1;
+    }
+
+    // No tile is cheaper than this, so it's a safe guess for every tile still to go.
+    const auto estimate = [&](const int x, const int y)
     {
-        int & current_tentative_distance_at_point = distance_map_.at(sc2::Point2DI(x, y));
-        // If the distance to the node is 1, we have not yet found a path that leads to it. 
-        // Did we discover a more optimal path (or a path for the first time?)
-        // If we did, update the stored optimal path data.
-        if (new_weight < current_tentative_distance_at_point || current_tentative_distance_at_point == 1)
+        return end_point ? (std::abs(end_point->x - x) + std::abs(end_point->y - y)) * ThreatMap::base_danger : 0;
+    };
+
+    // Pairs of (cost so far plus estimate, tile). A tile can be in here more than once if a cheaper way to it turned up later;
+    // the stale copies are skipped when they come out.
+    typedef std::pair<int, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+    const int start = start_point.y * width_ + start_point.x;
+    const int end = end_point ? end_point->y * width_ + end_point->x : -1;
+    cost_so_far_[start] = 0;
+    open.push(Entry(estimate(start_point.x, start_point.y), start));
+
+    int last = start;
+    while (!open.empty())
+    {
+        const Entry entry = open.top();
+        open.pop();
+
+        const int current = entry.second;
+        const int x = current % width_;
+        const int y = current / width_;
+        if (entry.first != cost_so_far_[current] + estimate(x, y))
         {
-            current_tentative_distance_at_point = new_weight;
-            shortest_path_to_vector_[point] = current_shortest_path;
-            shortest_path_to_vector_[point].push_back(sc2::Point2D(point.x, point.y));
+            continue;
         }
-    }/*
-    double ms = t.GetElapsedTimeInMilliSec();
-    printf("TestPointAndUpdateInformation %lf ms\n", ms);*/
-}
 
-void Pathfinding::DjikstraInit(const std::vector<std::vector<int>>& map_to_path)
-{
-    const int width = map_to_path.size();
-    const int height = map_to_path[0].size();
+        last = current;
+        if (current == end || (!end_point && steps_[current] >= max_run_dist))
+        {
+            break;
+        }
 
-    // Setup the values in the distance map.
-    distance_map_.clear();
-    for (int y = 0; y < map_to_path.size(); ++y)
-    {
-        for (int x = 0; x < map_to_path[y].size(); ++x)
+        const int dx[] = { -1, 1, 0, 0 };
+        const int dy[] = { 0, 0, -1, 1 };
+        for (int i = 0; i < 4; ++i)
         {
-            distance_map_.insert(std::make_pair(sc2::Point2DI(x, y), 1));
+            const int nx = x + dx[i];
+            const int ny = y + dy[i];
+            if (nx < 0 || ny < 0 || nx >= width_ || ny >= height_)
+            {
+                continue;
+            }
 
-            shortest_path_to_vector_[sc2::Point2DI(x, y)] = std::vector<sc2::Point2D>();
+            const int next = ny * width_ + nx;
+            const int new_cost = cost_so_far_[current] + map_to_path[ny][nx];
+            if (cost_so_far_[next] == -1 || new_cost < cost_so_far_[next])
+            {
+                cost_so_far_[next] = new_cost;
+                parent_[next] = current;
+                steps_[next] = steps_[current] + 1;
+                open.push(Entry(new_cost + estimate(nx, ny), next));
+            }
         }
     }
+    return last;
 }
 
 std::vector<sc2::Point2D> Pathfinding::Djikstra(const sc2::Point2DI start_point,
     const sc2::Point2DI end_point,
     const std::vector<std::vector<int>>& map_to_path)
 {
-    DjikstraInit(map_to_path);
-
-    // If we have not yet found the shortest path between the two points, keep searching for a new path. 
-    while (true)
+    const int last = Search(start_point, &end_point, 0, map_to_path);
+    if (last == -1)
     {
-        std::pair<sc2::Point2DI, int> p = BestPotentialPair(std::pair<sc2::Point2DI, int> { start_point, 2 });
-        // Hard copy the current point into the visited set, and test nearby nodes if it has not yet been visited. 
-        // visited.set.insert( ... ).second is set to true if we have not yet visited the element. =
-        if (visited_.insert(p.first).second)
-        {
-            const int best_potential_x = p.first.x;
-            const int best_potential_y = p.first.y;
-            const int weight = p.second;
-            // We can't compare best_potential_x to something that is off the map. 
-            if (best_potential_x > 0)
-            {
-                TestPointAndUpdateInformation(best_potential_x - 1, best_potential_y, weight, map_to_path, shortest_path_to_vector_.at(p.first));
-                const sc2::Point2DI current_point(best_potential_x - 1, best_potential_y);
-                if (current_point == end_point)
-                    break;
-            }
-            if (best_potential_x < map_to_path[0].size() - 1)
-            {
-                TestPointAndUpdateInformation(best_potential_x + 1, best_potential_y, weight, map_to_path, shortest_path_to_vector_.at(p.first));
-                const sc2::Point2DI current_point(best_potential_x + 1, best_potential_y);
-                if (current_point == end_point)
-                    break;
-            }
-            if (best_potential_y > 0)
-            {
-                TestPointAndUpdateInformation(best_potential_x, best_potential_y - 1, weight, map_to_path, shortest_path_to_vector_.at(p.first));
-                const sc2::Point2DI current_point(best_potential_x, best_potential_y - 1);
-                if (current_point == end_point)
-                    break;
-            }
-            if (best_potential_y < map_to_path.size() - 1)
-            {
-                TestPointAndUpdateInformation(best_potential_x, best_potential_y + 1, weight, map_to_path, shortest_path_to_vector_.at(p.first));
-                const sc2::Point2DI current_point(best_potential_x, best_potential_y + 1);
-                if (current_point == end_point)
-                    break;
-            }
-        }
+        return std::vector<sc2::Point2D>();
     }
-    return shortest_path_to_vector_.at(end_point);
+    return PathTo(last);
 }
 
 std::vector<sc2::Point2D> Pathfinding::DjikstraLimit(const sc2::Point2DI start_point,
     const int max_run_dist,
     const std::vector<std::vector<int>>& map_to_path)
 {
-    // Setup the values in the distance map.
-    DjikstraInit(map_to_path);
-
-    sc2::Point2DI current_point;
-
-    // If we have not yet found the shortest path between the two points, keep searching for a new path. 
-    while (true)
+    // If the whole map is closer than max_run_dist, this is the path to the last tile searched.
+    const int last = Search(start_point, nullptr, max_run_dist, map_to_path);
+    if (last == -1)
     {
-        std::pair<sc2::Point2DI, int> p = BestPotentialPair(std::pair<sc2::Point2DI, int> { start_point, 2 });
-        // Hard copy the current point into the visited set, and test nearby nodes if it has not yet been visited. 
-        // visited.set.insert( ... ).second is set to true if we have not yet visited the element. =
-        if (visited_.insert(p.first).second)
-        {
-            const int best_potential_x = p.first.x;
-            const int best_potential_y = p.first.y;
-            const int weight = p.second;
-            // We can't compare best_potential_x to something that is off the map. 
-            if (best_potential_x > 0)
-            {
-                TestPointAndUpdateInformation(best_potential_x - 1, best_potential_y, weight, map_to_path, shortest_path_to_vector_.at(p.first));
-                current_point = sc2::Point2DI(best_potential_x - 1, best_potential_y);
-                if (shortest_path_to_vector_.at(current_point).size() >= max_run_dist)
-                    break;
-            }
-            if (best_potential_x < map_to_path[0].size() - 1)
-            {
-                TestPointAndUpdateInformation(best_potential_x + 1, best_potential_y, weight, map_to_path, shortest_path_to_vector_.at(p.first));
-                current_point = sc2::Point2DI(best_potential_x + 1, best_potential_y);
-                if (shortest_path_to_vector_.at(current_point).size() >= max_run_dist)
-                    break;
-            }
-            if (best_potential_y > 0)
-            {
-                TestPointAndUpdateInformation(best_potential_x, best_potential_y - 1, weight, map_to_path, shortest_path_to_vector_.at(p.first));
-                current_point = sc2::Point2DI(best_potential_x, best_potential_y - 1);
-                if (shortest_path_to_vector_.at(current_point).size() >= max_run_dist)
-                    break;
-            }
-            if (best_potential_y < map_to_path.size() - 1)
-            {
-                TestPointAndUpdateInformation(best_potential_x, best_potential_y + 1, weight, map_to_path, shortest_path_to_vector_.at(p.first));
-                current_point = sc2::Point2DI(best_potential_x, best_potential_y + 1);
-                if (shortest_path_to_vector_.at(current_point).size() >= max_run_dist)
-                    break;
-            }
-        }
+        return std::vector<sc2::Point2D>();
     }
-    return shortest_path_to_vector_.at(current_point);
+    return PathTo(last);
 }
 
 bool Pathfinding::TestDjikstra()
 {
-    const sc2::Point2DI start_point = { 2, 5 };
-    const sc2::Point2DI end_point = { 7, 6 };
+    const sc2::Point2DI start_point = { 1, 0 };
+    const sc2::Point2DI end_point = { 4, 4 };
     const std::vector<std::vector<int>> map_to_path =
     {
         { 5, 1, 5, 5, 5 },
@@ -192,22 +146,8 @@ bool Pathfinding::TestDjikstra()
         { 5, 5, 5, 1, 1 }
     };
 
-    //const std::vector<std::vector<int>> map_to_path =
-    //{
-    //    { 1,1,1,1,1,1,1,1,1,1, },
-    //    { 1,1,1,1,1,1,1,1,1,1, },
-    //    { 1,1,1,1,1,1,1,1,1,1, },
-    //    { 1,1,1,1,1,1,1,1,1,1, },
-    //    { 1,1,1,1,1,1,1,1,1,1, },
-    //    { 1,1,1,1,1,1,1,1,1,1, },
-    //    { 1,1,1,1,1,1,1,1,1,1, },
-    //    { 1,1,1,1,1,1,1,1,1,1, },
-    //    { 1,1,1,1,1,1,1,1,1,1, },
-    //    { 1,1,1,1,1,1,1,1,1,1  }
-    //};
     const std::vector<sc2::Point2D> expected_result =
     {
-        sc2::Point2D{ 1,0 },
         sc2::Point2D{ 1,1 },
         sc2::Point2D{ 1,2 },
         sc2::Point2D{ 2,2 },
@@ -217,10 +157,5 @@ bool Pathfinding::TestDjikstra()
         sc2::Point2D{ 4,4 }
     };
 
-    std::vector<sc2::Point2D> result = Djikstra(start_point, end_point, map_to_path);
-    if (result[0] == expected_result[0])
-    {
-        return true;
-    }
-    return false;
+    return Djikstra(start_point, end_point, map_to_path) == expected_result;
 }
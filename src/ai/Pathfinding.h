@@ -1,40 +1,34 @@
 #pragma once
 #include <vector>
-#include <map>
 
 #include <sc2api/sc2_api.h>
-#include <unordered_set>
-
-namespace std
-{
-    template <> struct hash<sc2::Point2DI>
-    {
-        size_t operator()(const sc2::Point2DI& k) const
-        {
-            // return (53 + hash<int>(k.x)) * 53 + hash<int>(k.y);
-            return k.x * 10000 + k.y;
-        }
-    };
-}
 
+// Searches the cost map (indexed [y][x]) tile by tile, moving up, down, left and right. Entering a tile costs what the map says it does.
+// Returned paths are every tile after the start, in order, ending on the last tile.
 class Pathfinding {
-    std::pair<sc2::Point2DI, int> BestPotentialPair(std::pair<sc2::Point2DI, int> fallback_pair) const;
-    void TestPointAndUpdateInformation(const int x, const int y, const int current_path_weight,
-                                       const std::vector<std::vector<int>>& map_to_path,
-                                       const std::vector<sc2::Point2D>& current_shortest_path);
+    int                 width_;
+    int                 height_;
 
-    // We can't use a set because Point2DI does not have a comparison function, and sets must be "ordered" somehow.
-    std::unordered_set<sc2::Point2DI> visited_;
+    // Everything about a tile is kept in flat arrays indexed by y * width + x, instead of maps keyed by the point.
+    std::vector<int>    cost_so_far_;   // cheapest way found to the tile so far, -1 if it hasn't been reached yet
+    std::vector<int>    parent_;        // the tile we got here from, -1 for the start
+    std::vector<int>    steps_;         // how many tiles from the start
 
-    // The distance of the optimal route to that path.
-    std::unordered_map<sc2::Point2DI, int> distance_map_;
-    std::unordered_map<sc2::Point2DI, std::vector<sc2::Point2D>> shortest_path_to_vector_;
+    void Init(const std::vector<std::vector<int>>& map_to_path);
+    std::vector<sc2::Point2D> PathTo(int index) const;
 
-    void DjikstraInit(const std::vector<std::vector<int>>& map_to_path);
+    // Dijkstra with a binary heap. When there is an end point, the heap is sorted by the cost so far plus the fewest tiles left,
+    // times the cheapest a tile can cost, which makes it A*: it never overestimates, so the path is still the cheapest one.
+    int Search(sc2::Point2DI start_point, const sc2::Point2DI* end_point, int max_run_dist,
+               const std::vector<std::vector<int>>& map_to_path);
 public:
-    // Returns the optimal path. 
+    Pathfinding();
+
+    // Returns the optimal path. Empty if either point is off the map.
     std::vector<sc2::Point2D> Djikstra(const sc2::Point2DI start_point, const sc2::Point2DI end_point,
                                        const std::vector<std::vector<int>>& map_to_path);
+
+    // Returns the cheapest path that gets max_run_dist tiles away from the start.
     std::vector<sc2::Point2D> DjikstraLimit(const sc2::Point2DI start_point, const int max_run_dist,
                                             const std::vector<std::vector<int>>& map_to_path);
     bool TestDjikstra();
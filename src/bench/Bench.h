@@ -0,0 +1,11 @@
+#pragma once
+
+// Stand-alone benchmarks, built into ByunJRBench instead of the bot.
+// Each one times the fast code against the slow code it replaced, prints both,
+// and returns false if the two didn't come up with the same answer.
+namespace Bench
+{
+    bool RunThreatMap();
+    bool RunDistanceKernels();
+    bool RunCombatSimulator();
+}
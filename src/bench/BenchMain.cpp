@@ -0,0 +1,18 @@
+#include <iostream>
+
+#include "bench/Bench.h"
+
+int main()
+{
+    bool passed = true;
+    passed = Bench::RunThreatMap() && passed;
+    passed = Bench::RunDistanceKernels() && passed;
+    passed = Bench::RunCombatSimulator() && passed;
+
+    if (!passed)
+    {
+        std::cerr << "At least one benchmark got a different answer from the code it replaces" << std::endl;
+        return 1;
+    }
+    return 0;
+}
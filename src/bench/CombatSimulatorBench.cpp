@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "information/UnitTypeTable.h"
+#include "micro/CombatSimulator.h"
+#include "util/Timer.hpp"
+
+namespace
+{
+    const int units_per_side = 20;
+    const int fights = 20000;
+    const float max_seconds = 30.0f;
+
+    bool SameResult(const CombatResult & a, const CombatResult & b)
+    {
+        return a.our_value_left == b.our_value_left && a.their_value_left == b.their_value_left && a.seconds == b.seconds;
+    }
+}
+
+// Lots of random 20 vs 20 fights. The simulator has to give the same answer when the last fight is run again.
+bool Bench::RunCombatSimulator()
+{
+    // A few made up unit types, roughly marines, marauders, zerglings, roaches and mutalisks.
+    std::vector<UnitTypeTraits> types(5);
+    types[0].ground_dps = 9.8f;  types[0].air_dps = 9.8f;  types[0].ground_range = 5.0f; types[0].air_range = 5.0f; types[0].hit_damage = 6.0f;  types[0].movement_speed = 2.25f; types[0].armor = 0.0f;
+    types[1].ground_dps = 9.3f;  types[1].ground_range = 6.0f; types[1].hit_damage = 10.0f; types[1].movement_speed = 2.25f; types[1].armor = 1.0f;
+    types[2].ground_dps = 10.0f; types[2].ground_range = 0.1f; types[2].hit_damage = 5.0f;  types[2].movement_speed = 4.13f; types[2].armor = 0.0f;
+    types[3].ground_dps = 11.2f; types[3].ground_range = 4.0f; types[3].hit_damage = 16.0f; types[3].movement_speed = 3.15f; types[3].armor = 1.0f;
+    types[4].ground_dps = 8.6f;  types[4].air_dps = 8.6f;  types[4].ground_range = 3.0f; types[4].air_range = 3.0f; types[4].hit_damage = 9.0f; types[4].movement_speed = 5.6f; types[4].armor = 0.0f;
+    const float hp[5] = { 45.0f, 125.0f, 35.0f, 145.0f, 120.0f };
+
+    std::srand(1);
+    CombatSimulator simulator;
+    CombatResult result = { 0.0f, 0.0f, 0.0f };
+    int wins = 0;
+    double total_seconds = 0.0;
+
+    Timer t;
+    t.Start();
+    for (int fight = 0; fight < fights; ++fight)
+    {
+        simulator.Clear();
+        for (int i = 0; i < units_per_side; ++i)
+        {
+            const int our_type = std::rand() % 2;
+            const int their_type = 2 + std::rand() % 3;
+            simulator.AddOurUnit(sc2::Point2D(static_cast<float>(std::rand() % 8), static_cast<float>(std::rand() % 8)), types[our_type], hp[our_type], 0.0f, false);
+            simulator.AddEnemyUnit(sc2::Point2D(static_cast<float>(12 + std::rand() % 8), static_cast<float>(std::rand() % 8)), types[their_type], hp[their_type], 0.0f, their_type == 4);
+        }
+
+        result = simulator.Simulate(max_seconds);
+        wins += result.WeWin() ? 1 : 0;
+        total_seconds += result.seconds;
+    }
+    const double ms = t.GetElapsedTimeInMilliSec();
+
+    const bool repeatable = SameResult(result, simulator.Simulate(max_seconds));
+
+    std::cout << "CombatSimulator benchmark, " << fights << " fights of " << units_per_side << " vs " << units_per_side << ":" << std::endl;
+    std::cout << "    " << ms * 1000.0 / fights << " us/fight, " << fights / (ms / 1000.0) << " fights/second" << std::endl;
+    std::cout << "    we won " << wins << ", average fight took " << total_seconds / fights << " game seconds" << std::endl;
+    std::cout << "    same result when run again: " << (repeatable ? "yes" : "no") << std::endl;
+    return repeatable;
+}
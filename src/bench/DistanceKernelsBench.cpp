@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "util/DistanceKernels.h"
+#include "util/Timer.hpp"
+
+namespace
+{
+    const int num_units = 200;
+    const int num_buildings = 60;
+    const int repeats = 2000;
+    const float map_size = 200.0f;
+    const float find_radius = 15.0f;
+    const float range_margin = 0.5f;
+    const float separation_radius = 20.0f;
+
+    // The sums add up in a different order than the plain loops, so they only have to be close.
+    const float sum_tolerance = 1e-3f;
+
+    // The plain loops the kernels replaced.
+    float DistSqScalar(const float ax, const float ay, const float bx, const float by)
+    {
+        const float dx = ax - bx;
+        const float dy = ay - by;
+        return dx * dx + dy * dy;
+    }
+
+    size_t FindInRadiusScalar(const sc2::Point2D & p, const float radius, const std::vector<float> & x, const std::vector<float> & y, uint32_t* indices)
+    {
+        size_t found = 0;
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            if (DistSqScalar(x[i], y[i], p.x, p.y) < radius * radius)
+            {
+                indices[found++] = static_cast<uint32_t>(i);
+            }
+        }
+        return found;
+    }
+
+    float SumInRangeScalar(const sc2::Point2D & p, const std::vector<float> & x, const std::vector<float> & y, const std::vector<float> & range, const std::vector<float> & value, const float margin)
+    {
+        float total = 0.0f;
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            const float reach = range[i] + margin;
+            if (DistSqScalar(x[i], y[i], p.x, p.y) < reach * reach)
+            {
+                total += value[i];
+            }
+        }
+        return total;
+    }
+
+    void SeparationScalar(const std::vector<float> & x, const std::vector<float> & y, const float radius, std::vector<float> & out_x, std::vector<float> & out_y)
+    {
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            for (size_t j = 0; j < x.size(); ++j)
+            {
+                const float dx = x[i] - x[j];
+                const float dy = y[i] - y[j];
+                const float d_sq = dx * dx + dy * dy;
+                if (d_sq > 0.0f && d_sq < radius * radius)
+                {
+                    const float d = std::sqrt(d_sq);
+                    const float push = (radius - d) / (radius * d);
+                    out_x[i] += dx * push;
+                    out_y[i] += dy * push;
+                }
+            }
+        }
+    }
+}
+
+// 200 units queried from 60 building positions, the sizes UnitArrays and PotentialField see in a big fight.
+bool Bench::RunDistanceKernels()
+{
+    std::srand(1);
+    std::vector<float> x, y, range, value;
+    for (int i = 0; i < num_units; ++i)
+    {
+        x.push_back(map_size * std::rand() / RAND_MAX);
+        y.push_back(map_size * std::rand() / RAND_MAX);
+        range.push_back(static_cast<float>(1 + std::rand() % 10));
+        value.push_back(static_cast<float>(5 + std::rand() % 20));
+    }
+
+    std::vector<sc2::Point2D> buildings;
+    for (int i = 0; i < num_buildings; ++i)
+    {
+        buildings.push_back(sc2::Point2D(map_size * std::rand() / RAND_MAX, map_size * std::rand() / RAND_MAX));
+    }
+
+    std::vector<uint32_t> scalar_indices(num_units);
+    std::vector<uint32_t> kernel_indices(num_units);
+    int mismatches = 0;
+    // Stops the compiler from throwing the loops away.
+    double sink = 0.0;
+    Timer t;
+
+    // Everything in a radius, like UnitArrays::FindInRadius.
+    t.Start();
+    for (int r = 0; r < repeats; ++r)
+    {
+        sink += FindInRadiusScalar(buildings[r % num_buildings], find_radius, x, y, scalar_indices.data());
+    }
+    const double find_scalar_ms = t.GetElapsedTimeInMilliSec();
+    t.Start();
+    for (int r = 0; r < repeats; ++r)
+    {
+        sink += DistanceKernels::FindInRadius(buildings[r % num_buildings], find_radius, x.data(), y.data(), num_units, kernel_indices.data());
+    }
+    const double find_kernel_ms = t.GetElapsedTimeInMilliSec();
+    for (const sc2::Point2D & building : buildings)
+    {
+        const size_t scalar_found = FindInRadiusScalar(building, find_radius, x, y, scalar_indices.data());
+        const size_t kernel_found = DistanceKernels::FindInRadius(building, find_radius, x.data(), y.data(), num_units, kernel_indices.data());
+        if (scalar_found != kernel_found || !std::equal(scalar_indices.begin(), scalar_indices.begin() + scalar_found, kernel_indices.begin()))
+        {
+            ++mismatches;
+        }
+    }
+
+    // Damage that can reach a point, like UnitArrays::DamageInRange.
+    t.Start();
+    for (int r = 0; r < repeats; ++r)
+    {
+        sink += SumInRangeScalar(buildings[r % num_buildings], x, y, range, value, range_margin);
+    }
+    const double sum_scalar_ms = t.GetElapsedTimeInMilliSec();
+    t.Start();
+    for (int r = 0; r < repeats; ++r)
+    {
+        sink += DistanceKernels::SumInRange(buildings[r % num_buildings], x.data(), y.data(), range.data(), value.data(), num_units, range_margin);
+    }
+    const double sum_kernel_ms = t.GetElapsedTimeInMilliSec();
+    for (const sc2::Point2D & building : buildings)
+    {
+        const float scalar_sum = SumInRangeScalar(building, x, y, range, value, range_margin);
+        const float kernel_sum = DistanceKernels::SumInRange(building, x.data(), y.data(), range.data(), value.data(), num_units, range_margin);
+        if (std::fabs(scalar_sum - kernel_sum) > sum_tolerance)
+        {
+            ++mismatches;
+        }
+    }
+
+    // Every unit pushed away from every other one, like PotentialField.
+    std::vector<float> scalar_x(num_units), scalar_y(num_units);
+    std::vector<float> kernel_x(num_units), kernel_y(num_units);
+    t.Start();
+    for (int r = 0; r < repeats / 10; ++r)
+    {
+        std::fill(scalar_x.begin(), scalar_x.end(), 0.0f);
+        std::fill(scalar_y.begin(), scalar_y.end(), 0.0f);
+        SeparationScalar(x, y, separation_radius, scalar_x, scalar_y);
+        sink += scalar_x[r % num_units];
+    }
+    const double separation_scalar_ms = t.GetElapsedTimeInMilliSec();
+    t.Start();
+    for (int r = 0; r < repeats / 10; ++r)
+    {
+        std::fill(kernel_x.begin(), kernel_x.end(), 0.0f);
+        std::fill(kernel_y.begin(), kernel_y.end(), 0.0f);
+        DistanceKernels::Separation(x.data(), y.data(), num_units, x.data(), y.data(), num_units, separation_radius, kernel_x.data(), kernel_y.data());
+        sink += kernel_x[r % num_units];
+    }
+    const double separation_kernel_ms = t.GetElapsedTimeInMilliSec();
+    for (int i = 0; i < num_units; ++i)
+    {
+        if (std::fabs(scalar_x[i] - kernel_x[i]) > sum_tolerance || std::fabs(scalar_y[i] - kernel_y[i]) > sum_tolerance)
+        {
+            ++mismatches;
+        }
+    }
+
+    std::cout << "DistanceKernels benchmark (" << DistanceKernels::InstructionSet() << "), " << num_units << " units, " << repeats << " queries:" << std::endl;
+    std::cout << "    in radius:        " << find_scalar_ms << " ms scalar, " << find_kernel_ms << " ms kernel" << std::endl;
+    std::cout << "    damage in range:  " << sum_scalar_ms << " ms scalar, " << sum_kernel_ms << " ms kernel" << std::endl;
+    std::cout << "    " << num_units << "x" << num_units << " separation: " << separation_scalar_ms << " ms scalar, " << separation_kernel_ms << " ms kernel (" << repeats / 10 << " times)" << std::endl;
+    std::cout << "    mismatches: " << mismatches << " (" << sink << ")" << std::endl;
+    return mismatches == 0;
+}
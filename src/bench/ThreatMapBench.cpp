@@ -0,0 +1,121 @@
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "information/ThreatMap.h"
+#include "util/Timer.hpp"
+
+namespace
+{
+    const int width = 200;
+    const int height = 200;
+    const int num_enemies = 100;
+    const int frames = 100;
+
+    struct FakeEnemy
+    {
+        sc2::Point2D pos;
+        int radius;
+        int damage;
+    };
+
+    // The old way: clear the map, then test every tile against every enemy.
+    void FullRebuild(const std::vector<FakeEnemy> & enemies, vvi & map)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                map[y][x] = ThreatMap::base_danger;
+            }
+        }
+
+        for (const FakeEnemy & enemy : enemies)
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    const float dx = x - enemy.pos.x;
+                    const float dy = y - enemy.pos.y;
+                    if (dx * dx + dy * dy <= enemy.radius * enemy.radius)
+                    {
+                        map[y][x] += enemy.damage;
+                    }
+                }
+            }
+        }
+    }
+
+    // A tenth of the enemies move one tile every frame.
+    void MoveEnemies(std::vector<FakeEnemy> & enemies, const int frame)
+    {
+        for (int i = 0; i < num_enemies; i += 10)
+        {
+            FakeEnemy & enemy = enemies[(i + frame) % num_enemies];
+            enemy.pos.x = static_cast<float>((static_cast<int>(enemy.pos.x) + 1) % width);
+        }
+    }
+}
+
+// 100 enemies on a 200x200 map. The stamped int map has to match a full rebuild on the last frame.
+bool Bench::RunThreatMap()
+{
+    std::srand(1);
+    std::vector<FakeEnemy> start_enemies;
+    for (int i = 0; i < num_enemies; ++i)
+    {
+        const FakeEnemy enemy = { sc2::Point2D(static_cast<float>(std::rand() % width), static_cast<float>(std::rand() % height)), 2 + std::rand() % 9, 5 + std::rand() % 20 };
+        start_enemies.push_back(enemy);
+    }
+
+    std::vector<FakeEnemy> enemies = start_enemies;
+    vvi old_map(height, std::vector<int>(width, ThreatMap::base_danger));
+    Timer t;
+    t.Start();
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        MoveEnemies(enemies, frame);
+        FullRebuild(enemies, old_map);
+    }
+    const double old_ms = t.GetElapsedTimeInMilliSec();
+
+    // Stamping all four layers.
+    enemies = start_enemies;
+    ThreatMap threat_map;
+    threat_map.Reset(width, height);
+    t.Start();
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        MoveEnemies(enemies, frame);
+        threat_map.BeginFrame(static_cast<uint32_t>(frame * 2));
+        for (int i = 0; i < num_enemies; ++i)
+        {
+            const float dps = static_cast<float>(enemies[i].damage);
+            const UnitThreat threat = { enemies[i].radius, enemies[i].damage, enemies[i].radius, dps, enemies[i].radius, i % 2 == 0 ? dps : 0.0f };
+            threat_map.StampUnit(static_cast<sc2::Tag>(i + 1), enemies[i].pos, threat);
+        }
+        threat_map.EndFrame();
+    }
+    const double new_ms = t.GetElapsedTimeInMilliSec();
+
+    int mismatches = 0;
+    const vvi & new_map = threat_map.GetDPSMap();
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (new_map[y][x] != old_map[y][x])
+            {
+                ++mismatches;
+            }
+        }
+    }
+
+    std::cout << "ThreatMap benchmark, " << num_enemies << " enemies on a " << width << "x" << height << " map, " << frames << " frames:" << std::endl;
+    std::cout << "    full rebuild: " << old_ms / frames << " ms/frame" << std::endl;
+    std::cout << "    stamping:     " << new_ms / frames << " ms/frame" << std::endl;
+    std::cout << "    mismatched tiles: " << mismatches << std::endl;
+    return mismatches == 0;
+}
@@ -16,12 +16,12 @@ DebugManager::DebugManager(ByunJRBot & bot)
 
 void DebugManager::DrawResourceDebugInfo() const
 {
-    const std::map<sc2::Tag, UnitInfo> ui = bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self);
+    const UnitSlotMap & ui = bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self);
 
     for (auto const & unit_info : ui)
     {
-        if (Util::IsBuilding(unit_info.second.unit->unit_type)) continue;
-        bot_.DebugHelper().DrawText(unit_info.second.unit->pos, unit_info.second.GetJobCode());
+        if (Util::IsBuilding(unit_info.unit->unit_type)) continue;
+        bot_.DebugHelper().DrawText(unit_info.unit->pos, unit_info.GetJobCode());
 
         //auto depot = bot_.GetUnit(workerData.getWorkerDepot(workerTag));
         //if (depot)
@@ -32,7 +32,7 @@ void DebugManager::DrawResourceDebugInfo() const
 }
 
 
-void DebugManager::DrawEnemyDPSMap(std::vector<std::vector<int>> dps_map) const
+void DebugManager::DrawEnemyDPSMap(const std::vector<std::vector<int>> & dps_map) const
 {
     for(int y = 0; y < dps_map.size(); ++y)
     {
@@ -100,7 +100,7 @@ void DebugManager::DrawMapWalkableTiles() const
 void DebugManager::DrawAllUnitInformation() const
 {
     std::stringstream ss;
-    const std::map<sc2::Tag, UnitInfo> ui = bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self);
+    const UnitSlotMap & ui = bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self);
 
     ss << "Workers: " << ui.size() << std::endl;
 
@@ -108,8 +108,8 @@ void DebugManager::DrawAllUnitInformation() const
 
     for (auto const & unit_info : ui )
     {
-        if (Util::IsBuilding(unit_info.second.unit->unit_type)) continue;
-        ss << unit_info.second.GetJobCode() << " " << unit_info.first << std::endl;
+        if (Util::IsBuilding(unit_info.unit->unit_type)) continue;
+        ss << unit_info.GetJobCode() << " " << unit_info.unit->tag << std::endl;
     }
 
     bot_.DebugHelper().DrawTextScreen(sc2::Point2D(0.75f, 0.2f), ss.str());
@@ -8,7 +8,7 @@ class DebugManager
 public:
     DebugManager(ByunJRBot & bot);
     void DrawResourceDebugInfo() const;
-    void DrawEnemyDPSMap(std::vector<std::vector<int>> dps_map) const;
+    void DrawEnemyDPSMap(const std::vector<std::vector<int>> & dps_map) const;
     void DrawMapSectors() const;
     void DrawMapWalkableTiles() const;
     void DrawAllUnitInformation() const;
@@ -149,9 +149,8 @@ void BaseLocationManager::OnFrame()
     }
 
     // update enemy base occupations
-    for (const auto & kv : bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Enemy))
+    for (const UnitInfo & ui : bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Enemy))
     {
-        const UnitInfo & ui = kv.second;
 
         if (!Util::IsBuilding(ui.type))
         {
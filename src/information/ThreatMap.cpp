@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <cmath>
+
+#include "information/ThreatMap.h"
+
+namespace
+{
+    // Rings sampled for the gradient are this many tiles apart.
+    const float gradient_ring_spacing = 2.0f;
+
+    // About a stalker. Enough to keep ground units off walls, not enough to run into real enemies instead.
+    const float unwalkable_gradient_dps = 10.0f;
+
+    bool SameThreat(const UnitThreat & a, const UnitThreat & b)
+    {
+        return a.radius == b.radius && a.damage == b.damage
+            && a.ground_radius == b.ground_radius && a.ground_dps == b.ground_dps
+            && a.air_radius == b.air_radius && a.air_dps == b.air_dps;
+    }
+}
+
+ThreatMap::ThreatMap()
+    : width_(0)
+    , height_(0)
+    , frame_(0)
+    , game_loop_(0)
+    , memory_epoch_(0)
+    , version_(0)
+{
+
+}
+
+void ThreatMap::Reset(const int width, const int height)
+{
+    width_ = width;
+    height_ = height;
+    dps_map_ = vvi(height_, std::vector<int>(width_, base_danger));
+    ground_dps_ = vvf(height_, std::vector<float>(width_, 0.0f));
+    air_dps_ = vvf(height_, std::vector<float>(width_, 0.0f));
+    ground_memory_ = vvf(height_, std::vector<float>(width_, 0.0f));
+    air_memory_ = vvf(height_, std::vector<float>(width_, 0.0f));
+    unwalkable_ = vvb(height_, std::vector<bool>(width_, false));
+    stamps_.clear();
+    memory_stamps_.clear();
+    memory_epoch_ = game_loop_;
+    ++version_;
+}
+
+void ThreatMap::SetUnwalkable(const int x, const int y)
+{
+    unwalkable_[y][x] = true;
+    dps_map_[y][x] = unwalkable_danger;
+    ++version_;
+}
+
+const std::vector<int> & ThreatMap::GetCircleMask(const int radius)
+{
+    auto it = circle_masks_.find(radius);
+    if (it != circle_masks_.end())
+    {
+        return it->second;
+    }
+
+    std::vector<int> & mask = circle_masks_[radius];
+    for (int dy = -radius; dy <= radius; ++dy)
+    {
+        mask.push_back(static_cast<int>(std::sqrt(static_cast<float>(radius * radius - dy * dy))));
+    }
+    return mask;
+}
+
+// -1 if the circle doesn't reach this row at all.
+int ThreatMap::GetHalfWidth(const int radius, const int dy)
+{
+    if (radius < 0 || dy < -radius || dy > radius)
+    {
+        return -1;
+    }
+    return GetCircleMask(radius)[dy + radius];
+}
+
+// Only the tiles inside the stamp's bounding box are touched, and every layer is updated in the same sweep.
+// Unwalkable tiles always stay at unwalkable_danger on the int map. Air units fly over them, so the float layers still get stamped.
+// Remembered enemies go on the memory layers instead of the live ones, and never on the int map.
+void ThreatMap::ApplyStamp(const Stamp & stamp, const int sign)
+{
+    const UnitThreat & threat = stamp.threat;
+    const bool remembered = stamp.memory != 0.0f;
+    const float scale = remembered ? stamp.memory : 1.0f;
+    const int damage = sign * threat.damage;
+    const float ground_dps = sign * threat.ground_dps * scale;
+    const float air_dps = sign * threat.air_dps * scale;
+    vvf & ground_layer = remembered ? ground_memory_ : ground_dps_;
+    vvf & air_layer = remembered ? air_memory_ : air_dps_;
+
+    const int radius = damage != 0 ? threat.radius : -1;
+    const int ground_radius = ground_dps != 0.0f ? threat.ground_radius : -1;
+    const int air_radius = air_dps != 0.0f ? threat.air_radius : -1;
+    const int max_radius = std::max(radius, std::max(ground_radius, air_radius));
+    if (max_radius < 0)
+    {
+        return;
+    }
+    ++version_;
+
+    const int min_dy = std::max(-max_radius, -stamp.y);
+    const int max_dy = std::min(max_radius, height_ - 1 - stamp.y);
+    for (int dy = min_dy; dy <= max_dy; ++dy)
+    {
+        const int y = stamp.y + dy;
+        const int half_width = GetHalfWidth(radius, dy);
+        const int ground_half_width = GetHalfWidth(ground_radius, dy);
+        const int air_half_width = GetHalfWidth(air_radius, dy);
+        const int max_half_width = std::max(half_width, std::max(ground_half_width, air_half_width));
+        if (max_half_width < 0)
+        {
+            continue;
+        }
+
+        const int min_x = std::max(stamp.x - max_half_width, 0);
+        const int max_x = std::min(stamp.x + max_half_width, width_ - 1);
+
+        std::vector<int> & row = dps_map_[y];
+        std::vector<float> & ground_row = ground_layer[y];
+        std::vector<float> & air_row = air_layer[y];
+        const std::vector<bool> & unwalkable_row = unwalkable_[y];
+        for (int x = min_x; x <= max_x; ++x)
+        {
+            const int dx = std::abs(x - stamp.x);
+            if (dx <= half_width && !unwalkable_row[x])
+            {
+                row[x] += damage;
+            }
+            if (dx <= ground_half_width)
+            {
+                ground_row[x] += ground_dps;
+            }
+            if (dx <= air_half_width)
+            {
+                air_row[x] += air_dps;
+            }
+        }
+    }
+}
+
+// The memory layers are stored multiplied by exp((last seen - epoch) / decay), so it never has to be touched to fade out.
+// Reading it multiplies by exp(-(now - epoch) / decay). Every so often the epoch is moved up so the numbers don't blow up.
+float ThreatMap::GetMemoryScale() const
+{
+    return std::exp(-static_cast<float>(game_loop_ - memory_epoch_) / memory_decay_game_loops);
+}
+
+void ThreatMap::RescaleMemory()
+{
+    const float scale = GetMemoryScale();
+    for (vvf* layer : { &ground_memory_, &air_memory_ })
+    {
+        for (std::vector<float> & row : *layer)
+        {
+            for (float & value : row)
+            {
+                value *= scale;
+            }
+        }
+    }
+
+    for (auto & it : memory_stamps_)
+    {
+        it.second.memory *= scale;
+    }
+
+    memory_epoch_ = game_loop_;
+}
+
+void ThreatMap::BeginFrame(const uint32_t game_loop)
+{
+    ++frame_;
+    game_loop_ = game_loop;
+
+    if (game_loop_ - memory_epoch_ > memory_game_loops)
+    {
+        RescaleMemory();
+    }
+}
+
+void ThreatMap::StampUnit(const sc2::Tag tag, const sc2::Point2D & pos, const UnitThreat & threat)
+{
+    const Stamp stamp = { static_cast<int>(pos.x + 0.5f), static_cast<int>(pos.y + 0.5f), threat, 0.0f, frame_, game_loop_ };
+
+    // We can see it again, so there's no need to remember it.
+    auto memory_it = memory_stamps_.find(tag);
+    if (memory_it != memory_stamps_.end())
+    {
+        ApplyStamp(memory_it->second, -1);
+        memory_stamps_.erase(memory_it);
+    }
+
+    auto it = stamps_.find(tag);
+    if (it != stamps_.end())
+    {
+        Stamp & old = it->second;
+        old.last_seen_frame = frame_;
+        old.last_seen_game_loop = game_loop_;
+
+        // Still on the same tile with the same weapon, nothing to do. This is the common case.
+        if (old.x == stamp.x && old.y == stamp.y && SameThreat(old.threat, stamp.threat))
+        {
+            return;
+        }
+
+        ApplyStamp(old, -1);
+        stamps_.erase(it);
+    }
+
+    if (stamp.x < 0 || stamp.y < 0 || stamp.x >= width_ || stamp.y >= height_)
+    {
+        return;
+    }
+
+    ApplyStamp(stamp, 1);
+    stamps_[tag] = stamp;
+}
+
+// Both weapons are remembered, each over its own range, so a unit that can only shoot up doesn't scare ground units.
+void ThreatMap::StampMemory(const sc2::Tag tag, const sc2::Point2D & pos, const UnitThreat & threat, const uint32_t last_seen_game_loop)
+{
+    const float memory = std::exp((static_cast<float>(last_seen_game_loop) - static_cast<float>(memory_epoch_)) / memory_decay_game_loops);
+    const UnitThreat memory_threat = { -1, 0, threat.ground_radius, threat.ground_dps, threat.air_radius, threat.air_dps };
+    const Stamp stamp = { static_cast<int>(pos.x + 0.5f), static_cast<int>(pos.y + 0.5f), memory_threat, memory, frame_, last_seen_game_loop };
+
+    auto it = memory_stamps_.find(tag);
+    if (it != memory_stamps_.end())
+    {
+        Stamp & old = it->second;
+        old.last_seen_frame = frame_;
+        if (old.x == stamp.x && old.y == stamp.y && old.last_seen_game_loop == last_seen_game_loop && SameThreat(old.threat, stamp.threat))
+        {
+            return;
+        }
+
+        ApplyStamp(old, -1);
+        memory_stamps_.erase(it);
+    }
+
+    if ((threat.ground_dps == 0.0f && threat.air_dps == 0.0f) || stamp.x < 0 || stamp.y < 0 || stamp.x >= width_ || stamp.y >= height_)
+    {
+        return;
+    }
+
+    ApplyStamp(stamp, 1);
+    memory_stamps_[tag] = stamp;
+}
+
+void ThreatMap::EndFrame()
+{
+    for (auto it = stamps_.begin(); it != stamps_.end();)
+    {
+        if (it->second.last_seen_frame != frame_)
+        {
+            ApplyStamp(it->second, -1);
+            it = stamps_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (auto it = memory_stamps_.begin(); it != memory_stamps_.end();)
+    {
+        if (it->second.last_seen_frame != frame_)
+        {
+            ApplyStamp(it->second, -1);
+            it = memory_stamps_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+const vvi & ThreatMap::GetDPSMap() const
+{
+    return dps_map_;
+}
+
+int ThreatMap::ThreatAt(const int x, const int y) const
+{
+    if (x < 0 || y < 0 || x >= width_ || y >= height_)
+    {
+        return unwalkable_danger;
+    }
+
+    return dps_map_[y][x];
+}
+
+int ThreatMap::ThreatAt(const sc2::Point2D & pos) const
+{
+    return ThreatAt(static_cast<int>(pos.x), static_cast<int>(pos.y));
+}
+
+float ThreatMap::GroundDPSAt(const sc2::Point2D & pos) const
+{
+    const int x = static_cast<int>(pos.x);
+    const int y = static_cast<int>(pos.y);
+    if (x < 0 || y < 0 || x >= width_ || y >= height_)
+    {
+        return 0.0f;
+    }
+
+    return ground_dps_[y][x];
+}
+
+float ThreatMap::AirDPSAt(const sc2::Point2D & pos) const
+{
+    const int x = static_cast<int>(pos.x);
+    const int y = static_cast<int>(pos.y);
+    if (x < 0 || y < 0 || x >= width_ || y >= height_)
+    {
+        return 0.0f;
+    }
+
+    return air_dps_[y][x];
+}
+
+float ThreatMap::MemoryDPSAt(const sc2::Point2D & pos, const bool flying) const
+{
+    const int x = static_cast<int>(pos.x);
+    const int y = static_cast<int>(pos.y);
+    if (x < 0 || y < 0 || x >= width_ || y >= height_)
+    {
+        return 0.0f;
+    }
+
+    // Adding and removing stamps can leave a tiny bit of rounding error behind.
+    const float memory = flying ? air_memory_[y][x] : ground_memory_[y][x];
+    return std::max(memory * GetMemoryScale(), 0.0f);
+}
+
+float ThreatMap::DPSAt(const sc2::Point2D & pos, const bool flying) const
+{
+    return (flying ? AirDPSAt(pos) : GroundDPSAt(pos)) + MemoryDPSAt(pos, flying);
+}
+
+sc2::Point2D ThreatMap::GetThreatGradient(const sc2::Point2D & pos, const bool flying, const float max_distance) const
+{
+    const float diagonal = 0.70710678f;
+    const sc2::Point2D directions[] = {
+        sc2::Point2D(1.0f, 0.0f), sc2::Point2D(diagonal, diagonal), sc2::Point2D(0.0f, 1.0f), sc2::Point2D(-diagonal, diagonal),
+        sc2::Point2D(-1.0f, 0.0f), sc2::Point2D(-diagonal, -diagonal), sc2::Point2D(0.0f, -1.0f), sc2::Point2D(diagonal, -diagonal) };
+
+    sc2::Point2D gradient(0.0f, 0.0f);
+    for (float distance = gradient_ring_spacing; distance <= max_distance; distance += gradient_ring_spacing)
+    {
+        for (const sc2::Point2D & direction : directions)
+        {
+            const sc2::Point2D sample(pos.x + direction.x * distance, pos.y + direction.y * distance);
+            const int x = static_cast<int>(sample.x);
+            const int y = static_cast<int>(sample.y);
+
+            float dps;
+            if (!flying && (x < 0 || y < 0 || x >= width_ || y >= height_ || unwalkable_[y][x]))
+            {
+                dps = unwalkable_gradient_dps;
+            }
+            else
+            {
+                dps = DPSAt(sample, flying);
+            }
+
+            // Closer rings count for more, that's where we'll be next.
+            gradient.x += direction.x * dps / distance;
+            gradient.y += direction.y * dps / distance;
+        }
+    }
+
+    return gradient;
+}
+
+uint32_t ThreatMap::GetVersion() const
+{
+    return version_;
+}
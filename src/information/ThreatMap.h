@@ -0,0 +1,113 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+#include "common/Common.h"
+
+// What one enemy adds to the threat map.
+// damage/radius feed the old int map the pathfinding uses. The dps values are split by what the weapons can actually hit.
+struct UnitThreat
+{
+    int     radius;
+    int     damage;
+    int     ground_radius;
+    float   ground_dps;
+    int     air_radius;
+    float   air_dps;
+};
+
+// How much damage per tile the enemy can do to us.
+// Instead of rebuilding the whole map every frame, every enemy "stamps" a circle of damage onto the map.
+// A stamp is only removed and re-applied when the enemy moves to another tile or its damage/range changes.
+//
+// There are five layers, all stamped together in the same pass:
+//   dps_map_        old int map, base_danger on every tile. Used for pathfinding.
+//   ground_dps_     dps against ground units.
+//   air_dps_        dps against air units.
+//   ground_memory_  dps against ground units of enemies we saw recently but can't see any more, fading out over time.
+//   air_memory_     the same against air units.
+class ThreatMap
+{
+    struct Stamp
+    {
+        int         x;
+        int         y;
+        UnitThreat  threat;
+        float       memory;             // 0 for enemies we can see. For remembered ones, how much of their dps is left, scaled by the memory epoch.
+        uint32_t    last_seen_frame;
+        uint32_t    last_seen_game_loop;
+    };
+
+    int                          width_;
+    int                          height_;
+    uint32_t                     frame_;
+    uint32_t                     game_loop_;
+    uint32_t                     memory_epoch_;
+    uint32_t                     version_;
+
+    // Indexed [y][x] to match what the pathfinding code expects.
+    vvi                          dps_map_;
+    vvf                          ground_dps_;
+    vvf                          air_dps_;
+    vvf                          ground_memory_;
+    vvf                          air_memory_;
+    vvb                          unwalkable_;
+    std::map<sc2::Tag, Stamp>    stamps_;
+    std::map<sc2::Tag, Stamp>    memory_stamps_;
+
+    // For each radius, how far the circle reaches left and right on every row. Index is dy + radius.
+    std::map<int, std::vector<int>> circle_masks_;
+
+    const std::vector<int> & GetCircleMask(int radius);
+    int  GetHalfWidth(int radius, int dy);
+    void ApplyStamp(const Stamp & stamp, int sign);
+    void RescaleMemory();
+    float GetMemoryScale() const;
+
+public:
+
+    // There is an inherit "danger" for traveling through any square.
+    // Don't use 0, otherwise we won't find the "shortest and safest path"
+    static const int base_danger = 1;
+    static const int unwalkable_danger = 999;
+
+    // Remembered enemies fade to about a third every memory_decay_game_loops (10 seconds).
+    // Stop remembering them after memory_game_loops, they could be anywhere by then.
+    static const uint32_t memory_decay_game_loops = 224;
+    static const uint32_t memory_game_loops = 672;
+
+    ThreatMap();
+
+    void Reset(int width, int height);
+    void SetUnwalkable(int x, int y);
+
+    // Call BeginFrame, then StampUnit for every enemy we can see and StampMemory for every enemy we remember,
+    // then EndFrame to remove the enemies we didn't stamp.
+    void BeginFrame(uint32_t game_loop);
+    void StampUnit(sc2::Tag tag, const sc2::Point2D & pos, const UnitThreat & threat);
+    void StampMemory(sc2::Tag tag, const sc2::Point2D & pos, const UnitThreat & threat, uint32_t last_seen_game_loop);
+    void EndFrame();
+
+    const vvi & GetDPSMap() const;
+
+    // Out of bounds positions are as dangerous as unwalkable ones.
+    int         ThreatAt(int x, int y) const;
+    int         ThreatAt(const sc2::Point2D & pos) const;
+
+    // Out of bounds positions are 0, nothing can shoot us there. 
+    float       GroundDPSAt(const sc2::Point2D & pos) const;
+    float       AirDPSAt(const sc2::Point2D & pos) const;
+    float       MemoryDPSAt(const sc2::Point2D & pos, bool flying) const;
+
+    // What a flying or ground unit standing here should be worried about, including enemies we can't see right now.
+    float       DPSAt(const sc2::Point2D & pos, bool flying) const;
+
+    // Points the way the threat goes up around pos, looking up to max_distance tiles out. Run the other way to get safer.
+    // Every stamp is flat on the inside, so this samples rings around pos instead of the tiles right next to it.
+    // Unwalkable tiles count as dangerous for ground units, so they don't get run into walls. (0, 0) when it's flat all around.
+    sc2::Point2D GetThreatGradient(const sc2::Point2D & pos, bool flying, float max_distance) const;
+
+    // Goes up every time any tile on the map changes. If it is the same as last time you looked, nothing changed.
+    uint32_t    GetVersion() const;
+};
@@ -0,0 +1,112 @@
+#include "information/UnitArrays.h"
+#include "information/UnitTypeTable.h"
+#include "util/DistanceKernels.h"
+
+void UnitArrays::Build(const std::vector<const sc2::Unit*> & units, const UnitTypeTable & unit_types)
+{
+    const size_t n = units.size();
+    units_.assign(units.begin(), units.end());
+    x_.resize(n);
+    y_.resize(n);
+    hp_.resize(n);
+    type_.resize(n);
+    owner_.resize(n);
+    flags_.resize(n);
+    range_.resize(n);
+    damage_.resize(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const sc2::Unit* unit = units[i];
+        const UnitTypeTraits & traits = unit_types.Get(unit->unit_type);
+
+        uint32_t flags = 0;
+        if (unit->is_flying)                                        flags |= UnitArrayFlag::Flying;
+        if (traits.is_building)                                     flags |= UnitArrayFlag::Building;
+        if (traits.is_worker)                                       flags |= UnitArrayFlag::Worker;
+        if (traits.is_combat_unit)                                  flags |= UnitArrayFlag::CombatUnit;
+        if (unit->build_progress == 1.0f)                           flags |= UnitArrayFlag::Completed;
+        if (unit->display_type == sc2::Unit::DisplayType::Visible)  flags |= UnitArrayFlag::Visible;
+        if (traits.can_attack_ground)                               flags |= UnitArrayFlag::CanAttackGround;
+        if (traits.can_attack_air)                                  flags |= UnitArrayFlag::CanAttackAir;
+
+        x_[i] = unit->pos.x;
+        y_[i] = unit->pos.y;
+        hp_[i] = unit->health + unit->shield;
+        type_[i] = unit->unit_type;
+        owner_[i] = unit->owner;
+        flags_[i] = flags;
+        range_[i] = traits.max_range;
+        damage_[i] = traits.max_damage;
+    }
+}
+
+size_t UnitArrays::size() const
+{
+    return units_.size();
+}
+
+bool UnitArrays::empty() const
+{
+    return units_.empty();
+}
+
+const sc2::Unit* UnitArrays::GetUnit(const size_t i) const
+{
+    return units_[i];
+}
+
+const float* UnitArrays::X() const
+{
+    return x_.data();
+}
+
+const float* UnitArrays::Y() const
+{
+    return y_.data();
+}
+
+const float* UnitArrays::HP() const
+{
+    return hp_.data();
+}
+
+const uint32_t* UnitArrays::Type() const
+{
+    return type_.data();
+}
+
+const int* UnitArrays::Owner() const
+{
+    return owner_.data();
+}
+
+const uint32_t* UnitArrays::Flags() const
+{
+    return flags_.data();
+}
+
+const float* UnitArrays::Range() const
+{
+    return range_.data();
+}
+
+const float* UnitArrays::Damage() const
+{
+    return damage_.data();
+}
+
+void UnitArrays::GetInRadius(const sc2::Point2D & point, const float radius, std::vector<const sc2::Unit*> & units) const
+{
+    std::vector<uint32_t> indices(units_.size());
+    const size_t found = DistanceKernels::FindInRadius(point, radius, x_.data(), y_.data(), units_.size(), indices.data());
+    for (size_t i = 0; i < found; ++i)
+    {
+        units.push_back(units_[indices[i]]);
+    }
+}
+
+float UnitArrays::DamageInRange(const sc2::Point2D & point, const float margin) const
+{
+    return DistanceKernels::SumInRange(point, x_.data(), y_.data(), range_.data(), damage_.data(), units_.size(), margin);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+class UnitTypeTable;
+
+namespace UnitArrayFlag
+{
+    enum : uint32_t
+    {
+        Flying          = 1 << 0,
+        Building        = 1 << 1,
+        Worker          = 1 << 2,
+        CombatUnit      = 1 << 3,
+        Completed       = 1 << 4,
+        Visible         = 1 << 5,   // not a snapshot of a building we saw earlier
+        CanAttackGround = 1 << 6,
+        CanAttackAir    = 1 << 7,
+    };
+}
+
+// The same units as UnitInfoManager::GetUnits, but every field we scan a lot in its own flat array.
+// Looping over x_ and y_ touches two small arrays instead of a whole sc2::Unit per unit, and DistanceKernels can run over them.
+// Index i in every array is the same unit, GetUnit(i) goes back to the sc2::Unit.
+class UnitArrays
+{
+    std::vector<const sc2::Unit*>   units_;
+    std::vector<float>              x_;
+    std::vector<float>              y_;
+    std::vector<float>              hp_;            // health + shield
+    std::vector<uint32_t>           type_;
+    std::vector<int>                owner_;
+    std::vector<uint32_t>           flags_;
+    std::vector<float>              range_;         // longest range of any weapon
+    std::vector<float>              damage_;        // hardest hit of any weapon
+
+public:
+
+    void Build(const std::vector<const sc2::Unit*> & units, const UnitTypeTable & unit_types);
+
+    size_t              size() const;
+    bool                empty() const;
+    const sc2::Unit*    GetUnit(size_t i) const;
+
+    const float*        X() const;
+    const float*        Y() const;
+    const float*        HP() const;
+    const uint32_t*     Type() const;
+    const int*          Owner() const;
+    const uint32_t*     Flags() const;
+    const float*        Range() const;
+    const float*        Damage() const;
+
+    // Every unit strictly closer than radius to the point.
+    void                GetInRadius(const sc2::Point2D & point, float radius, std::vector<const sc2::Unit*> & units) const;
+
+    // How hard everything that can reach the point (range + margin) hits in one volley.
+    float               DamageInRange(const sc2::Point2D & point, float margin) const;
+};
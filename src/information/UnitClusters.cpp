@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include "information/UnitClusters.h"
+#include "information/UnitGrid.h"
+#include "information/UnitTypeTable.h"
+#include "util/Util.h"
+
+const float UnitClusters::link_distance = 5.0f;
+
+namespace
+{
+    const float game_loops_per_second = 22.4f;
+}
+
+UnitClusters::UnitClusters()
+    : previous_game_loop_(0)
+    , next_id_(0)
+{
+}
+
+void UnitClusters::Update(const std::vector<const sc2::Unit*> & units, const UnitGrid & grid, const UnitTypeTable & unit_types, const uint32_t game_loop)
+{
+    clusters_.clear();
+    cluster_index_.clear();
+
+    const auto is_clustered = [&unit_types](const sc2::Unit* unit)
+    {
+        return !unit_types.Get(unit->unit_type).is_building;
+    };
+
+    // Flood out from every unit that isn't in a cluster yet, one grid query per unit.
+    std::vector<const sc2::Unit*> frontier;
+    for (auto & seed : units)
+    {
+        if (!is_clustered(seed) || cluster_index_.count(seed))
+        {
+            continue;
+        }
+
+        const size_t index = clusters_.size();
+        clusters_.push_back(UnitCluster());
+        cluster_index_[seed] = index;
+        frontier.push_back(seed);
+
+        while (!frontier.empty())
+        {
+            const sc2::Unit* unit = frontier.back();
+            frontier.pop_back();
+            clusters_[index].units.push_back(unit);
+
+            for (auto & neighbour : grid.GetInRadius(unit->pos, link_distance, is_clustered))
+            {
+                if (cluster_index_.insert(std::make_pair(neighbour, index)).second)
+                {
+                    frontier.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    ComputeAggregates(unit_types);
+    MatchPreviousClusters(game_loop);
+}
+
+// Same units in the same clusters as the last Update, but they've moved a little and taken damage since.
+void UnitClusters::Refresh(const UnitTypeTable & unit_types, const uint32_t game_loop)
+{
+    ComputeAggregates(unit_types);
+
+    const float seconds = (game_loop - previous_game_loop_) / game_loops_per_second;
+    if (seconds <= 0.0f)
+    {
+        return;
+    }
+
+    for (auto & cluster : clusters_)
+    {
+        sc2::Point2D & previous = previous_center_[cluster.id];
+        cluster.velocity = sc2::Point2D((cluster.center.x - previous.x) / seconds, (cluster.center.y - previous.y) / seconds);
+        previous = cluster.center;
+    }
+    previous_game_loop_ = game_loop;
+}
+
+void UnitClusters::ComputeAggregates(const UnitTypeTable & unit_types)
+{
+    for (auto & cluster : clusters_)
+    {
+        sc2::Point2D sum(0.0f, 0.0f);
+        cluster.hp = 0.0f;
+        cluster.ground_dps = 0.0f;
+        cluster.air_dps = 0.0f;
+        cluster.num_ground = 0;
+        cluster.num_air = 0;
+        cluster.num_combat = 0;
+
+        for (auto & unit : cluster.units)
+        {
+            const UnitTypeTraits & traits = unit_types.Get(unit->unit_type);
+            sum += unit->pos;
+            cluster.hp += unit->health + unit->shield;
+            cluster.ground_dps += traits.ground_dps;
+            cluster.air_dps += traits.air_dps;
+            cluster.num_ground += unit->is_flying ? 0 : 1;
+            cluster.num_air += unit->is_flying ? 1 : 0;
+            cluster.num_combat += traits.is_combat_unit ? 1 : 0;
+        }
+
+        cluster.center = sc2::Point2D(sum.x / cluster.units.size(), sum.y / cluster.units.size());
+        cluster.strength = cluster.hp * (cluster.ground_dps + cluster.air_dps);
+
+        cluster.radius = 0.0f;
+        for (auto & unit : cluster.units)
+        {
+            cluster.radius = std::max(cluster.radius, Util::Dist(cluster.center, unit->pos));
+        }
+    }
+}
+
+// Every cluster takes the id most of its units had last time. If a cluster split, the biggest half keeps the id.
+void UnitClusters::MatchPreviousClusters(const uint32_t game_loop)
+{
+    std::vector<size_t> by_size(clusters_.size());
+    for (size_t i = 0; i < by_size.size(); ++i)
+    {
+        by_size[i] = i;
+    }
+    std::sort(by_size.begin(), by_size.end(), [this](const size_t a, const size_t b) { return clusters_[a].units.size() > clusters_[b].units.size(); });
+
+    const float seconds = (game_loop - previous_game_loop_) / game_loops_per_second;
+    std::map<int, bool> taken;
+
+    for (const size_t i : by_size)
+    {
+        UnitCluster & cluster = clusters_[i];
+
+        std::map<int, int> votes;
+        for (auto & unit : cluster.units)
+        {
+            const auto it = previous_id_.find(unit->tag);
+            if (it != previous_id_.end() && !taken[it->second])
+            {
+                ++votes[it->second];
+            }
+        }
+
+        int best_id = -1;
+        int best_votes = 0;
+        for (auto & vote : votes)
+        {
+            if (vote.second > best_votes)
+            {
+                best_id = vote.first;
+                best_votes = vote.second;
+            }
+        }
+
+        cluster.velocity = sc2::Point2D(0.0f, 0.0f);
+        if (best_id == -1)
+        {
+            cluster.id = next_id_++;
+        }
+        else
+        {
+            cluster.id = best_id;
+            if (seconds > 0.0f)
+            {
+                const sc2::Point2D & previous = previous_center_[best_id];
+                cluster.velocity = sc2::Point2D((cluster.center.x - previous.x) / seconds, (cluster.center.y - previous.y) / seconds);
+            }
+        }
+        taken[cluster.id] = true;
+    }
+
+    previous_id_.clear();
+    previous_center_.clear();
+    for (auto & cluster : clusters_)
+    {
+        for (auto & unit : cluster.units)
+        {
+            previous_id_[unit->tag] = cluster.id;
+        }
+        previous_center_[cluster.id] = cluster.center;
+    }
+    previous_game_loop_ = game_loop;
+}
+
+const std::vector<UnitCluster> & UnitClusters::GetClusters() const
+{
+    return clusters_;
+}
+
+const UnitCluster* UnitClusters::GetCluster(const sc2::Unit* unit) const
+{
+    const auto it = cluster_index_.find(unit);
+    return it == cluster_index_.end() ? nullptr : &clusters_[it->second];
+}
+
+void UnitClusters::GetClustersInRadius(const sc2::Point2D & point, const float radius, std::vector<const UnitCluster*> & clusters) const
+{
+    clusters.clear();
+    for (auto & cluster : clusters_)
+    {
+        if (Util::Dist(point, cluster.center) < radius + cluster.radius)
+        {
+            clusters.push_back(&cluster);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+class UnitGrid;
+class UnitTypeTable;
+
+// A group of units standing close together. Everything micro and strategy code usually wants to know about "that army over there".
+struct UnitCluster
+{
+    int                             id;             // stays the same between updates as long as most of the units stay together
+    std::vector<const sc2::Unit*>   units;
+    sc2::Point2D                    center;
+    sc2::Point2D                    velocity;       // how fast the center moves, in tiles per second
+    float                           radius;         // from the center to the furthest unit
+    float                           hp;             // health + shields
+    float                           ground_dps;
+    float                           air_dps;
+    float                           strength;       // hp * dps, so twice the units counts as four times as strong
+    int                             num_ground;
+    int                             num_air;
+    int                             num_combat;
+};
+
+// DBSCAN-style clustering of one player's units (not buildings): two units closer than link_distance are in the same cluster.
+// With a minimum of one point per cluster that's the same as following links, so there's no noise, a lonely unit is its own cluster.
+// Neighbours come from the player's UnitGrid. UnitInfoManager only calls Update on frames where that grid was rebuilt,
+// and Refresh on the rest, to keep health, strength and centers current without redoing the clustering.
+class UnitClusters
+{
+    std::vector<UnitCluster>                        clusters_;
+    std::unordered_map<const sc2::Unit*, size_t>    cluster_index_;     // unit -> index into clusters_
+
+    // From the last update, to keep ids stable and work out velocities.
+    std::unordered_map<sc2::Tag, int>               previous_id_;
+    std::unordered_map<int, sc2::Point2D>           previous_center_;
+    uint32_t                                        previous_game_loop_;
+    int                                             next_id_;
+
+    void ComputeAggregates(const UnitTypeTable & unit_types);
+    void MatchPreviousClusters(uint32_t game_loop);
+
+public:
+
+    static const float link_distance;
+
+    UnitClusters();
+
+    void Update(const std::vector<const sc2::Unit*> & units, const UnitGrid & grid, const UnitTypeTable & unit_types, uint32_t game_loop);
+    // Recomputes everything but the membership. Only valid when no unit has come, gone or changed tiles since the last Update.
+    void Refresh(const UnitTypeTable & unit_types, uint32_t game_loop);
+
+    const std::vector<UnitCluster> & GetClusters() const;
+
+    // The cluster the unit is in, or nullptr for buildings and units we didn't see at the last update.
+    const UnitCluster* GetCluster(const sc2::Unit* unit) const;
+
+    // Clusters whose units could be within radius of the point.
+    void GetClustersInRadius(const sc2::Point2D & point, float radius, std::vector<const UnitCluster*> & clusters) const;
+};
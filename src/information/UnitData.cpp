@@ -3,25 +3,41 @@
 #include "util/Util.h"
 
 UnitData::UnitData()
-    : minerals_lost_(0)
+    : workers_(unit_info_map_)
+    , minerals_lost_(0)
     , gas_lost_(0)
 {
     const int max_type_id = 1024;
     num_dead_units_       = std::vector<int>(max_type_id + 1, 0);
     num_units_            = std::vector<int>(max_type_id + 1, 0);
+
+    for (int mission = static_cast<int>(UnitMission::Idle); mission <= static_cast<int>(UnitMission::Proxy); ++mission)
+    {
+        mission_units_.emplace(static_cast<UnitMission>(mission), UnitGroup(unit_info_map_));
+    }
 }
 
-void UnitData::UpdateUnit(const sc2::Unit* unit)
+// Units can get a job (OnUnitCreated) before UpdateUnit ever sees them, so both go through here.
+UnitInfo & UnitData::AddUnit(const sc2::Unit* unit)
 {
-    bool first_seen = false;
-    const auto & it = unit_info_map_.find(unit->tag);
-    if (it == unit_info_map_.end())
+    UnitInfo* existing = unit_info_map_.Find(unit->tag);
+    if (existing)
     {
-        first_seen = true;
-        unit_info_map_[unit->tag] = UnitInfo();
+        return *existing;
     }
 
-    UnitInfo & ui   = unit_info_map_[unit->tag];
+    UnitInfo & ui   = unit_info_map_.Insert(unit->tag);
+    ui.unit         = unit;
+    ui.player       = Util::GetPlayer(unit);
+    ui.type         = unit->unit_type;
+    num_units_[ui.type]++;
+    mission_units_.at(ui.mission).Insert(unit_info_map_.GetHandle(unit->tag));
+    return ui;
+}
+
+void UnitData::UpdateUnit(const sc2::Unit* unit)
+{
+    UnitInfo & ui   = AddUnit(unit);
     ui.unit         = unit;
     ui.player       = Util::GetPlayer(unit);
     ui.lastPosition = unit->pos;
@@ -30,14 +46,9 @@ void UnitData::UpdateUnit(const sc2::Unit* unit)
     ui.type         = unit->unit_type;
     ui.progress     = unit->build_progress;
 
-    if (first_seen)
-    {
-        num_units_[ui.type]++;
-    }
-
     if (Util::IsWorker(unit))
     {
-        workers_.insert(&unit_info_map_[unit->tag]);
+        workers_.Insert(unit_info_map_.GetHandle(unit->tag));
     }
 }
 
@@ -48,32 +59,42 @@ void UnitData::KillUnit(const sc2::Unit* unit)
     num_units_[unit->unit_type]--;
     num_dead_units_[unit->unit_type]++;
 
+    const UnitInfo* ui = unit_info_map_.Find(unit->tag);
+    if (!ui) return;
+
     // If a refinery or a base dies, no need to set the coresponding refinery_worker_count_ or base_worker_count_ to 0.
     // Those stats get changed when we call ClearPreviousJob(unit);
 
     // If the killed unit was a worker, go ahead and update some stats.
     ClearPreviousJob(unit);
-    workers_.erase(&unit_info_map_[unit->tag]);
-    // Erasing the unit must be last. Cleanup the pointers before deleting the object. 
-    unit_info_map_.erase(unit->tag); 
+    const UnitHandle handle = unit_info_map_.GetHandle(unit->tag);
+    mission_units_.at(ui->mission).Erase(handle);
+    workers_.Erase(handle);
+    // Erasing the unit must be last. ClearPreviousJob needs it.
+    unit_info_map_.Erase(unit->tag);
 }
 
 void UnitData::RemoveBadUnits()
 {
-    for (auto iter = unit_info_map_.begin(); iter != unit_info_map_.end();)
+    // Erasing moves units around in the slot map, so find them all first.
+    std::vector<sc2::Tag> bad_units;
+    for (const UnitInfo & ui : unit_info_map_)
     {
-        if (BadUnitInfo(iter->second))
+        if (BadUnitInfo(ui))
         {
-            num_units_[iter->second.type]--;
-            iter = unit_info_map_.erase(iter);
-            combat_units_.erase(&iter->second);
-            workers_.erase(&iter->second);
-        }
-        else
-        {
-            iter++;
+            bad_units.push_back(ui.unit->tag);
         }
     }
+
+    for (const sc2::Tag tag : bad_units)
+    {
+        const UnitInfo* ui = unit_info_map_.Find(tag);
+        const UnitHandle handle = unit_info_map_.GetHandle(tag);
+        num_units_[ui->type]--;
+        mission_units_.at(ui->mission).Erase(handle);
+        workers_.Erase(handle);
+        unit_info_map_.Erase(tag);
+    }
 }
 
 bool UnitData::BadUnitInfo(const UnitInfo & ui) const
@@ -123,14 +144,19 @@ int UnitData::GetNumAssignedWorkers(const sc2::Unit* depot)
     return 0;
 }
 
-const std::map<sc2::Tag, UnitInfo>& UnitData::GetUnitInfoMap() const
+const UnitSlotMap & UnitData::GetUnitInfoMap() const
 {
     return unit_info_map_;
 }
 
-std::set<const UnitInfo*> UnitData::GetCombatUnits() const
+const UnitGroup & UnitData::GetCombatUnits() const
+{
+    return mission_units_.at(UnitMission::Attack);
+}
+
+const UnitGroup & UnitData::GetUnitsWithMission(const UnitMission mission) const
 {
-    return combat_units_;
+    return mission_units_.at(mission);
 }
 
 // jobUnitTag is optional.
@@ -138,7 +164,7 @@ void UnitData::SetJob(const sc2::Unit* unit, const UnitMission job, ByunJRBot &
 {
     ClearPreviousJob(unit);
 
-    UnitInfo & ui = unit_info_map_[unit->tag];
+    UnitInfo & ui = AddUnit(unit);
 
     // Update the information about the current job. 
     if (job == UnitMission::Minerals)
@@ -156,9 +182,6 @@ void UnitData::SetJob(const sc2::Unit* unit, const UnitMission job, ByunJRBot &
             base_worker_count_[base->tag] = 0;
         }
 
-        // add the depot to our set of depots
-        depots_.insert(&unit_info_map_[unit->tag]);
-
         // Increase the worker count of this depot.
         base_worker_count_[base->tag]++;
         worker_depot_map_[unit->tag] = unit;
@@ -187,55 +210,52 @@ void UnitData::SetJob(const sc2::Unit* unit, const UnitMission job, ByunJRBot &
         worker_refinery_map_[unit->tag] = unit;
         ui.missionTarget = refinery;
     }
-    else if (job == UnitMission::Attack)
-    {
-        combat_units_.insert(&unit_info_map_[unit->tag]);
-    }
-    else if (job == UnitMission::Scout)
-    {
-        scout_units_.insert(&unit_info_map_[unit->tag]);
-    }
     else if (job == UnitMission::Repair)
     {
         unit_repair_chart_[mission_target->tag]++;
         ui.missionTarget = mission_target;
     }
 
+    const UnitHandle handle = unit_info_map_.GetHandle(unit->tag);
+    mission_units_.at(ui.mission).Erase(handle);
+    mission_units_.at(job).Insert(handle);
     ui.mission = job;
 }
 
 void UnitData::ClearPreviousJob(const sc2::Unit* unit)
 {
     // Remove the entry from the previous job, if there is one. 
-    if (unit_info_map_[unit->tag].mission == UnitMission::Minerals)
+    const UnitInfo* ui = unit_info_map_.Find(unit->tag);
+    if (!ui) return;
+
+    if (ui->mission == UnitMission::Minerals)
     {
         // Remove one worker from the count of the depot this worker was assigned to.
         base_worker_count_[worker_depot_map_[unit->tag]->tag]--;
         worker_depot_map_.erase(unit->tag);
     }
-    else if (unit_info_map_[unit->tag].mission == UnitMission::Gas)
+    else if (ui->mission == UnitMission::Gas)
     {
         refinery_worker_count_[worker_refinery_map_[unit->tag]->tag]--;
         worker_refinery_map_.erase(unit->tag);
     }
-    else if (unit_info_map_[unit->tag].mission == UnitMission::Repair)
-        unit_repair_chart_[unit_info_map_[unit->tag].missionTarget->tag]--;
+    else if (ui->mission == UnitMission::Repair)
+        unit_repair_chart_[ui->missionTarget->tag]--;
 
-    scout_units_.erase(&unit_info_map_[unit->tag]);
-    combat_units_.erase(&unit_info_map_[unit->tag]);
+    // The mission groups get updated in SetJob, once we know the new job actually stuck.
     // No need to remove workers. workers keep track of scv's and mules.
     // Workers will always be workers. Only remove them from workers when they die. 
     // workers.erase(&m_unitInfoMap[unit->tag]);
 }
 
-std::set<const UnitInfo*> UnitData::GetWorkers() const
+const UnitGroup & UnitData::GetWorkers() const
 {
     return workers_;
 }
 
-std::set<const UnitInfo*> UnitData::GetScouts() const
+const UnitGroup & UnitData::GetScouts() const
 {
-    return scout_units_;
+    return mission_units_.at(UnitMission::Scout);
 }
 
 int UnitData::GetNumRepairWorkers(const sc2::Unit* unit) const
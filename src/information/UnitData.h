@@ -1,7 +1,9 @@
 #pragma once
 #include <sc2api/sc2_api.h>
 
+#include "information/UnitGroup.h"
 #include "information/UnitInfo.h"
+#include "information/UnitSlotMap.h"
 #include "macro/Building.h"
 
 typedef std::vector<UnitInfo> UnitInfoVector;
@@ -9,15 +11,14 @@ typedef std::vector<UnitInfo> UnitInfoVector;
 // The difference between UnitData and UnitInfo is that UnitData is specific to a player. UnitInfo is everything.
 class UnitData
 {
-    std::map<sc2::Tag, UnitInfo>           unit_info_map_;
+    // The groups below point at this, which is why a UnitData can't be copied.
+    UnitSlotMap                            unit_info_map_;
 
     // Pointers to all the workers to allow for faster iteration. 
-    std::set<const UnitInfo*>              workers_;
-    // Pointers to all the combat units to allow for faster iteration.
-    std::set<const UnitInfo*>              combat_units_;
-    // Pointers to all the scouting units to allow for faster iteration.
-    std::set<const UnitInfo*>              scout_units_;
-    std::set<const UnitInfo*>              depots_;
+    UnitGroup                              workers_;
+    // Every unit, grouped by its current mission. Kept up to date by SetJob.
+    // Combat units are the Attack group, scouts are the Scout group.
+    std::map<UnitMission, UnitGroup>       mission_units_;
     // sc2::Tag is a player's base. int is the number of workers at that base. 
     std::map<sc2::Tag, int>                base_worker_count_;
     // sc2::Tag is a player's base. int is the number of workers at that refinery. 
@@ -38,10 +39,13 @@ class UnitData
     int                                    gas_lost_;
 
     bool BadUnitInfo(const UnitInfo & ui) const;
+    UnitInfo & AddUnit(const sc2::Unit* unit);
 
 public:
 
     UnitData();
+    UnitData(const UnitData &) = delete;
+    UnitData & operator=(const UnitData &) = delete;
 
     void UpdateUnit(const sc2::Unit* unit);
     void KillUnit(const sc2::Unit* unit);
@@ -52,14 +56,15 @@ public:
     int GetNumUnits(sc2::UnitTypeID t) const;
     int GetNumDeadUnits(sc2::UnitTypeID t) const;
     int GetNumAssignedWorkers(const sc2::Unit* depot);
-    const std::map<sc2::Tag, UnitInfo>& GetUnitInfoMap() const;
-    std::set<const UnitInfo*> GetCombatUnits() const;
+    const UnitSlotMap & GetUnitInfoMap() const;
+    const UnitGroup & GetCombatUnits() const;
+    const UnitGroup & GetUnitsWithMission(UnitMission mission) const;
 
     // mission_target is the additional information that some jobs require. Minerals requires a base, gas requires a geyser, etc. 
     void SetJob(const sc2::Unit* unit, const UnitMission job, ByunJRBot& bot, const sc2::Unit* mission_target=nullptr);
     size_t GetNumWorkers() const;
     void ClearPreviousJob(const sc2::Unit* unit);
-    std::set<const UnitInfo*> GetWorkers() const;
-    std::set<const UnitInfo*> GetScouts() const;
+    const UnitGroup & GetWorkers() const;
+    const UnitGroup & GetScouts() const;
     int GetNumRepairWorkers(const sc2::Unit* unit) const;
 };
@@ -0,0 +1,27 @@
+#pragma once
+#include <sc2api/sc2_api.h>
+
+#include "common/Common.h"
+
+// What changed about a unit since the last frame. UnitInfoManager works these out every frame by comparing the
+// observation with what it saw the frame before, so anything that only cares about changes can skip the rest.
+enum class UnitEventType
+{
+    Created,        // We can see it now and couldn't last frame. Either it's new or it came back into vision.
+    Destroyed,      // It was there last frame and isn't any more. Either it died or it left our vision.
+    Moved,          // It's standing on another tile than last frame.
+    Damaged,        // Lost health or shields.
+    TypeChanged,    // Morphed, sieged, burrowed, lifted off...
+    Completed       // Finished building.
+};
+
+struct UnitEvent
+{
+    UnitEventType       type;
+    sc2::Tag            tag;
+    // Don't use this for Destroyed events, the unit could be dead.
+    const sc2::Unit*    unit;
+    PlayerArrayIndex    player;
+    // For TypeChanged, the type it was before. Otherwise the same as the unit's type.
+    sc2::UnitTypeID     previous_type;
+};
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+#include "information/UnitGrid.h"
+#include "util/Util.h"
+
+UnitGrid::UnitGrid()
+    : cell_size_(8.0f)
+    , columns_(1)
+    , rows_(1)
+{
+    cell_start_.assign(2, 0);
+}
+
+void UnitGrid::Reset(const int map_width, const int map_height, const float cell_size)
+{
+    cell_size_ = cell_size;
+    columns_ = std::max(1, static_cast<int>(std::ceil(map_width / cell_size_)));
+    rows_ = std::max(1, static_cast<int>(std::ceil(map_height / cell_size_)));
+    units_.clear();
+    cell_start_.assign(columns_ * rows_ + 1, 0);
+}
+
+// Units off the edge of the map (it happens with flying units) go in the closest cell.
+int UnitGrid::GetColumn(const float x) const
+{
+    return std::min(std::max(static_cast<int>(x / cell_size_), 0), columns_ - 1);
+}
+
+int UnitGrid::GetRow(const float y) const
+{
+    return std::min(std::max(static_cast<int>(y / cell_size_), 0), rows_ - 1);
+}
+
+// Counting sort by cell, so the whole grid is three flat arrays and nothing gets allocated once it has grown.
+void UnitGrid::Build(const std::vector<const sc2::Unit*> & units)
+{
+    const int num_cells = columns_ * rows_;
+    cell_start_.assign(num_cells + 1, 0);
+    unit_cell_.resize(units.size());
+
+    for (size_t i = 0; i < units.size(); ++i)
+    {
+        unit_cell_[i] = GetRow(units[i]->pos.y) * columns_ + GetColumn(units[i]->pos.x);
+        ++cell_start_[unit_cell_[i] + 1];
+    }
+
+    for (int cell = 0; cell < num_cells; ++cell)
+    {
+        cell_start_[cell + 1] += cell_start_[cell];
+    }
+
+    units_.resize(units.size());
+    std::vector<int> next(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < units.size(); ++i)
+    {
+        units_[next[unit_cell_[i]]++] = units[i];
+    }
+}
+
+template <typename F>
+void UnitGrid::ForEachInRing(const int column, const int row, const int ring, F f) const
+{
+    const int min_row = std::max(row - ring, 0);
+    const int max_row = std::min(row + ring, rows_ - 1);
+    for (int r = min_row; r <= max_row; ++r)
+    {
+        // The top and bottom rows of the ring are full, the rest only have the two ends.
+        const bool full_row = r == row - ring || r == row + ring;
+        const int step = full_row || ring == 0 ? 1 : 2 * ring;
+        for (int c = column - ring; c <= column + ring; c += step)
+        {
+            if (c < 0 || c >= columns_)
+            {
+                continue;
+            }
+
+            const int cell = r * columns_ + c;
+            for (int i = cell_start_[cell]; i < cell_start_[cell + 1]; ++i)
+            {
+                f(units_[i]);
+            }
+        }
+    }
+}
+
+// Search outwards one ring of cells at a time. Anything in the next ring is at least ring * cell_size away,
+// so once we have something closer than that we can stop.
+const sc2::Unit* UnitGrid::GetClosest(const sc2::Point2D & point, const UnitFilter & filter) const
+{
+    const sc2::Unit* closest_unit = nullptr;
+    float closest_distance = std::numeric_limits<float>::max();
+
+    const int column = GetColumn(point.x);
+    const int row = GetRow(point.y);
+    const int max_ring = std::max(columns_, rows_);
+    for (int ring = 0; ring <= max_ring; ++ring)
+    {
+        ForEachInRing(column, row, ring, [&](const sc2::Unit* unit)
+        {
+            const float distance = Util::DistSq(unit->pos, point);
+            if (distance < closest_distance && (!filter || filter(unit)))
+            {
+                closest_unit = unit;
+                closest_distance = distance;
+            }
+        });
+
+        const float searched = ring * cell_size_;
+        if (closest_unit && closest_distance <= searched * searched)
+        {
+            break;
+        }
+    }
+
+    return closest_unit;
+}
+
+std::vector<const sc2::Unit*> UnitGrid::GetKClosest(const sc2::Point2D & point, const size_t k, const UnitFilter & filter) const
+{
+    // Max heap on distance, so the worst of the k best is always on top.
+    typedef std::pair<float, const sc2::Unit*> Candidate;
+    std::priority_queue<Candidate> best;
+
+    if (k > 0)
+    {
+        const int column = GetColumn(point.x);
+        const int row = GetRow(point.y);
+        const int max_ring = std::max(columns_, rows_);
+        for (int ring = 0; ring <= max_ring; ++ring)
+        {
+            ForEachInRing(column, row, ring, [&](const sc2::Unit* unit)
+            {
+                const float distance = Util::DistSq(unit->pos, point);
+                if ((best.size() < k || distance < best.top().first) && (!filter || filter(unit)))
+                {
+                    best.push(Candidate(distance, unit));
+                    if (best.size() > k)
+                    {
+                        best.pop();
+                    }
+                }
+            });
+
+            const float searched = ring * cell_size_;
+            if (best.size() == k && best.top().first <= searched * searched)
+            {
+                break;
+            }
+        }
+    }
+
+    std::vector<const sc2::Unit*> closest_units(best.size());
+    for (size_t i = closest_units.size(); i > 0; --i)
+    {
+        closest_units[i - 1] = best.top().second;
+        best.pop();
+    }
+    return closest_units;
+}
+
+std::vector<const sc2::Unit*> UnitGrid::GetInRadius(const sc2::Point2D & point, const float radius, const UnitFilter & filter) const
+{
+    std::vector<const sc2::Unit*> units;
+    const float radius_sq = radius * radius;
+
+    const int min_column = GetColumn(point.x - radius);
+    const int max_column = GetColumn(point.x + radius);
+    const int min_row = GetRow(point.y - radius);
+    const int max_row = GetRow(point.y + radius);
+    for (int r = min_row; r <= max_row; ++r)
+    {
+        for (int c = min_column; c <= max_column; ++c)
+        {
+            const int cell = r * columns_ + c;
+            for (int i = cell_start_[cell]; i < cell_start_[cell + 1]; ++i)
+            {
+                if (Util::DistSq(units_[i]->pos, point) <= radius_sq && (!filter || filter(units_[i])))
+                {
+                    units.push_back(units_[i]);
+                }
+            }
+        }
+    }
+
+    return units;
+}
+
+bool UnitGrid::IsAnyInRadius(const sc2::Point2D & point, const float radius, const UnitFilter & filter) const
+{
+    const float radius_sq = radius * radius;
+
+    const int min_column = GetColumn(point.x - radius);
+    const int max_column = GetColumn(point.x + radius);
+    const int min_row = GetRow(point.y - radius);
+    const int max_row = GetRow(point.y + radius);
+    for (int r = min_row; r <= max_row; ++r)
+    {
+        for (int c = min_column; c <= max_column; ++c)
+        {
+            const int cell = r * columns_ + c;
+            for (int i = cell_start_[cell]; i < cell_start_[cell + 1]; ++i)
+            {
+                if (Util::DistSq(units_[i]->pos, point) <= radius_sq && (!filter || filter(units_[i])))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+// Return false to skip a unit in a UnitGrid query.
+typedef std::function<bool(const sc2::Unit*)> UnitFilter;
+
+// All of one player's units bucketed into square cells, rebuilt from scratch every frame.
+// Finding the closest unit only looks at the cells around the point instead of every unit in the game.
+class UnitGrid
+{
+    float                           cell_size_;
+    int                             columns_;
+    int                             rows_;
+
+    // Units sorted by cell. The units in cell i are units_[cell_start_[i]] to units_[cell_start_[i + 1] - 1].
+    std::vector<const sc2::Unit*>   units_;
+    std::vector<int>                cell_start_;
+    std::vector<int>                unit_cell_;
+
+    int  GetColumn(float x) const;
+    int  GetRow(float y) const;
+
+    // Calls f on every unit in the cells that are exactly ring cells away (in both directions) from the given cell.
+    template <typename F>
+    void ForEachInRing(int column, int row, int ring, F f) const;
+
+public:
+
+    UnitGrid();
+
+    void Reset(int map_width, int map_height, float cell_size);
+    void Build(const std::vector<const sc2::Unit*> & units);
+
+    // nullptr if no unit passes the filter. A null filter lets every unit through.
+    // The filter is only called on units that are closer than the best one found so far.
+    const sc2::Unit* GetClosest(const sc2::Point2D & point, const UnitFilter & filter = nullptr) const;
+
+    // Sorted closest first. There can be fewer than k if there aren't enough units.
+    std::vector<const sc2::Unit*> GetKClosest(const sc2::Point2D & point, size_t k, const UnitFilter & filter = nullptr) const;
+
+    std::vector<const sc2::Unit*> GetInRadius(const sc2::Point2D & point, float radius, const UnitFilter & filter = nullptr) const;
+    bool IsAnyInRadius(const sc2::Point2D & point, float radius, const UnitFilter & filter = nullptr) const;
+};
@@ -0,0 +1,101 @@
+#include <limits>
+
+#include "information/UnitGroup.h"
+#include "util/Util.h"
+
+UnitGroup::UnitGroup(const UnitSlotMap & units)
+    : units_(&units)
+{
+
+}
+
+void UnitGroup::Insert(const UnitHandle & handle)
+{
+    if (handle.index >= position_.size())
+    {
+        position_.resize(handle.index + 1, -1);
+    }
+
+    if (position_[handle.index] >= 0)
+    {
+        return;
+    }
+
+    position_[handle.index] = static_cast<int>(handles_.size());
+    handles_.push_back(handle);
+}
+
+void UnitGroup::Erase(const UnitHandle & handle)
+{
+    if (!Contains(handle))
+    {
+        return;
+    }
+
+    const int i = position_[handle.index];
+    position_[handle.index] = -1;
+
+    if (i != static_cast<int>(handles_.size()) - 1)
+    {
+        handles_[i] = handles_.back();
+        position_[handles_[i].index] = i;
+    }
+    handles_.pop_back();
+}
+
+bool UnitGroup::Contains(const UnitHandle & handle) const
+{
+    return handle.index < position_.size()
+        && position_[handle.index] >= 0
+        && handles_[position_[handle.index]].generation == handle.generation;
+}
+
+std::vector<const UnitInfo*> UnitGroup::GetUnits() const
+{
+    std::vector<const UnitInfo*> units;
+    units.reserve(handles_.size());
+    for (const UnitHandle & handle : handles_)
+    {
+        units.push_back(units_->Get(handle));
+    }
+    return units;
+}
+
+const UnitInfo* UnitGroup::GetClosest(const sc2::Point2D & point) const
+{
+    const UnitInfo* closest_unit = nullptr;
+    float closest_distance = std::numeric_limits<float>::max();
+
+    for (const UnitHandle & handle : handles_)
+    {
+        const UnitInfo* unit_info = units_->Get(handle);
+        const float distance = Util::DistSq(unit_info->unit->pos, point);
+        if (distance < closest_distance)
+        {
+            closest_unit = unit_info;
+            closest_distance = distance;
+        }
+    }
+
+    return closest_unit;
+}
+
+size_t UnitGroup::size() const
+{
+    return handles_.size();
+}
+
+bool UnitGroup::empty() const
+{
+    return handles_.empty();
+}
+
+UnitGroup::const_iterator UnitGroup::begin() const
+{
+    return const_iterator(handles_.begin(), units_);
+}
+
+UnitGroup::const_iterator UnitGroup::end() const
+{
+    return const_iterator(handles_.end(), units_);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+#include "information/UnitSlotMap.h"
+
+// A list of units from one UnitSlotMap that is cheap to add to, remove from and loop over.
+// Removing swaps the last unit into the hole, so the order is not kept.
+// Don't change a group while looping over it. Copy GetUnits() first if the loop sets jobs.
+class UnitGroup
+{
+    const UnitSlotMap *         units_;
+    std::vector<UnitHandle>     handles_;
+    // Where each slot of the slot map is in handles_, or -1 if it isn't in this group.
+    std::vector<int>            position_;
+
+public:
+
+    // Loops over the group like a container of const UnitInfo*.
+    class const_iterator
+    {
+        std::vector<UnitHandle>::const_iterator it_;
+        const UnitSlotMap *                     units_;
+
+    public:
+        const_iterator(std::vector<UnitHandle>::const_iterator it, const UnitSlotMap * units) : it_(it), units_(units) {}
+        const UnitInfo * operator*() const          { return units_->Get(*it_); }
+        const_iterator & operator++()               { ++it_; return *this; }
+        bool operator==(const const_iterator & rhs) const { return it_ == rhs.it_; }
+        bool operator!=(const const_iterator & rhs) const { return it_ != rhs.it_; }
+    };
+
+    UnitGroup(const UnitSlotMap & units);
+
+    void Insert(const UnitHandle & handle);
+    void Erase(const UnitHandle & handle);
+    bool Contains(const UnitHandle & handle) const;
+
+    // A copy of the list, but not of the units. The UnitInfo pointers are only good for the current frame:
+    // UnitInfoManager adds and removes units at the start of every frame, which moves them around in the slot map.
+    // Don't keep them across frames, keep the tags or handles instead.
+    std::vector<const UnitInfo*> GetUnits() const;
+
+    // nullptr if the group is empty.
+    const UnitInfo* GetClosest(const sc2::Point2D & point) const;
+
+    // So the group can be used like the std::set it replaced.
+    size_t size() const;
+    bool empty() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+};
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <sstream>
 
 #include "ByunJRBot.h"
@@ -14,7 +15,23 @@ UnitInfoManager::UnitInfoManager(ByunJRBot & bot)
 
 void UnitInfoManager::OnStart()
 {
-
+    // Cells a bit bigger than most attack ranges. Most queries only end up looking at a handful of cells.
+    const sc2::GameInfo & game_info = bot_.Observation()->GetGameInfo();
+    unit_grids_[PlayerArrayIndex::Self].Reset(game_info.width, game_info.height, 8.0f);
+    unit_grids_[PlayerArrayIndex::Enemy].Reset(game_info.width, game_info.height, 8.0f);
+    unit_grids_[PlayerArrayIndex::Neutral].Reset(game_info.width, game_info.height, 8.0f);
+    unit_arrays_[PlayerArrayIndex::Self];
+    unit_arrays_[PlayerArrayIndex::Enemy];
+    unit_arrays_[PlayerArrayIndex::Neutral];
+    unit_clusters_[PlayerArrayIndex::Self];
+    unit_clusters_[PlayerArrayIndex::Enemy];
+
+    const size_t num_unit_types = bot_.Observation()->GetUnitTypeData().size();
+    for (int player = 0; player < 3; ++player)
+    {
+        unit_type_count_[player].assign(num_unit_types, 0);
+        completed_unit_type_count_[player].assign(num_unit_types, 0);
+    }
 }
 
 void UnitInfoManager::OnFrame()
@@ -34,18 +51,141 @@ void UnitInfoManager::OnUnitDestroyed(const sc2::Unit* unit)
 }
 
 
+void UnitInfoManager::AddUnitEvent(const UnitEventType type, const UnitSnapshot & snapshot, const sc2::Tag tag, const sc2::UnitTypeID previous_type)
+{
+    const UnitEvent unit_event = { type, tag, snapshot.unit, snapshot.player, previous_type };
+    unit_events_.push_back(unit_event);
+}
+
+void UnitInfoManager::CountUnit(const UnitSnapshot & snapshot, const int amount)
+{
+    const int player = static_cast<int>(snapshot.player);
+    const size_t type = static_cast<uint32_t>(snapshot.type);
+    const int completed = snapshot.build_progress == 1.0f ? amount : 0;
+    unit_type_count_[player][0] += amount;
+    completed_unit_type_count_[player][0] += completed;
+    if (type < unit_type_count_[player].size())
+    {
+        unit_type_count_[player][type] += amount;
+        completed_unit_type_count_[player][type] += completed;
+    }
+}
+
+// Compare what we see with what we saw last frame. Only the units that actually changed get their UnitInfo
+// rewritten, and the unit counts and grids only get touched when something happened to them.
 void UnitInfoManager::UpdateUnitInfo()
 {
+    const uint32_t game_loop = bot_.Observation()->GetGameLoop();
+    bool grid_changed[3] = { false, false, false };
+    bool arrays_changed[3] = { false, false, false };
+
+    unit_events_.clear();
     units_[PlayerArrayIndex::Self].clear();
     units_[PlayerArrayIndex::Enemy].clear();
+    units_[PlayerArrayIndex::Neutral].clear();
 
     for (auto & unit : bot_.Observation()->GetUnits())
     {
-        if (Util::GetPlayer(unit) == PlayerArrayIndex::Self || Util::GetPlayer(unit) == PlayerArrayIndex::Enemy)
+        const PlayerArrayIndex player = Util::GetPlayer(unit);
+        if (player == PlayerArrayIndex::Error)
+        {
+            continue;
+        }
+
+        // Minerals, geysers and rocks. We don't keep UnitInfo for those, but they still go in the grid.
+        units_[player].push_back(unit);
+        const bool has_unit_info = player != PlayerArrayIndex::Neutral;
+
+        const sc2::Point2D pos(unit->pos.x, unit->pos.y);
+        const auto it = snapshots_.find(unit->tag);
+        if (it == snapshots_.end())
+        {
+            const UnitSnapshot snapshot = { unit, player, unit->unit_type, pos, unit->health, unit->shield, unit->build_progress, game_loop };
+            snapshots_[unit->tag] = snapshot;
+            AddUnitEvent(UnitEventType::Created, snapshot, unit->tag, unit->unit_type);
+            CountUnit(snapshot, 1);
+            grid_changed[static_cast<int>(player)] = true;
+            arrays_changed[static_cast<int>(player)] = true;
+            if (has_unit_info) UpdateUnit(unit);
+            continue;
+        }
+
+        UnitSnapshot & snapshot = it->second;
+        snapshot.last_seen_game_loop = game_loop;
+
+        const bool changed = snapshot.unit != unit || snapshot.type != unit->unit_type || snapshot.pos != pos
+                          || snapshot.health != unit->health || snapshot.shield != unit->shield || snapshot.build_progress != unit->build_progress;
+        if (!changed)
+        {
+            continue;
+        }
+
+        arrays_changed[static_cast<int>(player)] = true;
+        const sc2::UnitTypeID previous_type = snapshot.type;
+        const bool was_completed = snapshot.build_progress == 1.0f;
+        const bool moved = snapshot.unit != unit
+                        || static_cast<int>(snapshot.pos.x) != static_cast<int>(pos.x) || static_cast<int>(snapshot.pos.y) != static_cast<int>(pos.y);
+        const bool damaged = unit->health + unit->shield < snapshot.health + snapshot.shield;
+
+        // Take the unit out of the counts the way it was and put it back the way it is now.
+        CountUnit(snapshot, -1);
+        snapshot.unit = unit;
+        snapshot.type = unit->unit_type;
+        snapshot.pos = pos;
+        snapshot.health = unit->health;
+        snapshot.shield = unit->shield;
+        snapshot.build_progress = unit->build_progress;
+        CountUnit(snapshot, 1);
+
+        if (snapshot.type != previous_type) AddUnitEvent(UnitEventType::TypeChanged, snapshot, unit->tag, previous_type);
+        if (!was_completed && snapshot.build_progress == 1.0f) AddUnitEvent(UnitEventType::Completed, snapshot, unit->tag, snapshot.type);
+        if (damaged) AddUnitEvent(UnitEventType::Damaged, snapshot, unit->tag, snapshot.type);
+        if (moved)
+        {
+            AddUnitEvent(UnitEventType::Moved, snapshot, unit->tag, snapshot.type);
+            grid_changed[static_cast<int>(player)] = true;
+        }
+
+        if (has_unit_info) UpdateUnit(unit);
+    }
+
+    // Anything we didn't see this frame is gone, dead or out of vision.
+    for (auto it = snapshots_.begin(); it != snapshots_.end();)
+    {
+        if (it->second.last_seen_game_loop == game_loop)
         {
-            UpdateUnit(unit);
-            units_[Util::GetPlayer(unit)].push_back(unit);
-        }        
+            ++it;
+            continue;
+        }
+
+        AddUnitEvent(UnitEventType::Destroyed, it->second, it->first, it->second.type);
+        CountUnit(it->second, -1);
+        grid_changed[static_cast<int>(it->second.player)] = true;
+        arrays_changed[static_cast<int>(it->second.player)] = true;
+        it = snapshots_.erase(it);
+    }
+
+    // Nothing came, went or changed tiles, so the old grid is still right.
+    if (grid_changed[static_cast<int>(PlayerArrayIndex::Self)])    unit_grids_[PlayerArrayIndex::Self].Build(units_[PlayerArrayIndex::Self]);
+    if (grid_changed[static_cast<int>(PlayerArrayIndex::Enemy)])   unit_grids_[PlayerArrayIndex::Enemy].Build(units_[PlayerArrayIndex::Enemy]);
+    if (grid_changed[static_cast<int>(PlayerArrayIndex::Neutral)]) unit_grids_[PlayerArrayIndex::Neutral].Build(units_[PlayerArrayIndex::Neutral]);
+
+    if (arrays_changed[static_cast<int>(PlayerArrayIndex::Self)])    unit_arrays_[PlayerArrayIndex::Self].Build(units_[PlayerArrayIndex::Self], bot_.UnitTypes());
+    if (arrays_changed[static_cast<int>(PlayerArrayIndex::Enemy)])   unit_arrays_[PlayerArrayIndex::Enemy].Build(units_[PlayerArrayIndex::Enemy], bot_.UnitTypes());
+    if (arrays_changed[static_cast<int>(PlayerArrayIndex::Neutral)]) unit_arrays_[PlayerArrayIndex::Neutral].Build(units_[PlayerArrayIndex::Neutral], bot_.UnitTypes());
+
+    // Cluster membership only changes when units change tiles, same as the grid it's built from. Health and centers change every frame.
+    // Neutral units don't have armies.
+    for (const PlayerArrayIndex player : { PlayerArrayIndex::Self, PlayerArrayIndex::Enemy })
+    {
+        if (grid_changed[static_cast<int>(player)])
+        {
+            unit_clusters_[player].Update(units_[player], unit_grids_[player], bot_.UnitTypes(), game_loop);
+        }
+        else
+        {
+            unit_clusters_[player].Refresh(bot_.UnitTypes(), game_loop);
+        }
     }
 
     // remove bad enemy units
@@ -53,7 +193,7 @@ void UnitInfoManager::UpdateUnitInfo()
     unit_data_[PlayerArrayIndex::Enemy].RemoveBadUnits();
 }
 
-const std::map<sc2::Tag, UnitInfo>& UnitInfoManager::GetUnitInfoMap(const PlayerArrayIndex player) const
+const UnitSlotMap & UnitInfoManager::GetUnitInfoMap(const PlayerArrayIndex player) const
 {
     return GetUnitData(player).GetUnitInfoMap();
 }
@@ -65,6 +205,32 @@ const std::vector<const sc2::Unit*>& UnitInfoManager::GetUnits(PlayerArrayIndex
     return units_.at(player);
 }
 
+const UnitGrid & UnitInfoManager::GetUnitGrid(const PlayerArrayIndex player) const
+{
+    BOT_ASSERT(unit_grids_.find(player) != unit_grids_.end(), "Couldn't find player unit grid: %d", player);
+
+    return unit_grids_.at(player);
+}
+
+const UnitArrays & UnitInfoManager::GetUnitArrays(const PlayerArrayIndex player) const
+{
+    BOT_ASSERT(unit_arrays_.find(player) != unit_arrays_.end(), "Couldn't find player unit arrays: %d", player);
+
+    return unit_arrays_.at(player);
+}
+
+const UnitClusters & UnitInfoManager::GetUnitClusters(const PlayerArrayIndex player) const
+{
+    BOT_ASSERT(unit_clusters_.find(player) != unit_clusters_.end(), "Couldn't find player unit clusters: %d", player);
+
+    return unit_clusters_.at(player);
+}
+
+const std::vector<UnitEvent> & UnitInfoManager::GetUnitEvents() const
+{
+    return unit_events_;
+}
+
 std::string GetAbilityText(const sc2::AbilityID ability_id) {
     std::string str;
     str += sc2::AbilityTypeToName(ability_id);
@@ -191,17 +357,11 @@ void UnitInfoManager::DrawSelectedUnitDebugInfo() const
 // passing in a unit type of 0 returns a count of all units
 size_t UnitInfoManager::GetUnitTypeCount(const PlayerArrayIndex player, const sc2::UnitTypeID type, const bool include_incomplete_buildings) const
 {
-    size_t count = 0;
+    BOT_ASSERT(player == PlayerArrayIndex::Self || player == PlayerArrayIndex::Enemy || player == PlayerArrayIndex::Neutral, "invalid player for GetUnitTypeCount");
 
-    for (auto & unit : GetUnits(player))
-    {
-        if ((!type || type == unit->unit_type) && (include_incomplete_buildings || unit->build_progress == 1.0f))
-        {
-            count++;
-        }
-    }
-
-    return count;
+    const std::vector<size_t> & counts = include_incomplete_buildings ? unit_type_count_[static_cast<int>(player)] : completed_unit_type_count_[static_cast<int>(player)];
+    const size_t index = type;
+    return index < counts.size() ? counts[index] : 0;
 }
 
 void UnitInfoManager::DrawUnitInformation() const
@@ -226,10 +386,10 @@ void UnitInfoManager::DrawUnitInformation() const
         }
     }
     
-    for (auto & kv : GetUnitData(PlayerArrayIndex::Enemy).GetUnitInfoMap())
+    for (auto & ui : GetUnitData(PlayerArrayIndex::Enemy).GetUnitInfoMap())
     {
-        bot_.Debug()->DebugSphereOut(kv.second.lastPosition, 0.5f);
-        bot_.Debug()->DebugTextOut(sc2::UnitTypeToName(kv.second.type), kv.second.lastPosition);
+        bot_.Debug()->DebugSphereOut(ui.lastPosition, 0.5f);
+        bot_.Debug()->DebugTextOut(sc2::UnitTypeToName(ui.type), ui.lastPosition);
     }
 }
 
@@ -245,13 +405,13 @@ void UnitInfoManager::SetJob(const sc2::Unit* unit, const UnitMission job, const
 }
 
 // This can only return your workers, not the enemy workers. 
-std::set<const UnitInfo*> UnitInfoManager::GetWorkers()
+const UnitGroup & UnitInfoManager::GetWorkers()
 {
     return unit_data_[PlayerArrayIndex::Self].GetWorkers();
 }
 
 // This can only return your scouts, not the enemy scouts. 
-std::set<const UnitInfo*> UnitInfoManager::GetScouts()
+const UnitGroup & UnitInfoManager::GetScouts()
 {
     return unit_data_[PlayerArrayIndex::Self].GetScouts();
 }
@@ -260,7 +420,7 @@ const UnitInfo* UnitInfoManager::GetUnitInfo(const sc2::Unit* unit)
 {
     // Once a unit is killed, there is no longer a UnitInfo to go with it. 
     if (!unit->is_alive) return nullptr;
-    return &unit_data_[Util::GetPlayer(unit)].GetUnitInfoMap().at(unit->tag);
+    return unit_data_[Util::GetPlayer(unit)].GetUnitInfoMap().Find(unit->tag);
 }
 
 void UnitInfoManager::UpdateUnit(const sc2::Unit* unit)
@@ -302,9 +462,8 @@ void UnitInfoManager::GetNearbyForce(std::vector<UnitInfo> & unit_info, sc2::Poi
 {
     bool has_bunker = false;
     // for each unit we know about for that player
-    for (const auto & kv : GetUnitData(player).GetUnitInfoMap())
+    for (const UnitInfo & ui : GetUnitData(player).GetUnitInfoMap())
     {
-        const UnitInfo & ui(kv.second);
 
         // if it's a combat unit we care about
         // and it's finished! 
@@ -324,11 +483,17 @@ const UnitData & UnitInfoManager::GetUnitData(const PlayerArrayIndex player) con
 
 // getCombatUnits only has any meaning for your own units. 
 // unitData does not publicly expose this function to prevent accidental requsting of the set of enemy combat units. 
-std::set<const UnitInfo*> UnitInfoManager::GetCombatUnits() const
+const UnitGroup & UnitInfoManager::GetCombatUnits() const
 {
     return GetUnitData(PlayerArrayIndex::Self).GetCombatUnits();
 }
 
+// Only our own units have missions.
+const UnitGroup & UnitInfoManager::GetUnitsWithMission(const UnitMission mission) const
+{
+    return GetUnitData(PlayerArrayIndex::Self).GetUnitsWithMission(mission);
+}
+
 int UnitInfoManager::GetNumRepairWorkers(const sc2::Unit* unit) const
 {
     return GetUnitData(PlayerArrayIndex::Self).GetNumRepairWorkers(unit);
@@ -1,18 +1,49 @@
 #pragma once
+#include <unordered_map>
 #include <sc2api/sc2_api.h>
 
 #include "macro/WorkerManager.h"
+#include "information/UnitArrays.h"
+#include "information/UnitClusters.h"
 #include "information/UnitData.h"
+#include "information/UnitEvent.h"
+#include "information/UnitGrid.h"
 
 class ByunJRBot;
 class UnitInfoManager 
 {
+    // What a unit looked like the last time we saw it. Only used to work out the UnitEvents.
+    struct UnitSnapshot
+    {
+        const sc2::Unit*    unit;
+        PlayerArrayIndex    player;
+        sc2::UnitTypeID     type;
+        sc2::Point2D        pos;
+        float               health;
+        float               shield;
+        float               build_progress;
+        uint32_t            last_seen_game_loop;
+    };
+
     ByunJRBot &              bot_;
 
     std::map<PlayerArrayIndex, UnitData> unit_data_;
 
     std::map<PlayerArrayIndex, std::vector<const sc2::Unit*>> units_;
+    std::map<PlayerArrayIndex, UnitGrid> unit_grids_;
+    std::map<PlayerArrayIndex, UnitArrays> unit_arrays_;
+    std::map<PlayerArrayIndex, UnitClusters> unit_clusters_;
+
+    std::unordered_map<sc2::Tag, UnitSnapshot> snapshots_;
+    std::vector<UnitEvent>  unit_events_;
+
+    // How many units of each type every player has, indexed by UnitTypeID. Index 0 is the total.
+    // Kept up to date from the UnitEvents. Index with static_cast<int>(PlayerArrayIndex).
+    std::vector<size_t>     unit_type_count_[3];
+    std::vector<size_t>     completed_unit_type_count_[3];
 
+    void                    AddUnitEvent(UnitEventType type, const UnitSnapshot & snapshot, sc2::Tag tag, sc2::UnitTypeID previous_type);
+    void                    CountUnit(const UnitSnapshot & snapshot, int amount);
     void                    UpdateUnit(const sc2::Unit* unit);
     void                    UpdateUnitInfo();
     bool                    IsValidUnit(const sc2::Unit* unit);
@@ -30,21 +61,31 @@ public:
     void                    OnUnitDestroyed(const sc2::Unit* unit);
 
     const std::vector<const sc2::Unit*>& GetUnits(PlayerArrayIndex player) const;
+    // Use this instead of looping through GetUnits when looking for something close by.
+    // Only rebuilt on frames where that player's units showed up, disappeared or moved to another tile.
+    const UnitGrid &        GetUnitGrid(PlayerArrayIndex player) const;
+    // Same units as GetUnits, one flat array per field. Rebuilt on frames where any of that player's units changed.
+    const UnitArrays &      GetUnitArrays(PlayerArrayIndex player) const;
+    // Self and Enemy units (not buildings) grouped into armies. Updated on the same frames as the grid.
+    const UnitClusters &    GetUnitClusters(PlayerArrayIndex player) const;
+    // Everything that changed this frame, for every player including neutral.
+    const std::vector<UnitEvent> & GetUnitEvents() const;
 
-    size_t                  GetUnitTypeCount(PlayerArrayIndex player, sc2::UnitTypeID type, bool completed = true) const;
+    size_t                  GetUnitTypeCount(PlayerArrayIndex player, sc2::UnitTypeID type, bool include_incomplete_buildings = true) const;
 
     void                    GetNearbyForce(std::vector<UnitInfo>& unit_info, sc2::Point2D p, PlayerArrayIndex player, float radius) const;
 
-    const std::map<sc2::Tag, UnitInfo>& GetUnitInfoMap(PlayerArrayIndex player) const;
+    const UnitSlotMap &     GetUnitInfoMap(PlayerArrayIndex player) const;
 
     //bool                  enemyHasCloakedUnits() const;
     void                    DrawUnitInformation() const;
     int GetNumAssignedWorkers(const sc2::Unit* depot);
     void SetJob(const sc2::Unit* unit, const UnitMission job, const sc2::Unit* mission_target=nullptr);
-    std::set<const UnitInfo*> GetWorkers();
-    std::set<const UnitInfo*> GetScouts();
+    const UnitGroup & GetWorkers();
+    const UnitGroup & GetScouts();
     const UnitInfo* GetUnitInfo(const sc2::Unit* unit);
-    std::set<const UnitInfo*> GetCombatUnits() const;
+    const UnitGroup & GetCombatUnits() const;
+    const UnitGroup & GetUnitsWithMission(UnitMission mission) const;
     int GetNumRepairWorkers(const sc2::Unit* unit) const;
     int GetNumDepots(PlayerArrayIndex self) const;
     size_t UnitsInProductionOfType(sc2::UnitTypeID unit_type) const;
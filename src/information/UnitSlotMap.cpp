@@ -0,0 +1,112 @@
+#include "information/UnitSlotMap.h"
+
+UnitInfo & UnitSlotMap::Insert(const sc2::Tag tag)
+{
+    const auto it = handles_.find(tag);
+    if (it != handles_.end())
+    {
+        return units_[slots_[it->second.index].dense_index];
+    }
+
+    uint32_t slot_index;
+    if (!free_slots_.empty())
+    {
+        slot_index = free_slots_.back();
+        free_slots_.pop_back();
+    }
+    else
+    {
+        slot_index = static_cast<uint32_t>(slots_.size());
+        Slot slot = { 0, 0 };
+        slots_.push_back(slot);
+    }
+
+    Slot & slot = slots_[slot_index];
+    slot.dense_index = static_cast<uint32_t>(units_.size());
+    ++slot.generation;
+
+    UnitHandle handle;
+    handle.index = slot_index;
+    handle.generation = slot.generation;
+    handles_[tag] = handle;
+
+    units_.push_back(UnitInfo());
+    unit_slots_.push_back(slot_index);
+    return units_.back();
+}
+
+void UnitSlotMap::Erase(const sc2::Tag tag)
+{
+    const auto it = handles_.find(tag);
+    if (it == handles_.end())
+    {
+        return;
+    }
+
+    Slot & slot = slots_[it->second.index];
+    const uint32_t hole = slot.dense_index;
+    const uint32_t last = static_cast<uint32_t>(units_.size() - 1);
+
+    // Fill the hole with the last unit so the array stays packed.
+    if (hole != last)
+    {
+        units_[hole] = units_[last];
+        unit_slots_[hole] = unit_slots_[last];
+        slots_[unit_slots_[hole]].dense_index = hole;
+    }
+    units_.pop_back();
+    unit_slots_.pop_back();
+
+    // Bumping the generation is what makes old handles to this slot stop working.
+    ++slot.generation;
+    free_slots_.push_back(it->second.index);
+    handles_.erase(it);
+}
+
+UnitInfo * UnitSlotMap::Find(const sc2::Tag tag)
+{
+    const auto it = handles_.find(tag);
+    return it == handles_.end() ? nullptr : &units_[slots_[it->second.index].dense_index];
+}
+
+const UnitInfo * UnitSlotMap::Find(const sc2::Tag tag) const
+{
+    const auto it = handles_.find(tag);
+    return it == handles_.end() ? nullptr : &units_[slots_[it->second.index].dense_index];
+}
+
+UnitHandle UnitSlotMap::GetHandle(const sc2::Tag tag) const
+{
+    const auto it = handles_.find(tag);
+    return it == handles_.end() ? UnitHandle() : it->second;
+}
+
+bool UnitSlotMap::IsValid(const UnitHandle & handle) const
+{
+    return handle.index < slots_.size() && slots_[handle.index].generation == handle.generation && handle.generation % 2 == 1;
+}
+
+const UnitInfo * UnitSlotMap::Get(const UnitHandle & handle) const
+{
+    return IsValid(handle) ? &units_[slots_[handle.index].dense_index] : nullptr;
+}
+
+size_t UnitSlotMap::size() const
+{
+    return units_.size();
+}
+
+bool UnitSlotMap::empty() const
+{
+    return units_.empty();
+}
+
+std::vector<UnitInfo>::const_iterator UnitSlotMap::begin() const
+{
+    return units_.begin();
+}
+
+std::vector<UnitInfo>::const_iterator UnitSlotMap::end() const
+{
+    return units_.end();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+#include "information/UnitInfo.h"
+
+// Refers to a UnitInfo in a UnitSlotMap. Unlike a pointer, it can't dangle:
+// once the unit is erased, looking the handle up returns nullptr, even if the slot has been reused since.
+struct UnitHandle
+{
+    uint32_t    index;
+    uint32_t    generation;
+
+    UnitHandle()
+        : index(0)
+        , generation(0)
+    {
+
+    }
+};
+
+// All the UnitInfo of one player, packed together in one array so looping over them is fast.
+// Erasing moves the last UnitInfo into the hole, so UnitInfo pointers are only good until the next Insert or Erase.
+// Keep a UnitHandle (or the tag) if you need to hold on to a unit for longer than that.
+class UnitSlotMap
+{
+    struct Slot
+    {
+        uint32_t    dense_index;
+        uint32_t    generation;     // odd while the slot is in use, even while it is free
+    };
+
+    std::vector<UnitInfo>                       units_;
+    std::vector<uint32_t>                       unit_slots_;    // same order as units_
+    std::vector<Slot>                           slots_;
+    std::vector<uint32_t>                       free_slots_;
+    std::unordered_map<sc2::Tag, UnitHandle>    handles_;
+
+public:
+
+    // Returns the existing unit if the tag is already in the map.
+    UnitInfo &          Insert(sc2::Tag tag);
+    void                Erase(sc2::Tag tag);
+
+    // nullptr if there is no unit with this tag.
+    UnitInfo *          Find(sc2::Tag tag);
+    const UnitInfo *    Find(sc2::Tag tag) const;
+
+    // A handle with generation 0 if there is no unit with this tag. Those never point at anything.
+    UnitHandle          GetHandle(sc2::Tag tag) const;
+
+    // nullptr if the unit has been erased.
+    const UnitInfo *    Get(const UnitHandle & handle) const;
+    bool                IsValid(const UnitHandle & handle) const;
+
+    size_t              size() const;
+    bool                empty() const;
+    std::vector<UnitInfo>::const_iterator begin() const;
+    std::vector<UnitInfo>::const_iterator end() const;
+};
@@ -0,0 +1,69 @@
+#include <algorithm>
+
+#include "information/UnitTypeTable.h"
+#include "util/Util.h"
+
+void UnitTypeTable::Build(const sc2::ObservationInterface* observation)
+{
+    const sc2::UnitTypes & unit_types = observation->GetUnitTypeData();
+    const sc2::Abilities & abilities = observation->GetAbilityData();
+
+    traits_.assign(unit_types.size(), UnitTypeTraits());
+    for (size_t i = 0; i < unit_types.size(); ++i)
+    {
+        const sc2::UnitTypeData & data = unit_types[i];
+        const sc2::UnitTypeID type = static_cast<uint32_t>(i);
+        UnitTypeTraits & traits = traits_[i];
+
+        for (const sc2::Weapon & weapon : data.weapons)
+        {
+            const bool hits_ground = weapon.type == sc2::Weapon::TargetType::Ground || weapon.type == sc2::Weapon::TargetType::Any;
+            const bool hits_air = weapon.type == sc2::Weapon::TargetType::Air || weapon.type == sc2::Weapon::TargetType::Any;
+            const float dps = weapon.speed > 0.0f ? weapon.damage_ * weapon.attacks / weapon.speed : 0.0f;
+
+            traits.max_range = std::max(traits.max_range, weapon.range);
+            traits.max_damage = std::max(traits.max_damage, weapon.damage_ * weapon.attacks);
+            traits.hit_damage = std::max(traits.hit_damage, weapon.damage_);
+            if (hits_ground)
+            {
+                traits.ground_range = std::max(traits.ground_range, weapon.range);
+                traits.ground_dps = std::max(traits.ground_dps, dps);
+                traits.can_attack_ground = true;
+            }
+            if (hits_air)
+            {
+                traits.air_range = std::max(traits.air_range, weapon.range);
+                traits.air_dps = std::max(traits.air_dps, dps);
+                traits.can_attack_air = true;
+            }
+        }
+
+        traits.movement_speed = data.movement_speed;
+        traits.armor = data.armor;
+        traits.mineral_cost = data.mineral_cost;
+        traits.gas_cost = data.vespene_cost;
+        traits.build_ability = Util::UnitTypeIDToAbilityID(type);
+
+        // Buildings are square, the footprint comes from the ability that builds them.
+        const size_t ability = static_cast<uint32_t>(traits.build_ability);
+        if (ability != 0 && ability < abilities.size())
+        {
+            traits.width = static_cast<int>(2 * abilities[ability].footprint_radius);
+            traits.height = traits.width;
+        }
+
+        traits.is_building = Util::IsBuilding(type);
+        traits.is_worker = Util::IsWorkerType(type);
+        traits.is_combat_unit = Util::IsCombatUnitType(type);
+        traits.is_detector = Util::IsDetectorType(type);
+        traits.is_town_hall = Util::IsTownHallType(type);
+        traits.is_refinery = Util::IsRefineryType(type);
+        traits.is_supply_provider = Util::IsSupplyProviderType(type);
+    }
+}
+
+const UnitTypeTraits & UnitTypeTable::Get(const sc2::UnitTypeID & type) const
+{
+    const size_t index = static_cast<uint32_t>(type);
+    return index < traits_.size() ? traits_[index] : unknown_;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+// Everything we keep asking about a unit type, worked out once at the start of the game.
+struct UnitTypeTraits
+{
+    float               ground_range;
+    float               air_range;
+    float               max_range;
+    float               ground_dps;       // against a target with no armor
+    float               air_dps;
+    float               max_damage;       // damage * attacks of the strongest weapon
+    float               hit_damage;       // damage of a single hit of the strongest weapon, what armor gets taken off
+    float               movement_speed;
+    float               armor;
+    int                 width;            // building footprint in tiles, 0 for units
+    int                 height;
+    int                 mineral_cost;
+    int                 gas_cost;
+    sc2::AbilityID      build_ability;
+    bool                is_building;
+    bool                is_worker;
+    bool                is_combat_unit;
+    bool                is_detector;
+    bool                is_town_hall;
+    bool                is_refinery;
+    bool                is_supply_provider;
+    bool                can_attack_ground;
+    bool                can_attack_air;
+
+    // Defined in the header so the combat simulator can be benchmarked without linking the rest of the bot.
+    UnitTypeTraits()
+        : ground_range(0.0f)
+        , air_range(0.0f)
+        , max_range(0.0f)
+        , ground_dps(0.0f)
+        , air_dps(0.0f)
+        , max_damage(0.0f)
+        , hit_damage(0.0f)
+        , movement_speed(0.0f)
+        , armor(0.0f)
+        , width(0)
+        , height(0)
+        , mineral_cost(0)
+        , gas_cost(0)
+        , build_ability(0)
+        , is_building(false)
+        , is_worker(false)
+        , is_combat_unit(false)
+        , is_detector(false)
+        , is_town_hall(false)
+        , is_refinery(false)
+        , is_supply_provider(false)
+        , can_attack_ground(false)
+        , can_attack_air(false)
+    {
+
+    }
+};
+
+// One UnitTypeTraits for every UnitTypeID, so the hot loops don't go through the observation
+// (and walk the weapon vectors) every time they need a range or a cost.
+class UnitTypeTable
+{
+    std::vector<UnitTypeTraits> traits_;
+    UnitTypeTraits              unknown_;
+
+public:
+
+    void Build(const sc2::ObservationInterface* observation);
+
+    // Types we have never heard of get a table entry full of zeroes.
+    const UnitTypeTraits & Get(const sc2::UnitTypeID & type) const;
+};
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <cmath>
+
+#include "macro/BaseLayoutPlanner.h"
+
+namespace
+{
+    // Production slots are the 3x3 building plus the 2x2 add-on on its right.
+    const int production_width = 5;
+    const int production_height = 3;
+
+    // Four depots packed together, with lanes around the whole cluster instead of every depot.
+    const int depot_cluster_size = 4;
+
+    // How far a ramp has to be from anything we plan, so the wall has room.
+    const int ramp_keep_out_radius = 4;
+
+    // Only look this far (in walk distance tiles) from a base when planning its buildings.
+    const int max_main_base_tiles = 2500;
+}
+
+BaseLayoutPlanner::BaseLayoutPlanner()
+    : ready_(false)
+{
+    first_free_[0] = 0;
+    first_free_[1] = 0;
+}
+
+BaseLayoutPlanner::~BaseLayoutPlanner()
+{
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+void BaseLayoutPlanner::Start(const LayoutPlannerInput & input)
+{
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+
+    ready_ = false;
+    input_ = input;
+    thread_ = std::thread(&BaseLayoutPlanner::Plan, this);
+}
+
+bool BaseLayoutPlanner::IsReady() const
+{
+    return ready_;
+}
+
+int BaseLayoutPlanner::Index(const int x, const int y) const
+{
+    return x * input_.height + y;
+}
+
+// Every tile is buildable, not already planned and on the same level as the base.
+bool BaseLayoutPlanner::IsRectPlaceable(const int x1, const int y1, const int x2, const int y2, const float height) const
+{
+    if (x1 < 0 || y1 < 0 || x2 > input_.width || y2 > input_.height)
+    {
+        return false;
+    }
+
+    for (int x = x1; x < x2; ++x)
+    {
+        for (int y = y1; y < y2; ++y)
+        {
+            const int i = Index(x, y);
+            if (!input_.buildable[i] || occupied_[i] || keep_out_[i] || std::fabs(input_.terrain_height[i] - height) > 0.5f)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// No other planned block in the rectangle. Off-map tiles don't count, walls are fine to build against.
+bool BaseLayoutPlanner::IsRectFree(const int x1, const int y1, const int x2, const int y2) const
+{
+    for (int x = std::max(x1, 0); x < std::min(x2, input_.width); ++x)
+    {
+        for (int y = std::max(y1, 0); y < std::min(y2, input_.height); ++y)
+        {
+            if (occupied_[Index(x, y)])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void BaseLayoutPlanner::MarkRect(std::vector<char> & grid, const int x1, const int y1, const int x2, const int y2) const
+{
+    for (int x = std::max(x1, 0); x < std::min(x2, input_.width); ++x)
+    {
+        for (int y = std::max(y1, 0); y < std::min(y2, input_.height); ++y)
+        {
+            grid[Index(x, y)] = 1;
+        }
+    }
+}
+
+void BaseLayoutPlanner::Plan()
+{
+    occupied_.assign(input_.width * input_.height, 0);
+    keep_out_.assign(input_.width * input_.height, 0);
+    slots_[0].clear();
+    slots_[1].clear();
+    slot_at_position_.clear();
+
+    if (input_.bases.empty())
+    {
+        ready_ = true;
+        return;
+    }
+
+    PlanRampKeepOut();
+
+    // Production goes first, it needs the most room. Depots fill in what's left.
+    const LayoutPlannerInput::BaseInput & main_base = input_.bases[0];
+    PlanProduction(main_base, 14);
+    PlanDepotClusters(main_base, 7, 0, 30);
+
+    for (size_t i = 1; i < input_.bases.size(); ++i)
+    {
+        // Stay well away from the resources, the town hall goes between them and the cluster.
+        PlanDepotClusters(input_.bases[i], 2, 12, 20);
+    }
+
+    ready_ = true;
+}
+
+// A ramp is a walkable tile we can't build on. Leave space around the ones leading out of the main for the wall.
+void BaseLayoutPlanner::PlanRampKeepOut()
+{
+    const LayoutPlannerInput::BaseInput & main_base = input_.bases[0];
+    const float main_height = input_.terrain_height[Index(static_cast<int>(main_base.position.x), static_cast<int>(main_base.position.y))];
+
+    const size_t tiles_to_check = std::min(main_base.closest_tiles.size(), static_cast<size_t>(max_main_base_tiles));
+    for (size_t i = 0; i < tiles_to_check; ++i)
+    {
+        const sc2::Point2DI & tile = main_base.closest_tiles[i];
+        if (tile.x <= 0 || tile.y <= 0 || tile.x >= input_.width - 1 || tile.y >= input_.height - 1)
+        {
+            continue;
+        }
+
+        const int index = Index(tile.x, tile.y);
+        if (!input_.walkable[index] || input_.buildable[index] || input_.terrain_height[index] < main_height - 0.5f)
+        {
+            continue;
+        }
+
+        MarkRect(keep_out_, tile.x - ramp_keep_out_radius, tile.y - ramp_keep_out_radius, tile.x + ramp_keep_out_radius + 1, tile.y + ramp_keep_out_radius + 1);
+    }
+}
+
+void BaseLayoutPlanner::PlanProduction(const LayoutPlannerInput::BaseInput & base, const int max_slots)
+{
+    const float base_height = input_.terrain_height[Index(static_cast<int>(base.position.x), static_cast<int>(base.position.y))];
+    const int spacing = input_.spacing;
+
+    const size_t tiles_to_check = std::min(base.closest_tiles.size(), static_cast<size_t>(max_main_base_tiles));
+    for (size_t i = 0; i < tiles_to_check && static_cast<int>(slots_[static_cast<int>(LayoutSlotType::Production)].size()) < max_slots; ++i)
+    {
+        const sc2::Point2DI & center = base.closest_tiles[i];
+        LayoutSlot slot = { center, LayoutSlotType::Production, base.base, false };
+
+        int x1, y1, x2, y2;
+        GetSlotFootprint(slot, x1, y1, x2, y2);
+
+        // The lane around the block is what keeps units from getting stuck behind a row of barracks.
+        if (!IsRectPlaceable(x1, y1, x2, y2, base_height) || !IsRectFree(x1 - spacing, y1 - spacing, x2 + spacing, y2 + spacing))
+        {
+            continue;
+        }
+
+        MarkRect(occupied_, x1, y1, x2, y2);
+        slot_at_position_[Index(center.x, center.y)] = std::make_pair(static_cast<int>(LayoutSlotType::Production), slots_[static_cast<int>(LayoutSlotType::Production)].size());
+        slots_[static_cast<int>(LayoutSlotType::Production)].push_back(slot);
+    }
+}
+
+void BaseLayoutPlanner::PlanDepotClusters(const LayoutPlannerInput::BaseInput & base, const int max_clusters, const int min_distance, const int max_distance)
+{
+    const float base_height = input_.terrain_height[Index(static_cast<int>(base.position.x), static_cast<int>(base.position.y))];
+    const int spacing = input_.spacing;
+    int clusters = 0;
+
+    // Tiles are sorted by walk distance, which is never shorter than the straight line distance.
+    // Anything past a circle's worth of tiles is too far away to matter.
+    const size_t tiles_to_check = std::min(base.closest_tiles.size(), static_cast<size_t>(4 * max_distance * max_distance));
+    for (size_t i = 0; i < tiles_to_check && clusters < max_clusters; ++i)
+    {
+        const sc2::Point2DI & corner = base.closest_tiles[i];
+        const float dx = corner.x - base.position.x;
+        const float dy = corner.y - base.position.y;
+        const float distance_sq = dx * dx + dy * dy;
+        if (distance_sq < min_distance * min_distance || distance_sq > max_distance * max_distance)
+        {
+            continue;
+        }
+
+        const int x1 = corner.x;
+        const int y1 = corner.y;
+        const int x2 = corner.x + depot_cluster_size;
+        const int y2 = corner.y + depot_cluster_size;
+
+        if (!IsRectPlaceable(x1, y1, x2, y2, base_height) || !IsRectFree(x1 - spacing, y1 - spacing, x2 + spacing, y2 + spacing))
+        {
+            continue;
+        }
+
+        MarkRect(occupied_, x1, y1, x2, y2);
+
+        // Depots are 2x2 and are placed by their center.
+        for (int ox = 1; ox < depot_cluster_size; ox += 2)
+        {
+            for (int oy = 1; oy < depot_cluster_size; oy += 2)
+            {
+                const LayoutSlot slot = { sc2::Point2DI(corner.x + ox, corner.y + oy), LayoutSlotType::Depot, base.base, false };
+                slot_at_position_[Index(slot.position.x, slot.position.y)] = std::make_pair(static_cast<int>(LayoutSlotType::Depot), slots_[static_cast<int>(LayoutSlotType::Depot)].size());
+                slots_[static_cast<int>(LayoutSlotType::Depot)].push_back(slot);
+            }
+        }
+        ++clusters;
+    }
+}
+
+void BaseLayoutPlanner::GetSlotFootprint(const LayoutSlot & slot, int & x1, int & y1, int & x2, int & y2)
+{
+    if (slot.type == LayoutSlotType::Production)
+    {
+        x1 = slot.position.x - 1;
+        y1 = slot.position.y - 1;
+        x2 = x1 + production_width;
+        y2 = y1 + production_height;
+    }
+    else
+    {
+        x1 = slot.position.x - 1;
+        y1 = slot.position.y - 1;
+        x2 = x1 + 2;
+        y2 = y1 + 2;
+    }
+}
+
+const LayoutSlot* BaseLayoutPlanner::GetNextFreeSlot(const LayoutSlotType type, const std::set<const BaseLocation*> & owned_bases,
+                                                     const std::function<bool(const LayoutSlot &)> & usable) const
+{
+    if (!ready_)
+    {
+        return nullptr;
+    }
+
+    const int t = static_cast<int>(type);
+    const std::vector<LayoutSlot> & slots = slots_[t];
+
+    // Taken slots at the front never come back until something dies, so skip them for good.
+    while (first_free_[t] < slots.size() && slots[first_free_[t]].taken)
+    {
+        ++first_free_[t];
+    }
+
+    for (size_t i = first_free_[t]; i < slots.size(); ++i)
+    {
+        if (!slots[i].taken && owned_bases.find(slots[i].base) != owned_bases.end() && usable(slots[i]))
+        {
+            return &slots[i];
+        }
+    }
+
+    return nullptr;
+}
+
+const std::vector<LayoutSlot> & BaseLayoutPlanner::GetSlots(const LayoutSlotType type) const
+{
+    return slots_[static_cast<int>(type)];
+}
+
+void BaseLayoutPlanner::SetSlotTaken(const sc2::Point2DI & position, const bool taken)
+{
+    if (!ready_ || position.x < 0 || position.y < 0 || position.x >= input_.width || position.y >= input_.height)
+    {
+        return;
+    }
+
+    const auto it = slot_at_position_.find(Index(position.x, position.y));
+    if (it == slot_at_position_.end())
+    {
+        return;
+    }
+
+    const int t = it->second.first;
+    slots_[t][it->second.second].taken = taken;
+    if (!taken)
+    {
+        first_free_[t] = std::min(first_free_[t], it->second.second);
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+class BaseLocation;
+
+enum class LayoutSlotType
+{
+    Production,     // barracks, factory or starport, with room for the add-on
+    Depot
+};
+
+struct LayoutSlot
+{
+    sc2::Point2DI        position;      // where the build command is sent
+    LayoutSlotType       type;
+    const BaseLocation*  base;          // the base this slot belongs to
+    bool                 taken;
+};
+
+// Everything the planner needs to know about the map.
+// It's copied on the main thread so the planner never has to touch the bot (or the API) from another thread.
+struct LayoutPlannerInput
+{
+    struct BaseInput
+    {
+        const BaseLocation*         base;
+        sc2::Point2D                position;
+        std::vector<sc2::Point2DI>  closest_tiles;     // sorted by walk distance from the base
+    };
+
+    int                       width;
+    int                       height;
+    int                       spacing;                  // empty tiles to leave between planned blocks
+    std::vector<char>         buildable;                // buildable and not in a resource box / base footprint, indexed x * height + y
+    std::vector<char>         walkable;
+    std::vector<float>        terrain_height;
+    std::vector<BaseInput>    bases;                    // the start base must be first
+};
+
+// Plans where every production building and supply depot will go once, at the start of the game, on a background thread.
+// The main ramp is kept clear so the wall can still be built there.
+class BaseLayoutPlanner
+{
+    LayoutPlannerInput      input_;
+    std::vector<char>       occupied_;
+    std::vector<char>       keep_out_;
+
+    std::vector<LayoutSlot> slots_[2];
+    mutable size_t          first_free_[2];
+
+    // Slot lookup by build position, so ReserveTiles/FreeTiles can mark slots in O(1).
+    std::unordered_map<int, std::pair<int, size_t>> slot_at_position_;
+
+    std::thread             thread_;
+    std::atomic<bool>       ready_;
+
+    int  Index(int x, int y) const;
+    bool IsRectPlaceable(int x1, int y1, int x2, int y2, float height) const;
+    bool IsRectFree(int x1, int y1, int x2, int y2) const;
+    void MarkRect(std::vector<char> & grid, int x1, int y1, int x2, int y2) const;
+
+    void Plan();
+    void PlanRampKeepOut();
+    void PlanProduction(const LayoutPlannerInput::BaseInput & base, int max_slots);
+    void PlanDepotClusters(const LayoutPlannerInput::BaseInput & base, int max_clusters, int min_distance, int max_distance);
+
+public:
+    BaseLayoutPlanner();
+    ~BaseLayoutPlanner();
+
+    void Start(const LayoutPlannerInput & input);
+    bool IsReady() const;
+
+    // The first free slot of the given type that usable says yes to, or nullptr.
+    // Slots whose base is not one of the given bases are skipped, so we don't plan depots at bases we don't own yet.
+    const LayoutSlot* GetNextFreeSlot(LayoutSlotType type, const std::set<const BaseLocation*> & owned_bases,
+                                      const std::function<bool(const LayoutSlot &)> & usable) const;
+    const std::vector<LayoutSlot> & GetSlots(LayoutSlotType type) const;
+
+    // The footprint a slot takes up on the map, as [x1, x2) x [y1, y2).
+    static void GetSlotFootprint(const LayoutSlot & slot, int & x1, int & y1, int & x2, int & y2);
+
+    void SetSlotTaken(const sc2::Point2DI & position, bool taken);
+};
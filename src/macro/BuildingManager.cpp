@@ -386,6 +386,9 @@ std::vector<sc2::UnitTypeID> BuildingManager::BuildingsQueued() const
 sc2::Point2DI BuildingManager::GetBuildingLocation(const Building & b) const
 {
     sc2::Point2DI desired_loc;
+    const sc2::Point2DI wall_loc = b.type == sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT
+        ? bot_.Map().GetNextCoordinateToWallWithBuilding(sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT)
+        : sc2::Point2DI(0, 0);
     if (Util::IsRefineryType(b.type))
     {
         desired_loc =  bot_.InformationManager().BuildingPlacer().GetRefineryPosition();
@@ -397,9 +400,9 @@ sc2::Point2DI BuildingManager::GetBuildingLocation(const Building & b) const
     }
 
     // Make a wall if necessary.
-    else if (b.type == sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT && bot_.InformationManager().UnitInfo().GetNumDepots(PlayerArrayIndex::Self) < 3)
+    else if (wall_loc != sc2::Point2DI(0, 0))
     {
-        desired_loc = bot_.Map().GetNextCoordinateToWallWithBuilding(sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT);
+        desired_loc = wall_loc;
     }
 
     // Find the next expansion location. 
@@ -408,6 +411,16 @@ sc2::Point2DI BuildingManager::GetBuildingLocation(const Building & b) const
         const sc2::Point2D next_expansion_location = bot_.Bases().GetNextExpansion(PlayerArrayIndex::Self);
         desired_loc = sc2::Point2DI(next_expansion_location.x, next_expansion_location.y);
     }
+    // Production and depots go in the slots the base layout planned for them, once it's done planning. 
+    else if (b.type == sc2::UNIT_TYPEID::TERRAN_FACTORY || b.type == sc2::UNIT_TYPEID::TERRAN_STARPORT || b.type == sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT)
+    {
+        const sc2::Point2DI planned_loc = bot_.InformationManager().BuildingPlacer().GetPlannedLocation(b.type);
+        if (planned_loc != sc2::Point2DI(0, 0))
+        {
+            return planned_loc;
+        }
+        desired_loc = sc2::Point2DI(bot_.GetStartLocation().x, bot_.GetStartLocation().y);
+    }
     // If no special placement code is required, get a position somewhere in our starting base.
     else 
     {
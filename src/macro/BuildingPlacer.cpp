@@ -6,96 +6,183 @@
 
 BuildingPlacer::BuildingPlacer(ByunJRBot & bot)
     : bot_(bot)
+    , layout_applied_(false)
 {
 
 }
 
 void BuildingPlacer::OnStart()
 {
-    reserve_map_ = std::vector< std::vector<bool> >(bot_.Map().TrueMapWidth(), std::vector<bool>(bot_.Map().TrueMapHeight(), false));
-}
-
-void BuildingPlacer::ReserveTiles(sc2::UnitTypeID building_type, sc2::Point2DI building_location)
-{
-    // Remember to take add-ons into account!
-    int space_for_add_on = 0;
-    if (building_type == sc2::UNIT_TYPEID::TERRAN_BARRACKS || building_type == sc2::UNIT_TYPEID::TERRAN_FACTORY || building_type == sc2::UNIT_TYPEID::TERRAN_STARPORT)
-        space_for_add_on = 2;
+    placement_index_.Reset(bot_.Map().TrueMapWidth(), bot_.Map().TrueMapHeight());
 
-    const int building_width = Util::GetUnitTypeWidth(building_type, bot_) + space_for_add_on;
-    const int building_height = Util::GetUnitTypeHeight(building_type, bot_);
-    const size_t rwidth = reserve_map_.size();
-    const size_t rheight = reserve_map_[0].size();
-    for (size_t x = building_location.x; x < building_location.x + building_width && x < rwidth; x++)
+    for (int x = 0; x < bot_.Map().TrueMapWidth(); ++x)
     {
-        for (size_t y = building_location.y; y < building_location.y + building_height && y < rheight; y++)
+        for (int y = 0; y < bot_.Map().TrueMapHeight(); ++y)
         {
-            reserve_map_[x][y] = true;
+            placement_index_.MarkTile(PlacementLayer::Unbuildable, x, y, !bot_.Map().IsBuildable(x, y));
         }
     }
+
+    placement_index_.RebuildAll();
 }
 
-void BuildingPlacer::FreeTiles(sc2::UnitTypeID building_type, sc2::Point2DI building_location)
+void BuildingPlacer::IndexBaseLocations()
 {
-    // Remember to take add-ons into account!
-    int space_for_add_on = 0;
-    if (building_type == sc2::UNIT_TYPEID::TERRAN_BARRACKS || building_type == sc2::UNIT_TYPEID::TERRAN_FACTORY || building_type == sc2::UNIT_TYPEID::TERRAN_STARPORT)
-        space_for_add_on = 2;
+    const sc2::UnitTypeID town_hall = Util::GetTownHall(bot_.InformationManager().GetPlayerRace(PlayerArrayIndex::Self));
+    const int town_hall_width = Util::GetUnitTypeWidth(town_hall, bot_);
+    const int town_hall_height = Util::GetUnitTypeHeight(town_hall, bot_);
 
-    const int building_width = Util::GetUnitTypeWidth(building_type, bot_) + space_for_add_on;
-    const int building_height = Util::GetUnitTypeHeight(building_type, bot_);
+    for (const BaseLocation* base : bot_.Bases().GetBaseLocations())
+    {
+        for (int x = 0; x < placement_index_.Width(); ++x)
+        {
+            for (int y = 0; y < placement_index_.Height(); ++y)
+            {
+                if (base->IsInResourceBox(x, y))
+                {
+                    placement_index_.MarkTile(PlacementLayer::ResourceBox, x, y, true);
+                }
+            }
+        }
 
-    const int rwidth = static_cast<int>(reserve_map_.size());
-    const int rheight = static_cast<int>(reserve_map_[0].size());
+        // The footprint includes its far edge, so buildings touching the town hall spot count as overlapping it. 
+        const int bx = static_cast<int>(base->GetDepotPosition().x);
+        const int by = static_cast<int>(base->GetDepotPosition().y);
+        for (int x = bx; x <= bx + town_hall_width; ++x)
+        {
+            for (int y = by; y <= by + town_hall_height; ++y)
+            {
+                placement_index_.MarkTile(PlacementLayer::BaseFootprint, x, y, true);
+            }
+        }
+    }
 
-    for (size_t x = building_location.x; x < building_location.x + building_width && x < rwidth; x++)
+    placement_index_.RebuildAll();
+
+    // Everything the layout planner needs is copied here, it never touches the bot from its own thread.
+    LayoutPlannerInput input;
+    input.width = placement_index_.Width();
+    input.height = placement_index_.Height();
+    input.spacing = bot_.Config().BuildingSpacing;
+    input.buildable.resize(input.width * input.height);
+    input.walkable.resize(input.width * input.height);
+    input.terrain_height.resize(input.width * input.height);
+    for (int x = 0; x < input.width; ++x)
     {
-        for (size_t y = building_location.y; y < building_location.y + building_height && y < rheight; y++)
+        for (int y = 0; y < input.height; ++y)
         {
-            reserve_map_[x][y] = false;
+            const int i = x * input.height + y;
+            input.buildable[i] = !placement_index_.IsBlocked(x, y, PlacementLayer::Unbuildable | PlacementLayer::ResourceBox | PlacementLayer::BaseFootprint);
+            input.walkable[i] = bot_.Map().IsWalkable(x, y);
+            input.terrain_height[i] = bot_.Map().TerrainHeight(static_cast<float>(x), static_cast<float>(y));
         }
     }
+
+    // The main base is planned around where our first town hall actually is.
+    const BaseLocation* start_base = bot_.Bases().GetPlayerStartingBaseLocation(PlayerArrayIndex::Self);
+    const sc2::Point2DI start_tile(static_cast<int>(bot_.GetStartLocation().x), static_cast<int>(bot_.GetStartLocation().y));
+    LayoutPlannerInput::BaseInput main_base = { start_base, sc2::Point2D(start_tile.x, start_tile.y), bot_.Map().GetClosestTilesTo(start_tile) };
+    input.bases.push_back(main_base);
+
+    for (const BaseLocation* base : bot_.Bases().GetBaseLocations())
+    {
+        if (base == start_base)
+        {
+            continue;
+        }
+
+        LayoutPlannerInput::BaseInput base_input = { base, base->GetPosition(), base->GetClosestTiles() };
+        input.bases.push_back(base_input);
+    }
+
+    layout_planner_.Start(input);
 }
 
-bool BuildingPlacer::IsReserved(const int x, const int y) const
+void BuildingPlacer::OnFrame()
 {
-    const int rwidth = static_cast<int>(reserve_map_.size());
-    const int rheight = static_cast<int>(reserve_map_[0].size());
-    if (x < 0 || y < 0 || x >= rwidth || y >= rheight)
+    if (layout_applied_ || !layout_planner_.IsReady())
     {
-        return false;
+        return;
+    }
+
+    // Keep the rest of our buildings from landing in the planned slots.
+    for (const LayoutSlotType type : { LayoutSlotType::Production, LayoutSlotType::Depot })
+    {
+        for (const LayoutSlot & slot : layout_planner_.GetSlots(type))
+        {
+            int x1, y1, x2, y2;
+            BaseLayoutPlanner::GetSlotFootprint(slot, x1, y1, x2, y2);
+            for (int x = x1; x < x2; ++x)
+            {
+                for (int y = y1; y < y2; ++y)
+                {
+                    placement_index_.MarkTile(PlacementLayer::Planned, x, y, true);
+                }
+            }
+        }
     }
 
-    return reserve_map_[x][y];
+    placement_index_.RebuildAll();
+    layout_applied_ = true;
 }
 
-bool BuildingPlacer::IsInResourceBox(const int x, const int y) const
+int BuildingPlacer::GetAddOnWidth(const sc2::UnitTypeID type) const
 {
-    return bot_.Bases().GetPlayerStartingBaseLocation(PlayerArrayIndex::Self)->IsInResourceBox(x, y);
+    if (type == sc2::UNIT_TYPEID::TERRAN_BARRACKS || type == sc2::UNIT_TYPEID::TERRAN_FACTORY || type == sc2::UNIT_TYPEID::TERRAN_STARPORT)
+        return 2;
+    return 0;
 }
 
-// makes final checks to see if a building can be built at a certain location
-bool BuildingPlacer::CanBuildHere(const int bx, const int by, const sc2::UnitTypeID type) const
+void BuildingPlacer::ReserveTiles(sc2::UnitTypeID building_type, sc2::Point2DI building_location)
+{
+    // Remember to take add-ons into account!
+    const int building_width = Util::GetUnitTypeWidth(building_type, bot_) + GetAddOnWidth(building_type);
+    const int building_height = Util::GetUnitTypeHeight(building_type, bot_);
+
+    placement_index_.SetRect(PlacementLayer::Reserved, building_location.x, building_location.y,
+                             building_location.x + building_width, building_location.y + building_height, true);
+    layout_planner_.SetSlotTaken(building_location, true);
+}
+
+void BuildingPlacer::FreeTiles(sc2::UnitTypeID building_type, sc2::Point2DI building_location)
+{
+    // Remember to take add-ons into account!
+    const int building_width = Util::GetUnitTypeWidth(building_type, bot_) + GetAddOnWidth(building_type);
+    const int building_height = Util::GetUnitTypeHeight(building_type, bot_);
+
+    placement_index_.SetRect(PlacementLayer::Reserved, building_location.x, building_location.y,
+                             building_location.x + building_width, building_location.y + building_height, false);
+    layout_planner_.SetSlotTaken(building_location, false);
+}
+
+bool BuildingPlacer::IsReserved(const int x, const int y) const
 {
-    if (IsInResourceBox(by, by))
+    if (x < 0 || y < 0 || x >= placement_index_.Width() || y >= placement_index_.Height())
     {
         return false;
     }
 
-    // check the reserve map
-    for (int x = bx; x < bx + Util::GetUnitTypeWidth(type, bot_); x++)
+    return placement_index_.IsBlocked(x, y, PlacementLayer::Reserved);
+}
+
+// makes final checks to see if a building can be built at a certain location
+bool BuildingPlacer::CanBuildHere(const int bx, const int by, const sc2::UnitTypeID type) const
+{
+    const int width = Util::GetUnitTypeWidth(type, bot_);
+    const int height = Util::GetUnitTypeHeight(type, bot_);
+
+    // Refineries go on top of geysers, which are always inside a resource box. 
+    const int footprint_layers = Util::IsRefineryType(type) ? PlacementLayer::Reserved : PlacementLayer::Reserved | PlacementLayer::ResourceBox;
+
+    // check the reserve map and the resource boxes
+    if (placement_index_.IsRectBlocked(bx, by, bx + width, by + height, footprint_layers))
     {
-        for (int y = by; y < by + Util::GetUnitTypeHeight(type, bot_); y++)
-        {
-            if (!bot_.Map().IsOnMap(x, y) || reserve_map_[x][y])
-            {
-                return false;
-            }
-        }
+        return false;
     }
 
     // if it overlaps a base location return false
-    if (TileOverlapsBaseLocation(bx, by, type))
+    // if it's a resource depot we don't care if it overlaps
+    if (!Util::IsTownHallType(type) && placement_index_.IsRectBlocked(bx, by, bx + width + 1, by + height + 1, PlacementLayer::BaseFootprint))
     {
         return false;
     }
@@ -115,14 +202,13 @@ bool BuildingPlacer::CanBuildHereWithSpace(const int bx, const int by, const sc2
     // height and width of the building
     const int width  = Util::GetUnitTypeWidth(type, bot_);
     const int height = Util::GetUnitTypeHeight(type, bot_);
-
-    // TODO: make sure we leave space for add-ons. These types of units can have addons:
+    const int add_on_width = GetAddOnWidth(type);
 
     // define the rectangle of the building spot
     const int startx = bx - (width / 2) - build_dist;
     const int starty = by - (height / 2) - build_dist;
-    // endx is not const to account for add-ons. 
-    int endx   = bx + (width/2) + build_dist;
+    // Account for add-ons. One extra tile so units can still walk past the add-on.
+    const int endx   = bx + (width/2) + build_dist + (add_on_width > 0 ? add_on_width + 1 : 0);
     const int endy   = by + (height/2) + build_dist;
 
     // if this rectangle doesn't fit on the map we can't build here
@@ -131,40 +217,64 @@ bool BuildingPlacer::CanBuildHereWithSpace(const int bx, const int by, const sc2
         return false;
     }
 
-    // The starcraft 2 api will check every square on the building for us. No need to include it in the following loop. 
-    if(!Buildable(bx, by, type))
+    // Cheap check against the static terrain and the planned base layout before we bother asking the server. 
+    // Refineries sit on geysers, which are never buildable terrain. 
+    const int footprint_layers = Util::IsRefineryType(type) ? PlacementLayer::Planned : PlacementLayer::Unbuildable | PlacementLayer::Planned;
+    if (placement_index_.IsRectBlocked(bx - width / 2, by - height / 2, bx - width / 2 + width + add_on_width, by - height / 2 + height, footprint_layers))
+    {
         return false;
+    }
 
-    // Account for add-ons.
-    if( type == sc2::UNIT_TYPEID::TERRAN_BARRACKS 
-     || type == sc2::UNIT_TYPEID::TERRAN_FACTORY
-     || type == sc2::UNIT_TYPEID::TERRAN_STARPORT)
+    // Refineries can only be built in one spot, it does not matter what is next to them. 
+    // Supply depots are usually part of a wall. They have to be built flush with the buildings next to them. 
+    if (!Util::IsRefineryType(type) && type != sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT)
     {
-        endx += 3;
-
-        // Make sure there is room to build the addon. 
-        if (!Buildable(bx+3, by, type))
+        // Make sure we have space for our units to walk through. Don't let them get stuck!
+        if (placement_index_.IsRectBlocked(startx, starty, endx, endy, PlacementLayer::Reserved | PlacementLayer::Planned))
+        {
             return false;
+        }
     }
-    
-    for(int y = starty; y < endy; ++y)
+
+    // The starcraft 2 api will check every square on the building for us, including units standing in the way. 
+    // It's a round trip to the server, so it is done last. 
+    if(!Buildable(bx, by, type))
+        return false;
+
+    // Make sure there is room to build the addon. 
+    if (add_on_width > 0 && !Buildable(bx+3, by, type))
+        return false;
+
+    return true;
+}
+
+sc2::Point2DI BuildingPlacer::GetPlannedLocation(const sc2::UnitTypeID building_type) const
+{
+    LayoutSlotType slot_type;
+    if (building_type == sc2::UNIT_TYPEID::TERRAN_BARRACKS || building_type == sc2::UNIT_TYPEID::TERRAN_FACTORY || building_type == sc2::UNIT_TYPEID::TERRAN_STARPORT)
+        slot_type = LayoutSlotType::Production;
+    else if (building_type == sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT)
+        slot_type = LayoutSlotType::Depot;
+    else
+        return sc2::Point2DI(0, 0);
+
+    // The slots were checked against the terrain when they were planned. Units or creep may still be in the way of some of them,
+    // so take the first one that is clear right now instead of waiting on the first one.
+    const auto usable = [this, building_type](const LayoutSlot & slot)
     {
-        for(int x  = startx; x < endx; ++x)
+        int x1, y1, x2, y2;
+        BaseLayoutPlanner::GetSlotFootprint(slot, x1, y1, x2, y2);
+        if (placement_index_.IsRectBlocked(x1, y1, x2, y2, PlacementLayer::Reserved) || !Buildable(slot.position.x, slot.position.y, building_type))
         {
-            // Refineries can only be built in one spot, it does not matter what is next to them. 
-            // Supply depots are usually part of a wall. They have to be built flush with the buildings next to them. 
-            if (!Util::IsRefineryType(type) && type != sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT)
-            {
-                // Make sure we have space for our units to walk through. Don't let them get stuck!
-                if (reserve_map_[x][y])
-                {
-                    return false;
-                }
-            }
+            return false;
         }
-    }
 
-    return true;
+        // A depot takes up exactly the same tiles as the add-on would. 
+        return GetAddOnWidth(building_type) == 0 || Buildable(slot.position.x + 3, slot.position.y, sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT);
+    };
+
+    const LayoutSlot* slot = layout_planner_.GetNextFreeSlot(slot_type, bot_.Bases().GetOccupiedBaseLocations(PlayerArrayIndex::Self), usable);
+    return slot ? slot->position : sc2::Point2DI(0, 0);
 }
 
 sc2::Point2DI BuildingPlacer::GetBuildLocationNear(const sc2::Point2DI desired_loc, const sc2::UnitTypeID building_type, const int build_dist) const
@@ -197,43 +307,6 @@ sc2::Point2DI BuildingPlacer::GetBuildLocationNear(const sc2::Point2DI desired_l
     return sc2::Point2DI(0, 0);
 }
 
-bool BuildingPlacer::TileOverlapsBaseLocation(const int x, const int y, const sc2::UnitTypeID type) const
-{
-    // if it's a resource depot we don't care if it overlaps
-    if (Util::IsTownHallType(type))
-    {
-        return false;
-    }
-
-    // dimensions of the proposed location
-    const int tx1 = x;
-    const int ty1 = y;
-    const int tx2 = tx1 + Util::GetUnitTypeWidth(type, bot_);
-    const int ty2 = ty1 + Util::GetUnitTypeHeight(type, bot_);
-
-    // for each base location
-    for (const BaseLocation* base : bot_.Bases().GetBaseLocations())
-    {
-        // dimensions of the base location
-        const int bx1 = static_cast<int>(base->GetDepotPosition().x);
-        const int by1 = static_cast<int>(base->GetDepotPosition().y);
-        const int bx2 = bx1 + Util::GetUnitTypeWidth(Util::GetTownHall(bot_.InformationManager().GetPlayerRace(PlayerArrayIndex::Self)), bot_);
-        const int by2 = by1 + Util::GetUnitTypeHeight(Util::GetTownHall(bot_.InformationManager().GetPlayerRace(PlayerArrayIndex::Self)), bot_);
-
-        // conditions for non-overlap are easy
-        const bool no_overlap = (tx2 < bx1) || (tx1 > bx2) || (ty2 < by1) || (ty1 > by2);
-
-        // if the reverse is true, return true
-        if (!no_overlap)
-        {
-            return true;
-        }
-    }
-
-    // otherwise there is no overlap
-    return false;
-}
-
 bool BuildingPlacer::Buildable(const int x, const int y, const sc2::UnitTypeID type) const
 {
     // TODO: does this take units on the map into account?
@@ -254,14 +327,11 @@ void BuildingPlacer::DrawReservedTiles()
         return;
     }
 
-    const size_t rwidth = reserve_map_.size();
-    const size_t rheight = reserve_map_[0].size();
-
-    for (int x = 0; x < rwidth; ++x)
+    for (int x = 0; x < placement_index_.Width(); ++x)
     {
-        for (int y = 0; y < rheight; ++y)
+        for (int y = 0; y < placement_index_.Height(); ++y)
         {
-            if (reserve_map_[x][y] || IsInResourceBox(x, y))
+            if (placement_index_.IsBlocked(x, y, PlacementLayer::Reserved | PlacementLayer::ResourceBox))
             {
                 const float x1 = x+0.5;
                 const float y1 = y+0.5;
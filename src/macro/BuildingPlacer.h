@@ -1,5 +1,7 @@
 #pragma once
+#include "macro/BaseLayoutPlanner.h"
 #include "macro/Building.h"
+#include "macro/PlacementIndex.h"
 
 class ByunJRBot;
 
@@ -7,20 +9,26 @@ class BuildingPlacer
 {
     ByunJRBot & bot_;
 
-    // All the tiles that either have a building planned, or currently have a building on them. 
-    // They are only unreserved if the building dies. 
-    std::vector< std::vector<bool> > reserve_map_;
+    // Unbuildable tiles, resource boxes, base footprints and all the tiles that either have a building planned, or currently have a building on them. 
+    // Reserved tiles are only unreserved if the building dies. 
+    PlacementIndex  placement_index_;
+
+    // Slots for production buildings and depots, planned once in the background. 
+    BaseLayoutPlanner layout_planner_;
+    bool            layout_applied_;
 
     // queries for various BuildingPlacer data
     bool            Buildable(int x, int y, const sc2::UnitTypeID type) const;
-    bool            IsInResourceBox(int x, int y) const;
-    bool            TileOverlapsBaseLocation(int x, int y, sc2::UnitTypeID type) const;
+    int             GetAddOnWidth(sc2::UnitTypeID type) const;
 
 
 public:
     BuildingPlacer(ByunJRBot & bot);
 
     void OnStart();
+    // Base locations are not known until after OnStart, so their resource boxes and footprints are added separately.
+    void IndexBaseLocations();
+    void OnFrame();
 
     void            ReserveTiles(sc2::UnitTypeID building_type, sc2::Point2DI building_location);
     void            FreeTiles(sc2::UnitTypeID building_type, sc2::Point2DI building_location);
@@ -30,6 +38,8 @@ public:
     bool            CanBuildHere(int bx, int by, const sc2::UnitTypeID type) const;
     bool            CanBuildHereWithSpace(int bx, int by, const sc2::UnitTypeID type, int build_dist) const;
 
+    // Returns the first free slot from the base layout for this type of building that can be built on right now, or (0, 0) if there isn't one (yet).
+    sc2::Point2DI   GetPlannedLocation(sc2::UnitTypeID building_type) const;
     sc2::Point2DI   GetBuildLocationNear(const sc2::Point2DI desired_loc, const sc2::UnitTypeID building_type, const int build_dist) const;
 
     void            DrawReservedTiles();
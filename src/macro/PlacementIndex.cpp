@@ -0,0 +1,149 @@
+#include <algorithm>
+
+#include "macro/PlacementIndex.h"
+
+PlacementIndex::PlacementIndex()
+    : width_(0)
+    , height_(0)
+{
+
+}
+
+void PlacementIndex::Reset(const int width, const int height)
+{
+    width_ = width;
+    height_ = height;
+    tiles_.assign(width_ * height_, 0);
+    for (int layer = 0; layer < num_layers_; ++layer)
+    {
+        sums_[layer].assign((width_ + 1) * (height_ + 1), 0);
+    }
+}
+
+int PlacementIndex::TileIndex(const int x, const int y) const
+{
+    return x * height_ + y;
+}
+
+int PlacementIndex::SumIndex(const int x, const int y) const
+{
+    return x * (height_ + 1) + y;
+}
+
+// Only the entries at or above/right of the first changed tile depend on it, so that's all we recompute.
+void PlacementIndex::RebuildSums(const int layer, const int from_x, const int from_y)
+{
+    const int flag = 1 << layer;
+    std::vector<int> & sums = sums_[layer];
+
+    for (int x = from_x; x < width_; ++x)
+    {
+        for (int y = from_y; y < height_; ++y)
+        {
+            const int value = (tiles_[TileIndex(x, y)] & flag) ? 1 : 0;
+            sums[SumIndex(x + 1, y + 1)] = value
+                                         + sums[SumIndex(x,     y + 1)]
+                                         + sums[SumIndex(x + 1, y)]
+                                         - sums[SumIndex(x,     y)];
+        }
+    }
+}
+
+int PlacementIndex::RectSum(const int layer, const int x1, const int y1, const int x2, const int y2) const
+{
+    const std::vector<int> & sums = sums_[layer];
+    return sums[SumIndex(x2, y2)] - sums[SumIndex(x1, y2)] - sums[SumIndex(x2, y1)] + sums[SumIndex(x1, y1)];
+}
+
+void PlacementIndex::SetRect(const int layer, int x1, int y1, int x2, int y2, const bool blocked)
+{
+    x1 = std::max(x1, 0);
+    y1 = std::max(y1, 0);
+    x2 = std::min(x2, width_);
+    y2 = std::min(y2, height_);
+    if (x1 >= x2 || y1 >= y2)
+    {
+        return;
+    }
+
+    for (int x = x1; x < x2; ++x)
+    {
+        for (int y = y1; y < y2; ++y)
+        {
+            MarkTile(layer, x, y, blocked);
+        }
+    }
+
+    for (int i = 0; i < num_layers_; ++i)
+    {
+        if (layer & (1 << i))
+        {
+            RebuildSums(i, x1, y1);
+        }
+    }
+}
+
+void PlacementIndex::MarkTile(const int layer, const int x, const int y, const bool blocked)
+{
+    if (x < 0 || y < 0 || x >= width_ || y >= height_)
+    {
+        return;
+    }
+
+    if (blocked)
+        tiles_[TileIndex(x, y)] |= layer;
+    else
+        tiles_[TileIndex(x, y)] &= ~layer;
+}
+
+void PlacementIndex::RebuildAll()
+{
+    for (int i = 0; i < num_layers_; ++i)
+    {
+        RebuildSums(i, 0, 0);
+    }
+}
+
+bool PlacementIndex::IsBlocked(const int x, const int y, const int layer_mask) const
+{
+    if (x < 0 || y < 0 || x >= width_ || y >= height_)
+    {
+        return true;
+    }
+
+    return (tiles_[TileIndex(x, y)] & layer_mask) != 0;
+}
+
+bool PlacementIndex::IsRectBlocked(const int x1, const int y1, const int x2, const int y2, const int layer_mask) const
+{
+    if (x1 < 0 || y1 < 0 || x2 > width_ || y2 > height_)
+    {
+        return true;
+    }
+
+    // An empty rectangle can't have anything in it.
+    if (x1 >= x2 || y1 >= y2)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < num_layers_; ++i)
+    {
+        if ((layer_mask & (1 << i)) && RectSum(i, x1, y1, x2, y2) > 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int PlacementIndex::Width() const
+{
+    return width_;
+}
+
+int PlacementIndex::Height() const
+{
+    return height_;
+}
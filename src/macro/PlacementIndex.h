@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+
+// Every tile on the map can be blocked for more than one reason.
+// Each reason gets its own layer so callers can pick which ones they care about.
+namespace PlacementLayer
+{
+    enum
+    {
+        Unbuildable   = 1 << 0,
+        Reserved      = 1 << 1,
+        ResourceBox   = 1 << 2,
+        BaseFootprint = 1 << 3,
+        Planned       = 1 << 4,     // kept free for the base layout, see BaseLayoutPlanner
+        All           = Unbuildable | Reserved | ResourceBox | BaseFootprint | Planned
+    };
+}
+
+// Keeps a summed-area table (integral image) for each layer of blocked tiles.
+// Any "is anything in this rectangle blocked?" question is four lookups per layer instead of a loop over the rectangle.
+class PlacementIndex
+{
+    static const int num_layers_ = 5;
+
+    int                 width_;
+    int                 height_;
+
+    // Bit flags of PlacementLayer for each tile, indexed [x][y] through TileIndex().
+    std::vector<int>    tiles_;
+
+    // sums_[layer] is (width_+1) * (height_+1). Row and column 0 are always zero so lookups never need a bounds branch.
+    std::vector<int>    sums_[num_layers_];
+
+    int  TileIndex(int x, int y) const;
+    int  SumIndex(int x, int y) const;
+    void RebuildSums(int layer, int from_x, int from_y);
+    int  RectSum(int layer, int x1, int y1, int x2, int y2) const;
+
+public:
+    PlacementIndex();
+
+    void Reset(int width, int height);
+
+    // Marks (or clears) the layer on every tile in [x1, x2) x [y1, y2), then only recomputes the part of the table that changed.
+    void SetRect(int layer, int x1, int y1, int x2, int y2, bool blocked);
+
+    // Same as SetRect for a single tile, but the table is not touched. Call RebuildAll() once you are done.
+    // Used at startup when stamping many small areas.
+    void MarkTile(int layer, int x, int y, bool blocked);
+    void RebuildAll();
+
+    bool IsBlocked(int x, int y, int layer_mask) const;
+
+    // Returns true if any tile in [x1, x2) x [y1, y2) is blocked on one of the layers in layer_mask.
+    // Tiles that are off the map always count as blocked.
+    bool IsRectBlocked(int x1, int y1, int x2, int y2, int layer_mask) const;
+
+    int  Width() const;
+    int  Height() const;
+};
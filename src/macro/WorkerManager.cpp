@@ -28,14 +28,13 @@ void WorkerManager::OnFrame()
 void WorkerManager::AssignIdleWorkers() const
 {
     // for each of our workers
-    for (auto & worker_info : bot_.InformationManager().UnitInfo().GetWorkers())
+    for (const auto & worker_info : bot_.InformationManager().UnitInfo().GetWorkers())
     {
         const sc2::Unit* worker = worker_info->unit;
         if (!worker) { continue; }
 
         // if it's a scout or creating a proxy building, don't handle it here
-        if (bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self).at(worker_info->unit->tag).mission == UnitMission::Scout
-            || bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Self).at(worker_info->unit->tag).mission == UnitMission::Proxy)
+        if (worker_info->mission == UnitMission::Scout || worker_info->mission == UnitMission::Proxy)
         {
             continue;
         }
@@ -83,7 +82,7 @@ void WorkerManager::AssignGasWorkers() const
 // Make the workers go do the things that they were assigned to do. 
 void WorkerManager::HandleWorkers() const
 {
-    for (auto & worker_info : bot_.InformationManager().UnitInfo().GetWorkers())
+    for (const auto & worker_info : bot_.InformationManager().UnitInfo().GetWorkers())
     {
         const UnitMission job = worker_info->mission;
         if (job == UnitMission::Minerals)
@@ -121,51 +120,17 @@ void WorkerManager::HandleWorkers() const
 
 const sc2::Unit* WorkerManager::GetMineralToMine(const sc2::Unit* unit) const
 {
-    const sc2::Unit* best_mineral = nullptr;
-    double best_dist = std::numeric_limits<double>::max();;
-
-    for (auto & mineral : bot_.Observation()->GetUnits())
+    return bot_.InformationManager().UnitInfo().GetUnitGrid(PlayerArrayIndex::Neutral).GetClosest(unit->pos, [](const sc2::Unit* mineral)
     {
-        if (!Util::IsMineral(mineral)) continue;
-
-        const double dist = Util::Dist(mineral->pos, unit->pos);
-
-        if (dist < best_dist)
-        {
-            best_mineral = mineral;
-            best_dist = dist;
-        }
-    }
-
-    return best_mineral;
+        return Util::IsMineral(mineral);
+    });
 }
 
-// Unlike the GetCosestUnit functions inside InformationManager, this only iterates through workers.
+// Mineral and proxy workers only. Builders, scouts and gas workers are busy.
 const sc2::Unit* WorkerManager::GetClosestMineralWorkerTo(const sc2::Point2D & pos) const
 {
-    const sc2::Unit* closest_mineral_worker = nullptr;
-    double closest_dist = std::numeric_limits<double>::max();
-
-    // for each of our workers
-    for (auto & worker_info : bot_.InformationManager().UnitInfo().GetWorkers())
-    {
-        if (!worker_info) { std::cout << "Warning: a workerInfo pointer is invalid." << std::endl; continue; }
-
-        // if it is a mineral worker
-        if (worker_info->mission == UnitMission::Minerals
-        ||  worker_info->mission == UnitMission::Proxy)
-        {
-            const double dist = Util::DistSq(worker_info->unit->pos, pos);
-
-            if (!closest_mineral_worker || dist < closest_dist)
-            {
-                closest_mineral_worker = worker_info->unit;
-                closest_dist = dist;
-            }
-        }
-    }
-
-    return closest_mineral_worker;
+    const std::vector<UnitMission> missions{ UnitMission::Minerals, UnitMission::Proxy };
+    return bot_.InformationManager().GetClosestUnitWithJob(pos, missions);
 }
 
 const sc2::Unit* WorkerManager::GetGasWorker(const sc2::Unit* refinery) const
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <sstream>
 
 #include "ByunJRBot.h"
@@ -12,6 +13,8 @@ const size_t BaseDefensePriority = 2;
 const size_t ScoutDefensePriority = 3;
 const size_t DropPriority = 4;
 
+const float attack_simulation_seconds = 30.0f;
+
 CombatCommander::CombatCommander(ByunJRBot & bot)
     : bot_(bot)
     , squad_data_(bot)
@@ -37,15 +40,16 @@ void CombatCommander::OnStart()
     squad_data_.AddSquad("ScoutDefense", Squad("ScoutDefense", enemyScoutDefense, ScoutDefensePriority, bot_));
 }
 
-void CombatCommander::OnFrame(const std::set<const UnitInfo*> & combat_units)
+void CombatCommander::OnFrame(const UnitGroup & combat_units)
 {
+    // Has to be this frame's list. Last frame's pointers went stale when UnitData added and removed units.
+    combat_units_ = combat_units.GetUnits();
+
     if (!attack_started_)
     {
         attack_started_ = ShouldWeStartAttacking();
     }
 
-    combat_units_ = combat_units;
-
     //if (isSquadUpdateFrame())
     //{
     //    updateIdleSquad();
@@ -57,7 +61,7 @@ void CombatCommander::OnFrame(const std::set<const UnitInfo*> & combat_units)
     Squad & main_attack_squad = squad_data_.GetSquad("MainAttack");
     main_attack_squad.Clear();
     
-    for (auto & unit_info : combat_units)
+    for (auto & unit_info : combat_units_)
     {
         auto unit = unit_info->unit;
         BOT_ASSERT(unit, "null unit in combat units");
@@ -73,6 +77,9 @@ void CombatCommander::OnFrame(const std::set<const UnitInfo*> & combat_units)
     main_attack_squad.SetSquadOrder(main_attack_order);
 
     squad_data_.OnFrame();
+
+    // Nothing should look at these after this frame.
+    combat_units_.clear();
 }
 
 void CombatCommander::OnUnitCreated(const sc2::Unit* unit)
@@ -83,9 +90,37 @@ void CombatCommander::OnUnitCreated(const sc2::Unit* unit)
     }
 }
 
-bool CombatCommander::ShouldWeStartAttacking() const
+// Wait for enough units, then only go if our army beats everything we know they have in a straight up fight.
+bool CombatCommander::ShouldWeStartAttacking()
 {
-    return combat_units_.size() >= bot_.Config().CombatUnitsForAttack;
+    if (combat_units_.size() < bot_.Config().CombatUnitsForAttack)
+    {
+        return false;
+    }
+
+    // Everyone starts on the same spot. We don't know where the fight will happen, so only the numbers matter.
+    const sc2::Point2D fight_position(0.0f, 0.0f);
+    const UnitTypeTable & unit_types = bot_.UnitTypes();
+
+    simulator_.Clear();
+    for (auto & unit_info : combat_units_)
+    {
+        simulator_.AddOurUnit(unit_info->unit, fight_position, unit_types.Get(unit_info->type));
+    }
+
+    for (const UnitInfo & unit_info : bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Enemy))
+    {
+        const UnitTypeTraits & traits = unit_types.Get(unit_info.type);
+        if (!traits.is_combat_unit && !(traits.is_building && (traits.ground_dps > 0.0f || traits.air_dps > 0.0f)))
+        {
+            continue;
+        }
+
+        const bool flying = unit_info.unit ? unit_info.unit->is_flying : false;
+        simulator_.AddEnemyUnit(fight_position, traits, unit_info.lastHealth, unit_info.lastShields, flying);
+    }
+
+    return simulator_.Simulate(attack_simulation_seconds).WeWin();
 }
 
 sc2::Point2D CombatCommander::GetMainAttackLocation() const
@@ -117,9 +152,8 @@ sc2::Point2D CombatCommander::GetMainAttackLocation() const
     }
 
     // Second choice: Attack known enemy buildings
-    for (const auto & kv : bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Enemy))
+    for (const UnitInfo & ui : bot_.InformationManager().UnitInfo().GetUnitInfoMap(PlayerArrayIndex::Enemy))
     {
-        const UnitInfo & ui = kv.second;
 
         if (Util::IsBuilding(ui.type) && !(ui.lastPosition.x == 0.0f && ui.lastPosition.y == 0.0f))
         {
@@ -127,15 +161,24 @@ sc2::Point2D CombatCommander::GetMainAttackLocation() const
         }
     }
 
-    // Third choice: Attack visible enemy units that aren't overlords
-    for (auto & enemy_unit : bot_.InformationManager().UnitInfo().GetUnits(PlayerArrayIndex::Enemy))
+    // Third choice: Attack the biggest group of visible enemy units, as long as it isn't just overlords
+    const UnitCluster* biggest_cluster = nullptr;
+    for (auto & cluster : bot_.InformationManager().UnitInfo().GetUnitClusters(PlayerArrayIndex::Enemy).GetClusters())
     {
-        if (enemy_unit->unit_type != sc2::UNIT_TYPEID::ZERG_OVERLORD)
+        const bool only_overlords = std::all_of(cluster.units.begin(), cluster.units.end(),
+            [](const sc2::Unit* unit) { return unit->unit_type == sc2::UNIT_TYPEID::ZERG_OVERLORD; });
+
+        if (!only_overlords && (!biggest_cluster || cluster.units.size() > biggest_cluster->units.size()))
         {
-            return enemy_unit->pos;
+            biggest_cluster = &cluster;
         }
     }
 
+    if (biggest_cluster)
+    {
+        return biggest_cluster->center;
+    }
+
     std::cout << "WARNING: ENEMY BASE LOCATION NOT FOUND, RETURNING 0,0" << std::endl;
     return sc2::Point2D(0, 0);
 
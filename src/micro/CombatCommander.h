@@ -1,4 +1,5 @@
 #pragma once
+#include "micro/CombatSimulator.h"
 #include "micro/Squad.h"
 #include "micro/SquadData.h"
 
@@ -9,9 +10,10 @@ class CombatCommander
     ByunJRBot &               bot_;
 
     SquadData                 squad_data_;
-    std::set<const UnitInfo*> combat_units_;
+    std::vector<const UnitInfo*> combat_units_;    // only filled in during OnFrame, see UnitGroup::GetUnits
     bool                      initialized_;
     bool                      attack_started_;
+    CombatSimulator           simulator_;
 
     //void             updateScoutDefenseSquad();
     //void             updateDefenseSquads();
@@ -24,13 +26,13 @@ class CombatCommander
     sc2::Point2D     GetMainAttackLocation() const;
 
     //void             updateDefenseSquadUnits(Squad & defenseSquad, const size_t & flyingDefendersNeeded, const size_t & groundDefendersNeeded);
-    bool             ShouldWeStartAttacking() const;
+    bool             ShouldWeStartAttacking();
 
 public:
     CombatCommander(ByunJRBot & bot);
 
     void OnStart();
-    void OnFrame(const std::set<const UnitInfo*>& combat_units);
+    void OnFrame(const UnitGroup & combat_units);
     void OnUnitCreated(const sc2::Unit* unit);
 
     void DrawSquadInformation();
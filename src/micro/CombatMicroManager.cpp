@@ -1,12 +1,174 @@
+#include <algorithm>
+#include <cmath>
+
 #include "ByunJRBot.h"
 #include "common/BotAssert.h"
 #include "common/Common.h"
 #include "micro/CombatMicroManager.h"
 #include "util/Util.h"
 
+namespace
+{
+    // The fight doesn't change much in a few frames, there's no need to search every one.
+    const int policy_search_interval = 8;
+    const double policy_search_budget_ms = 1.0;
+
+    // Focus fire only pulls units onto targets they can reach without walking far.
+    const float focus_fire_extra_range = 1.0f;
+
+    // The grid goes by unit centers, so look this much further out to catch the edge of big targets.
+    const float focus_fire_max_target_radius = 3.0f;
+
+    // Same as the simulator, so the flank we carry out is the one that was simulated.
+    const float flank_angle = 1.0f;
+
+    // Decisions are kept for at least this many game loops, and at most this many.
+    const int min_decision_loops = 2;
+    const int max_decision_loops = 22;
+    const float loops_per_second = 22.4f;
+
+    // Steered units are sent this far ahead. Far enough that they don't stop before the next command, close enough to keep turning.
+    const float steer_distance = 3.0f;
+
+    // Retreating ground units aim this many tiles down the way home. Further than steer_distance, so the field keeps pulling them along.
+    const int retreat_lookahead_tiles = 8;
+
+    // Close enough to its formation slot to count as being there.
+    const float slot_tolerance = 1.0f;
+}
+
 CombatMicroManager::CombatMicroManager(ByunJRBot & bot)
-    : bot_(bot)
+    : search_(bot)
+    , last_policy_search_(-policy_search_interval)
+    , squad_path_(nullptr)
+    , bot_(bot)
+    , policy_(CombatPolicy::AttackClosest)
+{
+}
+
+void CombatMicroManager::ChoosePolicy(const std::set<const sc2::Unit*> & targets, const std::vector<CombatPolicy> & portfolio)
+{
+    if (targets.empty())
+    {
+        policy_ = portfolio.front();
+        return;
+    }
+
+    const int game_loop = static_cast<int>(bot_.Observation()->GetGameLoop());
+    if (game_loop - last_policy_search_ < policy_search_interval)
+    {
+        return;
+    }
+    last_policy_search_ = game_loop;
+
+    // Keep the current policy if nothing got fully simulated in time. On the first search it may not be one of ours yet.
+    const bool current_in_portfolio = std::find(portfolio.begin(), portfolio.end(), policy_) != portfolio.end();
+    policy_ = search_.Search(units_, targets, portfolio, current_in_portfolio ? policy_ : portfolio.front(), policy_search_budget_ms);
+}
+
+bool CombatMicroManager::IsFlanker(const size_t unit_index) const
+{
+    // Every other unit goes around, same as in the simulation.
+    return policy_ == CombatPolicy::Flank && unit_index % 2 == 1;
+}
+
+// The weakest target this unit can shoot without walking more than a step, or nullptr.
+// Only the enemy grid cells around the unit are looked at, not every target.
+const sc2::Unit* CombatMicroManager::GetFocusFireTarget(const sc2::Unit* unit, const std::function<float(const sc2::Unit*)> & value_left) const
+{
+    const UnitTypeTraits & traits = bot_.UnitTypes().Get(unit->unit_type);
+    const sc2::Unit* best_target = nullptr;
+    float lowest_value = 0.0f;
+
+    const float search_radius = traits.max_range + unit->radius + focus_fire_extra_range + focus_fire_max_target_radius;
+    for (auto & target : bot_.InformationManager().UnitInfo().GetUnitGrid(PlayerArrayIndex::Enemy).GetInRadius(unit->pos, search_radius))
+    {
+        if (target->is_flying ? !traits.can_attack_air : !traits.can_attack_ground)
+        {
+            continue;
+        }
+
+        const float range = target->is_flying ? traits.air_range : traits.ground_range;
+        if (Util::Dist(unit->pos, target->pos) > range + unit->radius + target->radius + focus_fire_extra_range)
+        {
+            continue;
+        }
+
+        const float value = value_left(target);
+        if (value > 0.0f && (!best_target || value < lowest_value))
+        {
+            best_target = target;
+            lowest_value = value;
+        }
+    }
+
+    return best_target;
+}
+
+// Swings around the target, alternating sides, and ends up just inside our range.
+sc2::Point2D CombatMicroManager::GetFlankPosition(const sc2::Unit* unit, const size_t unit_index, const sc2::Unit* target) const
+{
+    const float angle = (unit_index % 4 == 1) ? flank_angle : -flank_angle;
+    const float dx = unit->pos.x - target->pos.x;
+    const float dy = unit->pos.y - target->pos.y;
+    const float length = std::sqrt(dx * dx + dy * dy);
+    if (length == 0.0f)
+    {
+        return unit->pos;
+    }
+
+    const float range = Util::GetAttackRange(unit->unit_type, bot_) + unit->radius + target->radius;
+    const float c = std::cos(angle);
+    const float s = std::sin(angle);
+    return sc2::Point2D(target->pos.x + (dx * c - dy * s) / length * range,
+                        target->pos.y + (dx * s + dy * c) / length * range);
+}
+
+void CombatMicroManager::Steer(const bool retreating)
+{
+    const sc2::Point2D home = bot_.GetStartLocation();
+    const DistanceMap* home_distance = retreating ? &bot_.Map().GetDistanceMap(sc2::Point2DI(static_cast<int>(home.x), static_cast<int>(home.y))) : nullptr;
+
+    field_.Clear();
+    for (auto & unit : units_)
+    {
+        sc2::Point2D goal = home;
+        if (retreating)
+        {
+            // Heading straight for home gets ground units stuck on the first cliff in the way. Follow the ground instead.
+            const sc2::Point2DI tile(static_cast<int>(unit->pos.x), static_cast<int>(unit->pos.y));
+            const sc2::Point2DI next = unit->is_flying ? tile : home_distance->GetTileTowardStart(tile, retreat_lookahead_tiles);
+            if (!(next == tile))
+            {
+                goal = sc2::Point2D(next.x + 0.5f, next.y + 0.5f);
+            }
+        }
+        else if (!squad_path_->GetFollowPosition(unit, goal))
+        {
+            goal = order_.GetPosition();
+        }
+        field_.Add(unit, goal);
+    }
+    field_.Compute(bot_.InformationManager().UnitInfo().GetUnitArrays(PlayerArrayIndex::Self), bot_.InformationManager().GetThreatMap());
+}
+
+sc2::Point2D CombatMicroManager::GetSteeredPosition(const size_t unit_index) const
 {
+    BOT_ASSERT(unit_index < field_.size(), "Steer has to be called before GetSteeredPosition");
+    return field_.GetMovePosition(unit_index, steer_distance);
+}
+
+void CombatMicroManager::MoveToOrderPosition(const size_t unit_index)
+{
+    const sc2::Unit* unit = units_[unit_index];
+    if (squad_path_->NeedsOwnPath(unit))
+    {
+        Micro::SmartPathfind(unit, order_.GetPosition(), bot_);
+    }
+    else
+    {
+        Micro::SmartMove(unit, GetSteeredPosition(unit_index), bot_);
+    }
 }
 
 void CombatMicroManager::SetUnits(const std::vector<const sc2::Unit*> & u)
@@ -14,7 +176,7 @@ void CombatMicroManager::SetUnits(const std::vector<const sc2::Unit*> & u)
     units_ = u;
 }
 
-void CombatMicroManager::Execute(const SquadOrder & input_order)
+void CombatMicroManager::Execute(const SquadOrder & input_order, const SquadPath & squad_path)
 {
     // Nothing to do if we have no units
     if (units_.empty() || !(input_order.GetType() == SquadOrderTypes::Attack || input_order.GetType() == SquadOrderTypes::Defend))
@@ -23,17 +185,22 @@ void CombatMicroManager::Execute(const SquadOrder & input_order)
     }
 
     order_ = input_order;
+    squad_path_ = &squad_path;
 
     // Discover enemies within region of interest
     std::set<const sc2::Unit*> nearby_enemies;
 
     // Get all relavant units that are close to our combat unit.
-    for (auto & enemy_unit : bot_.InformationManager().UnitInfo().GetUnits(PlayerArrayIndex::Enemy))
+    std::vector<const sc2::Unit*> enemies_in_radius;
+    bot_.InformationManager().UnitInfo().GetUnitArrays(PlayerArrayIndex::Enemy).GetInRadius(order_.GetPosition(), order_.GetRadius(), enemies_in_radius);
+    nearby_enemies.insert(enemies_in_radius.begin(), enemies_in_radius.end());
+
+    // An army standing on the edge of the radius is still one army. Fight all of it, not just the half that's inside.
+    std::vector<const UnitCluster*> nearby_clusters;
+    bot_.InformationManager().UnitInfo().GetUnitClusters(PlayerArrayIndex::Enemy).GetClustersInRadius(order_.GetPosition(), order_.GetRadius(), nearby_clusters);
+    for (auto & cluster : nearby_clusters)
     {
-        if (Util::Dist(enemy_unit->pos, order_.GetPosition()) < order_.GetRadius())
-        {
-            nearby_enemies.insert(enemy_unit);
-        }
+        nearby_enemies.insert(cluster->units.begin(), cluster->units.end());
     }
     // otherwise we want to see everything on the way as well
     //if (order.getType() == SquadOrderTypes::Attack)
@@ -59,6 +226,29 @@ void CombatMicroManager::Execute(const SquadOrder & input_order)
     {
         ExecuteMicro(nearby_enemies);
     }
+
+    micro_states_.Prune(static_cast<int>(bot_.Observation()->GetGameLoop()));
+    squad_path_ = nullptr;
+}
+
+int CombatMicroManager::GetDecisionExpiry(const sc2::Unit* unit, const sc2::Unit* target, const int game_loop) const
+{
+    // weapon_cooldown is already in game loops.
+    float loops = unit->weapon_cooldown;
+
+    if (target)
+    {
+        const UnitTypeTraits & traits = bot_.UnitTypes().Get(unit->unit_type);
+        const float range = (target->is_flying ? traits.air_range : traits.ground_range) + unit->radius + target->radius;
+        const float gap = Util::Dist(unit->pos, target->pos) - range;
+        if (gap > 0.0f && traits.movement_speed > 0.0f)
+        {
+            loops = std::max(loops, gap / traits.movement_speed * loops_per_second);
+        }
+    }
+
+    const int hold = std::min(std::max(static_cast<int>(loops), min_decision_loops), max_decision_loops);
+    return game_loop + hold;
 }
 
 const std::vector<const sc2::Unit*> & CombatMicroManager::GetUnits() const
@@ -66,31 +256,37 @@ const std::vector<const sc2::Unit*> & CombatMicroManager::GetUnits() const
     return units_;
 }
 
-void CombatMicroManager::Regroup(const sc2::Point2D & regroup_position) const
+const MicroStateCache & CombatMicroManager::GetMicroStates() const
 {
-    const sc2::Point2D our_base_position = bot_.GetStartLocation();
-    const int regroup_distance_from_base = bot_.Map().GetGroundDistance(regroup_position, our_base_position);
+    return micro_states_;
+}
 
-    // for each of the units we have
+CombatPolicy CombatMicroManager::GetPolicy() const
+{
+    return policy_;
+}
+
+void CombatMicroManager::Regroup(const Formation & formation) const
+{
     for (auto & unit : units_)
     {
         BOT_ASSERT(unit, "null unit in CombatMicroManager regroup");
 
-        const int unit_distance_from_base = bot_.Map().GetGroundDistance(unit->pos, our_base_position);
-
-        // if the unit is outside the regroup area
-        if (unit_distance_from_base > regroup_distance_from_base)
+        // Joined the squad since the formation was worked out. It'll get a slot next frame.
+        sc2::Point2D slot;
+        if (!formation.GetSlot(unit, slot))
         {
-            Micro::SmartMove(unit, our_base_position, bot_);
+            continue;
         }
-        else if (Util::Dist(unit->pos, regroup_position) > 4)
+
+        if (Util::Dist(unit->pos, slot) > slot_tolerance)
         {
-            // regroup it
-            Micro::SmartMove(unit, regroup_position, bot_);
+            Micro::SmartMove(unit, slot, bot_);
         }
-        else
+        // In its slot. Fight whatever walks up, but don't chase it.
+        else if (unit->orders.empty())
         {
-            Micro::SmartAttackMove(unit, unit->pos, bot_);
+            Micro::SmartAttackMove(unit, slot, bot_);
         }
     }
-}
\ No newline at end of file
+}
@@ -1,6 +1,13 @@
 #pragma once
+#include <functional>
+
+#include "micro/Formation.h"
 #include "micro/SquadOrder.h"
 #include "micro/Micro.h"
+#include "micro/MicroState.h"
+#include "micro/PortfolioSearch.h"
+#include "micro/PotentialField.h"
+#include "micro/SquadPath.h"
 
 struct AirThreat
 {
@@ -21,20 +28,49 @@ class ByunJRBot;
 class CombatMicroManager
 {
     std::vector<const sc2::Unit*> units_;
+    PortfolioSearch search_;
+    int last_policy_search_;
+    PotentialField field_;
+    const SquadPath* squad_path_;   // only set during Execute
 
 protected:
     ByunJRBot & bot_;
     SquadOrder order_;
+    CombatPolicy policy_;
+    MicroStateCache micro_states_;
 
     virtual void ExecuteMicro(const std::set<const sc2::Unit*> & targets) = 0;
 
+    // Searches the portfolio for the best way to fight the targets every few game loops, and keeps the answer in policy_.
+    void ChoosePolicy(const std::set<const sc2::Unit*> & targets, const std::vector<CombatPolicy> & portfolio);
+
+    // Helpers for carrying out the policies.
+    bool IsFlanker(size_t unit_index) const;
+    // value_left is a target's health once the shots already on their way land, 0 or less for anything we shouldn't shoot.
+    const sc2::Unit* GetFocusFireTarget(const sc2::Unit* unit, const std::function<float(const sc2::Unit*)> & value_left) const;
+    sc2::Point2D GetFlankPosition(const sc2::Unit* unit, size_t unit_index, const sc2::Unit* target) const;
+
+    // Works out the potential field for every unit, for GetSteeredPosition. Once per frame, before any unit moves.
+    // Retreating ground units walk down the distance map home, flyers go straight there. Everyone else follows the squad's path to the order position.
+    void Steer(bool retreating);
+    // Where unit_index should move to get where it's going without walking into the enemy or into the rest of the squad.
+    sc2::Point2D GetSteeredPosition(size_t unit_index) const;
+    // Steers the unit along the squad's path, or gives it a path of its own when it can't walk to the rest of the squad.
+    void MoveToOrderPosition(size_t unit_index);
+
+    // When a decision to go after target should be looked at again: once the weapon is ready, or once we've walked into range.
+    int GetDecisionExpiry(const sc2::Unit* unit, const sc2::Unit* target, int game_loop) const;
+
 public:
     CombatMicroManager(ByunJRBot & bot);
 
     const std::vector<const sc2::Unit*> & GetUnits() const;
+    const MicroStateCache & GetMicroStates() const;
+    CombatPolicy GetPolicy() const;
 
     void SetUnits(const std::vector<const sc2::Unit*> & u);
-    void Execute(const SquadOrder & order);
-    void Regroup(const sc2::Point2D & regroup_position) const;
+    void Execute(const SquadOrder & order, const SquadPath & squad_path);
+    // Walks every unit to its slot in the formation, and has it hold there.
+    void Regroup(const Formation & formation) const;
 
 };
\ No newline at end of file
@@ -0,0 +1,387 @@
+#include <algorithm>
+#include <cmath>
+
+#include "information/UnitTypeTable.h"
+#include "micro/CombatSimulator.h"
+
+const float CombatSimulator::step_seconds = 0.5f;
+
+namespace
+{
+    const int ours = 0;
+    const int theirs = 1;
+
+    // In starcraft every attack does at least half a point of damage, whatever the armor.
+    const float min_damage_per_hit = 0.5f;
+
+    // A kiting unit spends about half its time walking instead of shooting.
+    const float kite_fire_fraction = 0.5f;
+
+    // How far around the enemy the flanking half of the army goes, in radians.
+    const float flank_angle = 1.0f;
+}
+
+const char* GetCombatPolicyName(const CombatPolicy policy)
+{
+    switch (policy)
+    {
+        case CombatPolicy::AttackClosest: return "AttackClosest";
+        case CombatPolicy::FocusFire:     return "FocusFire";
+        case CombatPolicy::Kite:          return "Kite";
+        case CombatPolicy::Retreat:       return "Retreat";
+        case CombatPolicy::Flank:         return "Flank";
+    }
+    return "Unknown";
+}
+
+bool CombatResult::WeWin() const
+{
+    return our_value_left > their_value_left;
+}
+
+CombatSimulator::CombatUnit CombatSimulator::MakeUnit(const sc2::Point2D & pos, const float radius, const float hp, const float shield, const bool flying, const UnitTypeTraits & traits)
+{
+    CombatUnit unit;
+    unit.x = pos.x;
+    unit.y = pos.y;
+    unit.radius = radius;
+    unit.hp = hp;
+    unit.shield = shield;
+    unit.armor = traits.armor;
+    unit.ground_dps = traits.ground_dps;
+    unit.air_dps = traits.air_dps;
+    unit.ground_range = traits.ground_range;
+    unit.air_range = traits.air_range;
+    unit.hit_damage = traits.hit_damage;
+    unit.speed = traits.is_building ? 0.0f : traits.movement_speed;
+    unit.flying = flying;
+    unit.delay = 0.0f;
+    unit.target = -1;
+    return unit;
+}
+
+void CombatSimulator::Clear()
+{
+    start_[ours].clear();
+    start_[theirs].clear();
+}
+
+void CombatSimulator::AddOurUnit(const sc2::Unit* unit, const sc2::Point2D & pos, const UnitTypeTraits & traits)
+{
+    start_[ours].push_back(MakeUnit(pos, unit->radius, unit->health, unit->shield, unit->is_flying, traits));
+}
+
+void CombatSimulator::AddEnemyUnit(const sc2::Unit* unit, const sc2::Point2D & pos, const UnitTypeTraits & traits)
+{
+    start_[theirs].push_back(MakeUnit(pos, unit->radius, unit->health, unit->shield, unit->is_flying, traits));
+}
+
+void CombatSimulator::AddOurUnit(const sc2::Point2D & pos, const UnitTypeTraits & traits, const float hp, const float shield, const bool flying)
+{
+    start_[ours].push_back(MakeUnit(pos, 0.5f, hp, shield, flying, traits));
+}
+
+void CombatSimulator::AddEnemyUnit(const sc2::Point2D & pos, const UnitTypeTraits & traits, const float hp, const float shield, const bool flying)
+{
+    start_[theirs].push_back(MakeUnit(pos, 0.5f, hp, shield, flying, traits));
+}
+
+size_t CombatSimulator::NumOurUnits() const
+{
+    return start_[ours].size();
+}
+
+size_t CombatSimulator::NumEnemyUnits() const
+{
+    return start_[theirs].size();
+}
+
+bool CombatSimulator::IsAlive(const CombatUnit & unit) const
+{
+    return unit.hp > 0.0f;
+}
+
+bool CombatSimulator::CanHit(const CombatUnit & attacker, const CombatUnit & target) const
+{
+    return (target.flying ? attacker.air_dps : attacker.ground_dps) > 0.0f;
+}
+
+// Armor comes off every hit, so it matters a lot more against fast weak attacks than slow strong ones.
+float CombatSimulator::EffectiveDPS(const CombatUnit & attacker, const CombatUnit & target) const
+{
+    const float dps = target.flying ? attacker.air_dps : attacker.ground_dps;
+    if (attacker.hit_damage <= 0.0f)
+    {
+        return dps;
+    }
+
+    const float armor = target.shield > 0.0f ? 0.0f : target.armor;
+    return dps * std::max(attacker.hit_damage - armor, min_damage_per_hit) / attacker.hit_damage;
+}
+
+// Flanking units are still walking around the fight, nobody can shoot them yet.
+bool CombatSimulator::IsTargetable(const CombatUnit & unit) const
+{
+    return IsAlive(unit) && unit.delay <= 0.0f;
+}
+
+int CombatSimulator::FindTarget(const int side, const CombatUnit & attacker) const
+{
+    const std::vector<CombatUnit> & enemies = units_[1 - side];
+    int best = -1;
+    float best_distance_sq = 0.0f;
+    for (size_t i = 0; i < enemies.size(); ++i)
+    {
+        if (!IsTargetable(enemies[i]) || !CanHit(attacker, enemies[i]))
+        {
+            continue;
+        }
+
+        const float dx = enemies[i].x - attacker.x;
+        const float dy = enemies[i].y - attacker.y;
+        const float distance_sq = dx * dx + dy * dy;
+        if (best == -1 || distance_sq < best_distance_sq)
+        {
+            best = static_cast<int>(i);
+            best_distance_sq = distance_sq;
+        }
+    }
+    return best;
+}
+
+// The enemy in range with the least health and shields left, or the closest one if nothing is in range.
+int CombatSimulator::FindWeakestTarget(const int side, const CombatUnit & attacker) const
+{
+    const std::vector<CombatUnit> & enemies = units_[1 - side];
+    int best = -1;
+    float best_value = 0.0f;
+    for (size_t i = 0; i < enemies.size(); ++i)
+    {
+        if (!IsTargetable(enemies[i]) || !CanHit(attacker, enemies[i]))
+        {
+            continue;
+        }
+
+        const float dx = enemies[i].x - attacker.x;
+        const float dy = enemies[i].y - attacker.y;
+        const float gap = std::sqrt(dx * dx + dy * dy) - attacker.radius - enemies[i].radius;
+        const float range = enemies[i].flying ? attacker.air_range : attacker.ground_range;
+        if (gap > range)
+        {
+            continue;
+        }
+
+        const float value = enemies[i].hp + enemies[i].shield;
+        if (best == -1 || value < best_value)
+        {
+            best = static_cast<int>(i);
+            best_value = value;
+        }
+    }
+    return best != -1 ? best : FindTarget(side, attacker);
+}
+
+sc2::Point2D CombatSimulator::Centroid(const std::vector<CombatUnit> & units)
+{
+    sc2::Point2D sum(0.0f, 0.0f);
+    for (const CombatUnit & unit : units)
+    {
+        sum.x += unit.x;
+        sum.y += unit.y;
+    }
+    return units.empty() ? sum : sc2::Point2D(sum.x / units.size(), sum.y / units.size());
+}
+
+// Anything a policy needs to do before the fight starts.
+void CombatSimulator::SetUpPolicy(const int side, const CombatPolicy policy, sc2::Point2D & retreat_direction)
+{
+    const sc2::Point2D our_center = Centroid(units_[side]);
+    const sc2::Point2D their_center = Centroid(units_[1 - side]);
+
+    retreat_direction = our_center - their_center;
+    const float length = std::sqrt(retreat_direction.x * retreat_direction.x + retreat_direction.y * retreat_direction.y);
+    retreat_direction = length > 0.0f ? sc2::Point2D(retreat_direction.x / length, retreat_direction.y / length) : sc2::Point2D(1.0f, 0.0f);
+
+    if (policy != CombatPolicy::Flank)
+    {
+        return;
+    }
+
+    // Every other unit swings around the enemy, alternating sides, and stays out of the fight for as long as that walk takes.
+    for (size_t i = 1; i < units_[side].size(); i += 2)
+    {
+        CombatUnit & unit = units_[side][i];
+        if (unit.speed <= 0.0f)
+        {
+            continue;
+        }
+
+        const float angle = (i % 4 == 1) ? flank_angle : -flank_angle;
+        const float dx = unit.x - their_center.x;
+        const float dy = unit.y - their_center.y;
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        unit.x = their_center.x + dx * c - dy * s;
+        unit.y = their_center.y + dx * s + dy * c;
+        unit.delay = std::sqrt(dx * dx + dy * dy) * flank_angle / unit.speed;
+    }
+}
+
+float CombatSimulator::ValueLeft(const int side) const
+{
+    float start = 0.0f;
+    float left = 0.0f;
+    for (size_t i = 0; i < units_[side].size(); ++i)
+    {
+        start += start_[side][i].hp + start_[side][i].shield;
+        if (IsAlive(units_[side][i]))
+        {
+            left += units_[side][i].hp + units_[side][i].shield;
+        }
+    }
+    return start > 0.0f ? left / start : 0.0f;
+}
+
+// Once neither side has anything that can shoot what's left of the other, nothing is going to change.
+bool CombatSimulator::CanAnyoneFight() const
+{
+    bool hits_ground[2] = { false, false };
+    bool hits_air[2] = { false, false };
+    bool has_ground[2] = { false, false };
+    bool has_air[2] = { false, false };
+    for (int side = 0; side < 2; ++side)
+    {
+        for (const CombatUnit & unit : units_[side])
+        {
+            if (!IsAlive(unit))
+            {
+                continue;
+            }
+
+            hits_ground[side] = hits_ground[side] || unit.ground_dps > 0.0f;
+            hits_air[side] = hits_air[side] || unit.air_dps > 0.0f;
+            has_ground[side] = has_ground[side] || !unit.flying;
+            has_air[side] = has_air[side] || unit.flying;
+        }
+    }
+
+    return (hits_ground[ours] && has_ground[theirs]) || (hits_air[ours] && has_air[theirs])
+        || (hits_ground[theirs] && has_ground[ours]) || (hits_air[theirs] && has_air[ours]);
+}
+
+CombatResult CombatSimulator::Simulate(const float max_seconds, const CombatPolicy our_policy, const CombatPolicy their_policy)
+{
+    const CombatPolicy policies[2] = { our_policy, their_policy };
+    sc2::Point2D retreat_direction[2];
+
+    for (int side = 0; side < 2; ++side)
+    {
+        units_[side] = start_[side];
+        damage_taken_[side].assign(units_[side].size(), 0.0f);
+    }
+
+    for (int side = 0; side < 2; ++side)
+    {
+        SetUpPolicy(side, policies[side], retreat_direction[side]);
+    }
+
+    float seconds = 0.0f;
+    while (seconds < max_seconds && CanAnyoneFight())
+    {
+        // Both sides move and shoot at the same time, damage only lands at the end of the step.
+        // Otherwise whoever goes first would have an advantage.
+        for (int side = 0; side < 2; ++side)
+        {
+            const CombatPolicy policy = policies[side];
+            std::vector<CombatUnit> & enemies = units_[1 - side];
+            for (CombatUnit & attacker : units_[side])
+            {
+                if (!IsAlive(attacker))
+                {
+                    continue;
+                }
+
+                if (attacker.delay > 0.0f)
+                {
+                    attacker.delay -= step_seconds;
+                    continue;
+                }
+
+                if (policy == CombatPolicy::Retreat)
+                {
+                    attacker.x += retreat_direction[side].x * attacker.speed * step_seconds;
+                    attacker.y += retreat_direction[side].y * attacker.speed * step_seconds;
+                    continue;
+                }
+
+                if (policy == CombatPolicy::FocusFire)
+                {
+                    attacker.target = FindWeakestTarget(side, attacker);
+                }
+                else if (attacker.target == -1 || !IsTargetable(enemies[attacker.target]))
+                {
+                    attacker.target = FindTarget(side, attacker);
+                }
+
+                if (attacker.target == -1)
+                {
+                    continue;
+                }
+
+                const CombatUnit & target = enemies[attacker.target];
+                const float dx = target.x - attacker.x;
+                const float dy = target.y - attacker.y;
+                const float center_distance = std::sqrt(dx * dx + dy * dy);
+                const float gap = center_distance - attacker.radius - target.radius;
+                const float range = target.flying ? attacker.air_range : attacker.ground_range;
+
+                if (gap > range)
+                {
+                    // Walk straight at it, and stop as soon as it's in range.
+                    const float step = std::min(attacker.speed * step_seconds, gap - range);
+                    if (step > 0.0f && center_distance > 0.0f)
+                    {
+                        attacker.x += dx / center_distance * step;
+                        attacker.y += dy / center_distance * step;
+                    }
+                    continue;
+                }
+
+                float fire_fraction = 1.0f;
+                if (policy == CombatPolicy::Kite && CanHit(target, attacker))
+                {
+                    // Back off while it's getting close enough to shoot back. Only worth it if we outrange it.
+                    const float target_range = attacker.flying ? target.air_range : target.ground_range;
+                    if (target_range < range && gap < target_range + target.speed * step_seconds && center_distance > 0.0f)
+                    {
+                        const float step = attacker.speed * step_seconds * (1.0f - kite_fire_fraction);
+                        attacker.x -= dx / center_distance * step;
+                        attacker.y -= dy / center_distance * step;
+                        fire_fraction = kite_fire_fraction;
+                    }
+                }
+
+                damage_taken_[1 - side][attacker.target] += EffectiveDPS(attacker, target) * step_seconds * fire_fraction;
+            }
+        }
+
+        for (int side = 0; side < 2; ++side)
+        {
+            for (size_t i = 0; i < units_[side].size(); ++i)
+            {
+                CombatUnit & unit = units_[side][i];
+                float damage = damage_taken_[side][i];
+                damage_taken_[side][i] = 0.0f;
+
+                const float absorbed = std::min(unit.shield, damage);
+                unit.shield -= absorbed;
+                unit.hp -= damage - absorbed;
+            }
+        }
+
+        seconds += step_seconds;
+    }
+
+    const CombatResult result = { ValueLeft(ours), ValueLeft(theirs), seconds };
+    return result;
+}
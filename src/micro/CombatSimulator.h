@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+struct UnitTypeTraits;
+
+// How one side behaves in the simulation.
+enum class CombatPolicy
+{
+    AttackClosest,  // walk at the closest thing we can hit and shoot it until it dies
+    FocusFire,      // everyone shoots the weakest enemy in range, and walks at the closest one when nothing is in range
+    Kite,           // like AttackClosest, but step back while shooting when the target has less range than us
+    Retreat,        // run straight away from the enemy and never shoot
+    Flank           // half the units go around and come in from the side. They can't fight until they get there.
+};
+
+const char* GetCombatPolicyName(CombatPolicy policy);
+
+// How a fight turned out. Value is health + shields, as a fraction of what the side started with.
+struct CombatResult
+{
+    float   our_value_left;
+    float   their_value_left;
+    float   seconds;
+
+    bool    WeWin() const;
+};
+
+// A quick and deterministic guess at how a fight between two groups of units goes.
+// Every unit walks straight at the closest thing it can shoot and shoots it until it dies. No spells, no splash, no micro.
+// That's wrong in all kinds of ways, but it's good enough to tell "we crush them" from "we get crushed", and it takes microseconds.
+class CombatSimulator
+{
+    struct CombatUnit
+    {
+        float   x;
+        float   y;
+        float   radius;
+        float   hp;
+        float   shield;
+        float   armor;
+        float   ground_dps;
+        float   air_dps;
+        float   ground_range;
+        float   air_range;
+        float   hit_damage;     // damage of a single attack, for working out what armor takes off
+        float   speed;
+        bool    flying;
+        float   delay;          // seconds until the unit joins the fight, and can be shot
+        int     target;         // index into the other side, -1 when looking for a new one
+    };
+
+    std::vector<CombatUnit> start_[2];
+    std::vector<CombatUnit> units_[2];
+    std::vector<float>      damage_taken_[2];
+
+    static CombatUnit   MakeUnit(const sc2::Point2D & pos, float radius, float hp, float shield, bool flying, const UnitTypeTraits & traits);
+    static sc2::Point2D Centroid(const std::vector<CombatUnit> & units);
+
+    bool  IsAlive(const CombatUnit & unit) const;
+    bool  CanHit(const CombatUnit & attacker, const CombatUnit & target) const;
+    float EffectiveDPS(const CombatUnit & attacker, const CombatUnit & target) const;
+    bool  IsTargetable(const CombatUnit & unit) const;
+    int   FindTarget(int side, const CombatUnit & attacker) const;
+    int   FindWeakestTarget(int side, const CombatUnit & attacker) const;
+    void  SetUpPolicy(int side, CombatPolicy policy, sc2::Point2D & retreat_direction);
+    float ValueLeft(int side) const;
+    bool  CanAnyoneFight() const;
+
+public:
+
+    // Time between steps, in game seconds. Half a second is about how long it takes most units to attack once.
+    static const float step_seconds;
+
+    void Clear();
+
+    // Pass the same point for everyone to skip the walking and just compare damage against health.
+    void AddOurUnit(const sc2::Unit* unit, const sc2::Point2D & pos, const UnitTypeTraits & traits);
+    void AddEnemyUnit(const sc2::Unit* unit, const sc2::Point2D & pos, const UnitTypeTraits & traits);
+
+    // For units we aren't looking at right now, so all we have is the type.
+    void AddOurUnit(const sc2::Point2D & pos, const UnitTypeTraits & traits, float hp, float shield, bool flying);
+    void AddEnemyUnit(const sc2::Point2D & pos, const UnitTypeTraits & traits, float hp, float shield, bool flying);
+
+    size_t NumOurUnits() const;
+    size_t NumEnemyUnits() const;
+
+    // Fights until one side is dead, nobody can hit anything any more, or max_seconds runs out.
+    // The units added stay the same, Simulate can be called again, with different policies for example.
+    CombatResult Simulate(float max_seconds, CombatPolicy our_policy = CombatPolicy::AttackClosest, CombatPolicy their_policy = CombatPolicy::AttackClosest);
+};
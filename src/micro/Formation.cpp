@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "micro/Formation.h"
+#include "util/Util.h"
+
+namespace
+{
+    // Only line up again once the squad or the enemy has moved this far.
+    const float recompute_distance = 2.0f;
+
+    // The arc bends around the enemy, but not around one standing right on top of us, and not much around one on the other side of the map.
+    const float min_arc_radius = 4.0f;
+    const float max_arc_radius = 25.0f;
+
+    // How far around the enemy a row goes, in radians. About 115 degrees.
+    const float max_arc_angle = 2.0f;
+
+    // Room between two units next to each other in a row.
+    const float slot_gap = 0.5f;
+
+    // Rows beyond this are given up on. Shouldn't happen unless most of the map around the anchor is unusable.
+    const int max_rows = 12;
+}
+
+Formation::Formation()
+    : anchor_(0.0f, 0.0f)
+    , facing_(0.0f, 0.0f)
+    , valid_(false)
+    , num_updates_(0)
+{
+}
+
+void Formation::Reset()
+{
+    valid_ = false;
+}
+
+bool Formation::NeedsUpdate(const std::vector<const sc2::Unit*> & units, const sc2::Point2D & anchor, const sc2::Point2D & facing) const
+{
+    if (!valid_ || units != units_)
+    {
+        return true;
+    }
+
+    return Util::DistSq(anchor, anchor_) > recompute_distance * recompute_distance
+        || Util::DistSq(facing, facing_) > recompute_distance * recompute_distance;
+}
+
+void Formation::Update(const std::vector<const sc2::Unit*> & units, const sc2::Point2D & anchor, const sc2::Point2D & facing,
+                       const std::function<bool(const sc2::Point2D &)> & usable)
+{
+    std::vector<const sc2::Unit*> sorted_units(units);
+    std::sort(sorted_units.begin(), sorted_units.end());
+    if (!NeedsUpdate(sorted_units, anchor, facing))
+    {
+        return;
+    }
+
+    units_.swap(sorted_units);
+    anchor_ = anchor;
+    facing_ = facing;
+    valid_ = true;
+    ++num_updates_;
+
+    MakeSlots(units, usable);
+    AssignSlots(units);
+}
+
+// Rows of slots on arcs around a point behind the enemy, the front row going through the anchor.
+// Every row fills from the middle out, so a row that isn't full is still centered on the anchor.
+void Formation::MakeSlots(const std::vector<const sc2::Unit*> & units, const std::function<bool(const sc2::Point2D &)> & usable)
+{
+    slots_.clear();
+    if (units.empty())
+    {
+        return;
+    }
+
+    float max_unit_radius = 0.0f;
+    for (auto & unit : units)
+    {
+        max_unit_radius = std::max(max_unit_radius, unit->radius);
+    }
+    const float spacing = 2.0f * max_unit_radius + slot_gap;
+
+    float dx = anchor_.x - facing_.x;
+    float dy = anchor_.y - facing_.y;
+    float distance = std::sqrt(dx * dx + dy * dy);
+    if (distance < 0.01f)
+    {
+        // No idea which way the enemy is. Any way is as good as another.
+        dx = 0.0f;
+        dy = 1.0f;
+        distance = 1.0f;
+    }
+    dx /= distance;
+    dy /= distance;
+
+    const float arc_radius = std::min(std::max(distance, min_arc_radius), max_arc_radius);
+    const sc2::Point2D center(anchor_.x - dx * arc_radius, anchor_.y - dy * arc_radius);
+    const float facing_angle = std::atan2(dy, dx);
+
+    for (int row = 0; row < max_rows && slots_.size() < units.size(); ++row)
+    {
+        const float radius = arc_radius + row * spacing;
+        const float step = spacing / radius;
+        const int per_row = static_cast<int>(radius * max_arc_angle / spacing) + 1;
+
+        for (int k = 0; k < per_row && slots_.size() < units.size(); ++k)
+        {
+            // 0, 1, -1, 2, -2, ...
+            const int offset = (k % 2 == 1) ? (k + 1) / 2 : -(k / 2);
+            const float angle = facing_angle + offset * step;
+            const sc2::Point2D slot(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+            if (usable(slot))
+            {
+                slots_.push_back(slot);
+            }
+        }
+    }
+
+    // Everyone left over just stands at the anchor.
+    while (slots_.size() < units.size())
+    {
+        slots_.push_back(anchor_);
+    }
+}
+
+// Hungarian algorithm with potentials, O(n^3) but the inner loops are tiny. Cost is the straight line distance to the slot.
+// Rows are units and columns are slots, both 1-based below with 0 as the "nobody" column.
+void Formation::AssignSlots(const std::vector<const sc2::Unit*> & units)
+{
+    unit_slots_.clear();
+    const size_t n = units.size();
+    const size_t m = slots_.size();
+    if (n == 0)
+    {
+        return;
+    }
+
+    cost_.resize(n * m);
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < m; ++j)
+        {
+            cost_[i * m + j] = Util::Dist(units[i]->pos, slots_[j]);
+        }
+    }
+
+    const float infinity = std::numeric_limits<float>::max();
+    u_.assign(n + 1, 0.0f);
+    v_.assign(m + 1, 0.0f);
+    p_.assign(m + 1, 0);
+    way_.assign(m + 1, 0);
+
+    for (size_t i = 1; i <= n; ++i)
+    {
+        p_[0] = static_cast<int>(i);
+        size_t j0 = 0;
+        min_v_.assign(m + 1, infinity);
+        used_.assign(m + 1, 0);
+        tree_.clear();
+
+        // Grow a tree of tight edges from unit i until it reaches a free slot.
+        // The slots not in the tree yet get last step's delta taken off in the same pass that looks for the next one.
+        float last_delta = 0.0f;
+        do
+        {
+            used_[j0] = 1;
+            tree_.push_back(j0);
+            const size_t i0 = static_cast<size_t>(p_[j0]);
+            const float* row = &cost_[(i0 - 1) * m];
+            const float u_i0 = u_[i0];
+            float delta = infinity;
+            size_t j1 = 0;
+            for (size_t j = 1; j <= m; ++j)
+            {
+                if (used_[j]) { continue; }
+
+                float min_v = min_v_[j] - last_delta;
+                const float reduced = row[j - 1] - u_i0 - v_[j];
+                if (reduced < min_v)
+                {
+                    min_v = reduced;
+                    way_[j] = static_cast<int>(j0);
+                }
+                min_v_[j] = min_v;
+                if (min_v < delta)
+                {
+                    delta = min_v;
+                    j1 = j;
+                }
+            }
+
+            for (auto & j : tree_)
+            {
+                u_[p_[j]] += delta;
+                v_[j] -= delta;
+            }
+            last_delta = delta;
+            j0 = j1;
+        } while (p_[j0] != 0);
+
+        // Flip the path we found, so unit i gets a slot and everyone along the way moves over one.
+        do
+        {
+            const size_t j1 = static_cast<size_t>(way_[j0]);
+            p_[j0] = p_[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    for (size_t j = 1; j <= m; ++j)
+    {
+        if (p_[j] != 0)
+        {
+            unit_slots_[units[p_[j] - 1]] = j - 1;
+        }
+    }
+}
+
+bool Formation::GetSlot(const sc2::Unit* unit, sc2::Point2D & slot) const
+{
+    const auto it = unit_slots_.find(unit);
+    if (it == unit_slots_.end())
+    {
+        return false;
+    }
+
+    slot = slots_[it->second];
+    return true;
+}
+
+const std::vector<sc2::Point2D> & Formation::GetSlots() const
+{
+    return slots_;
+}
+
+size_t Formation::GetNumUpdates() const
+{
+    return num_updates_;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+// A concave for a squad to regroup in: rows of slots along arcs around the enemy, and which unit goes to which slot.
+// Units are matched to slots with the Hungarian algorithm, so the squad as a whole walks as little as it can to get into shape.
+// Slots are only worked out again when the squad or the enemy moves a couple of tiles, or units join or die,
+// so units don't get shuffled around between slots every frame.
+class Formation
+{
+    std::vector<const sc2::Unit*>                       units_;         // sorted, to notice when the squad changes
+    std::vector<sc2::Point2D>                           slots_;
+    std::unordered_map<const sc2::Unit*, size_t>        unit_slots_;
+    sc2::Point2D                                        anchor_;
+    sc2::Point2D                                        facing_;
+    bool                                                valid_;
+    size_t                                              num_updates_;
+
+    // Scratch for the assignment, kept around so it doesn't allocate every time.
+    std::vector<float>                                  cost_;
+    std::vector<float>                                  u_;
+    std::vector<float>                                  v_;
+    std::vector<float>                                  min_v_;
+    std::vector<int>                                    p_;
+    std::vector<int>                                    way_;
+    std::vector<char>                                   used_;
+    std::vector<size_t>                                 tree_;          // slots in the tree, same as used_ but as a list
+
+    bool NeedsUpdate(const std::vector<const sc2::Unit*> & units, const sc2::Point2D & anchor, const sc2::Point2D & facing) const;
+    void MakeSlots(const std::vector<const sc2::Unit*> & units, const std::function<bool(const sc2::Point2D &)> & usable);
+    void AssignSlots(const std::vector<const sc2::Unit*> & units);
+
+public:
+
+    Formation();
+
+    // anchor is the middle of the front row, facing is where the enemy is. The concave bends around facing.
+    // usable says whether a unit can stand at a point. Slots where it can't are skipped.
+    void Update(const std::vector<const sc2::Unit*> & units, const sc2::Point2D & anchor, const sc2::Point2D & facing,
+                const std::function<bool(const sc2::Point2D &)> & usable);
+
+    // Where the unit should stand. False for units that weren't there at the last update.
+    bool GetSlot(const sc2::Unit* unit, sc2::Point2D & slot) const;
+    const std::vector<sc2::Point2D> & GetSlots() const;
+
+    // How many times the slots were actually worked out again, since the start of the game.
+    size_t GetNumUpdates() const;
+
+    // Forgets the slots, so the next Update works them out again.
+    void Reset();
+};
@@ -3,6 +3,16 @@
 #include "micro/MeleeManager.h"
 #include "util/Util.h"
 
+namespace
+{
+    bool IsMeleeTarget(const sc2::Unit* target)
+    {
+        return target
+            && !target->is_flying
+            && target->unit_type != sc2::UNIT_TYPEID::ZERG_EGG
+            && target->unit_type != sc2::UNIT_TYPEID::ZERG_LARVA;
+    }
+}
 
 MeleeManager::MeleeManager(ByunJRBot & bot)
     : CombatMicroManager(bot)
@@ -12,36 +22,66 @@ MeleeManager::MeleeManager(ByunJRBot & bot)
 
 void MeleeManager::ExecuteMicro(const std::set<const sc2::Unit*> & targets)
 {
+    // Melee units can't kite. The first policy is what we always did before.
+    std::vector<CombatPolicy> portfolio;
+    portfolio.push_back(CombatPolicy::AttackClosest);
+    portfolio.push_back(CombatPolicy::FocusFire);
+    portfolio.push_back(CombatPolicy::Flank);
+    portfolio.push_back(CombatPolicy::Retreat);
+
+    ChoosePolicy(targets, portfolio);
     AssignTargets(targets);
 }
 
 void MeleeManager::AssignTargets(const std::set<const sc2::Unit*> & targets)
 {
     const std::vector<const sc2::Unit*> & melee_units = GetUnits();
+    const int game_loop = static_cast<int>(bot_.Observation()->GetGameLoop());
 
     // figure out targets
     std::vector<const sc2::Unit*> melee_unit_targets;
     for (auto & target : targets)
     {
-        if (!target) { continue; }
-        if (target->is_flying) { continue; }
-        if (target->unit_type == sc2::UNIT_TYPEID::ZERG_EGG) { continue; }
-        if (target->unit_type == sc2::UNIT_TYPEID::ZERG_LARVA) { continue; }
-
-        melee_unit_targets.push_back(target);
+        if (IsMeleeTarget(target))
+        {
+            melee_unit_targets.push_back(target);
+        }
     }
 
+    // Melee units don't keep track of the damage on its way, every target just has its health.
+    const std::function<float(const sc2::Unit*)> value_left = [&targets](const sc2::Unit* target)
+    {
+        return targets.count(target) && IsMeleeTarget(target) ? target->health + target->shield : 0.0f;
+    };
+
+    // Everyone who walks this frame walks through the same field: home when we're running, along the squad's path otherwise.
+    const bool retreating = policy_ == CombatPolicy::Retreat && !melee_unit_targets.empty();
+    Steer(retreating);
+
     // for each meleeUnit
-    for (auto & melee_unit_tag : melee_units)
+    for (size_t unit_index = 0; unit_index < melee_units.size(); ++unit_index)
     {
-        auto melee_unit = melee_unit_tag;
+        auto melee_unit = melee_units[unit_index];
         BOT_ASSERT(melee_unit, "melee unit is null");
 
         // if the order is to attack or defend
         if (order_.GetType() == SquadOrderTypes::Attack || order_.GetType() == SquadOrderTypes::Defend)
         {
+            // The search thinks we lose this one whatever we do.
+            if (retreating)
+            {
+                if (micro_states_.GetValid(melee_unit, game_loop, policy_))
+                {
+                    micro_states_.CountReused();
+                }
+                else
+                {
+                    Micro::SmartMove(melee_unit, GetSteeredPosition(unit_index), bot_);
+                    micro_states_.Record(melee_unit, nullptr, MicroAction::Move, policy_, game_loop, GetDecisionExpiry(melee_unit, nullptr, game_loop));
+                }
+            }
             // run away if we meet the retreat critereon
-            if (MeleeUnitShouldRetreat(melee_unit, targets))
+            else if (MeleeUnitShouldRetreat(melee_unit, targets))
             {
                 const sc2::Point2D flee_to(bot_.GetStartLocation());
 
@@ -51,24 +91,58 @@ void MeleeManager::AssignTargets(const std::set<const sc2::Unit*> & targets)
             // if there are targets
             else if (!melee_unit_targets.empty())
             {
+                // Still busy going after a target that's still there, leave it be.
+                const UnitMicroState* state = micro_states_.GetValid(melee_unit, game_loop, policy_);
+                if (state && state->target && targets.count(state->target))
+                {
+                    micro_states_.CountReused();
+                    continue;
+                }
+
                 // find the best target for this meleeUnit
-                const sc2::Unit* target = GetTarget(melee_unit_tag, melee_unit_targets);
+                const sc2::Unit* target = GetTarget(melee_unit, melee_unit_targets);
 
                 // Sometimes we won't find a unit to attack. 
                 if (!target)
                     continue;
 
+                const sc2::Unit* focus_target = policy_ == CombatPolicy::FocusFire ? GetFocusFireTarget(melee_unit, value_left) : nullptr;
+
+                MicroAction action = MicroAction::Attack;
+                if (focus_target)
+                {
+                    target = focus_target;
+                    Micro::SmartAttackUnit(melee_unit, focus_target, bot_);
+                }
+                else if (IsFlanker(unit_index) && Util::Dist(melee_unit->pos, target->pos) > 3.0f)
+                {
+                    action = MicroAction::Move;
+                    Micro::SmartMove(melee_unit, GetFlankPosition(melee_unit, unit_index, target), bot_);
+                }
                 // attack it
-                Micro::SmartAttackUnit(melee_unit, target, bot_);
+                else
+                {
+                    Micro::SmartAttackUnit(melee_unit, target, bot_);
+                }
+
+                micro_states_.Record(melee_unit, target, action, policy_, game_loop, GetDecisionExpiry(melee_unit, target, game_loop));
             }
             // if there are no targets
             else
             {
-                // if we're not near the order position
+                // if we're not near the order position, and not already walking there
                 if (Util::Dist(melee_unit->pos, order_.GetPosition()) > 4)
                 {
-                    // move to it
-                    Micro::SmartMove(melee_unit, order_.GetPosition(), bot_);
+                    if (micro_states_.GetValid(melee_unit, game_loop, policy_))
+                    {
+                        micro_states_.CountReused();
+                    }
+                    else
+                    {
+                        // move to it
+                        MoveToOrderPosition(unit_index);
+                        micro_states_.Record(melee_unit, nullptr, MicroAction::Move, policy_, game_loop, GetDecisionExpiry(melee_unit, nullptr, game_loop));
+                    }
                 }
             }
         }
@@ -91,7 +165,7 @@ const sc2::Unit* MeleeManager::GetTarget(const sc2::Unit* melee_unit, const std:
     const sc2::Unit* best_target = nullptr;
 
     // If our reaper is currently safe, go kill some workers.
-    if (bot_.InformationManager().GetDPSMap()[melee_unit->pos.y][melee_unit->pos.x] < 12)
+    if (bot_.InformationManager().IsSafe(melee_unit))
     {
         for (auto & target_unit : targets)
         {
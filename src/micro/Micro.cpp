@@ -1,11 +1,49 @@
+#include <algorithm>
+#include <cmath>
+
 #include "ByunJRBot.h"
 #include "common/Common.h"
 #include "micro/Micro.h"
 #include "util/Util.h"
+#include "ai/PathCache.h"
 #include "ai/Pathfinding.h"
 
 const float dot_radius = 0.1f;
 
+namespace
+{
+    // How far kiting units step back, and how far units about to die run.
+    const float kite_distance = 2.0f;
+    const float escape_distance = 6.0f;
+
+    // How many waypoints past the one it's walking to a pathing unit has queued up.
+    const size_t queued_waypoints = 3;
+
+    // How far around kiting looks for a way to the target when it's on another level.
+    const int kite_search_radius = 12;
+
+    // How far the target is for kiting, without asking the game.
+    // Straight line distance is right for anything that flies or can jump down cliffs, and for anything on the same level as its target.
+    // Otherwise search the ground around the unit. A target that can't be reached nearby is at least as far as the edge of the search,
+    // which is already too far to be worth kiting.
+    float KiteDistance(const sc2::Unit* unit, const sc2::Point2D & target_position, ByunJRBot & bot)
+    {
+        const float straight = Util::Dist(unit->pos, target_position);
+        if (unit->is_flying || unit->unit_type == sc2::UNIT_TYPEID::TERRAN_REAPER)
+        {
+            return straight;
+        }
+
+        if (std::fabs(bot.Map().TerrainHeight(unit->pos.x, unit->pos.y) - bot.Map().TerrainHeight(target_position.x, target_position.y)) < 0.5f)
+        {
+            return straight;
+        }
+
+        const int ground = bot.Map().GetLocalGroundDistance(unit->pos, target_position, kite_search_radius);
+        return std::max(straight, static_cast<float>(ground < 0 ? kite_search_radius : ground));
+    }
+}
+
 void Micro::SmartAttackUnit(const sc2::Unit* attacker, const sc2::Unit* target, ByunJRBot & bot)
 {
     //UAB_ASSERT(attacker, "SmartAttackUnit: Attacker not valid");
@@ -70,11 +108,33 @@ void Micro::SmartPathfind(const sc2::Unit* unit, const sc2::Point2D & target_pos
         SmartMove(unit, target_position, bot);
         return;
     }
-    Pathfinding p;
-    std::vector<sc2::Point2D> move_path = p.Djikstra(sc2::Point2DI(unit->pos.x, unit->pos.y),
-        sc2::Point2DI(target_position.x, target_position.y),
-        bot.InformationManager().GetDPSMap());
-    SmartMove(unit, move_path[0], bot);
+
+    // Only search again when the old path is no good any more. Most frames there's nothing to do at all.
+    PathCache & paths = bot.Paths();
+    const vvi & cost_map = bot.InformationManager().GetDPSMap();
+    const uint32_t cost_version = bot.InformationManager().GetDPSMapVersion();
+    UnitPath* path = paths.GetValid(unit, target_position, cost_map, cost_version);
+    if (!path)
+    {
+        Pathfinding p;
+        const std::vector<sc2::Point2D> move_path = p.Djikstra(sc2::Point2DI(unit->pos.x, unit->pos.y),
+            sc2::Point2DI(target_position.x, target_position.y), cost_map);
+        path = &paths.Store(unit, target_position, move_path, cost_map, cost_version);
+    }
+
+    // The first waypoint replaces whatever the unit was doing. The next few are queued up behind it,
+    // and topped up as the unit gets through them, so it doesn't stop at every corner.
+    const size_t last = path->waypoints.size() - 1;
+    if (path->sent == 0)
+    {
+        SmartMove(unit, path->waypoints[path->next], bot);
+        path->sent = path->next;
+    }
+    while (path->sent < last && path->sent < path->next + queued_waypoints)
+    {
+        ++path->sent;
+        SmartMove(unit, path->waypoints[path->sent], bot, true);
+    }
 }
 
 void Micro::SmartRunAway(const sc2::Unit* unit, const int run_distance, ByunJRBot & bot)
@@ -176,9 +236,8 @@ void Micro::SmartKiteTarget(const sc2::Unit* ranged_unit, const sc2::Unit* targe
     //}
 
     bool kite(true);
-    //const double dist(bot.Map().GetGroundDistance(ranged_unit->pos, target->pos));
-    const double dist(bot.Query()->PathingDistance(ranged_unit, target->pos));
-    const double speed(bot.Observation()->GetUnitTypeData()[ranged_unit->unit_type].movement_speed);
+    const double dist(KiteDistance(ranged_unit, target->pos, bot));
+    const double speed(bot.UnitTypes().Get(ranged_unit->unit_type).movement_speed);
 
 
     // if the unit can't attack back don't kite
@@ -200,28 +259,21 @@ void Micro::SmartKiteTarget(const sc2::Unit* ranged_unit, const sc2::Unit* targe
         kite = false;
     }
 
-    sc2::Point2D flee_position;
-    if (ranged_unit->health < Util::EnemyDPSInRange(ranged_unit->pos, bot) + 5.0)
+    // Run further if we're about to die.
+    float flee_distance = kite_distance;
+    if (ranged_unit->health < bot.InformationManager().GetDPSAt(ranged_unit) + 5.0)
     {
         kite = true;
-        flee_position = sc2::Point2D(bot.Config().ProxyLocationX, bot.Config().ProxyLocationY);
-        /*SmartRunAway(ranged_unit, 20, bot);
-        return;*/
-    }
-    else
-    {
-        // kite if we are not close to death.
-        flee_position = ranged_unit->pos - target->pos + ranged_unit->pos;
+        flee_distance = escape_distance;
     }
 
     //// if we can't shoot, run away
     if (kite)
     {
-        //fleePosition = rangedUnit->pos - target->pos + rangedUnit->pos;
+        // Downhill on the threat map, so we don't back into another enemy while running from this one.
+        const sc2::Point2D flee_position = bot.InformationManager().GetFleePosition(ranged_unit, target->pos, flee_distance);
         bot.DebugHelper().DrawLine(ranged_unit->pos, flee_position);
-        flee_position = ranged_unit->pos - target->pos + ranged_unit->pos;
         SmartMove(ranged_unit, flee_position, bot);
-        //SmartRunAway(ranged_unit, 20, bot);
     }
     //// otherwise shoot
     else
@@ -0,0 +1,76 @@
+#include "micro/MicroState.h"
+
+namespace
+{
+    // Anything that hasn't been decided for in this many game loops isn't ours to worry about any more.
+    const int stale_loops = 224;
+}
+
+MicroStateCache::MicroStateCache()
+    : decisions_(0)
+    , reused_(0)
+{
+}
+
+const UnitMicroState* MicroStateCache::GetValid(const sc2::Unit* unit, const int game_loop, const CombatPolicy policy) const
+{
+    const auto it = states_.find(unit->tag);
+    if (it == states_.end())
+    {
+        return nullptr;
+    }
+
+    const UnitMicroState & state = it->second;
+    const bool expired = game_loop >= state.expires_at || state.policy != policy;
+    const bool hurt = unit->health + unit->shield < state.hp_at_decision;
+    const bool target_gone = state.target && !state.target->is_alive;
+    const bool idle = state.action != MicroAction::None && unit->orders.empty();
+    if (expired || hurt || target_gone || idle)
+    {
+        return nullptr;
+    }
+
+    return &state;
+}
+
+void MicroStateCache::CountReused()
+{
+    ++reused_;
+}
+
+void MicroStateCache::Record(const sc2::Unit* unit, const sc2::Unit* target, const MicroAction action, const CombatPolicy policy, const int game_loop, const int expires_at)
+{
+    UnitMicroState & state = states_[unit->tag];
+    state.target = target;
+    state.action = action;
+    state.policy = policy;
+    state.hp_at_decision = unit->health + unit->shield;
+    state.decided_at = game_loop;
+    state.expires_at = expires_at;
+    ++decisions_;
+}
+
+void MicroStateCache::Prune(const int game_loop)
+{
+    for (auto it = states_.begin(); it != states_.end(); )
+    {
+        if (game_loop - it->second.decided_at > stale_loops)
+        {
+            it = states_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+size_t MicroStateCache::GetNumDecisions() const
+{
+    return decisions_;
+}
+
+size_t MicroStateCache::GetNumReused() const
+{
+    return reused_;
+}
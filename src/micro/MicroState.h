@@ -0,0 +1,45 @@
+#pragma once
+#include <unordered_map>
+#include <sc2api/sc2_api.h>
+
+#include "micro/CombatSimulator.h"
+
+enum class MicroAction { None, Attack, Kite, Move };
+
+// The last decision micro made for a unit, and how long it's good for.
+struct UnitMicroState
+{
+    const sc2::Unit*    target;
+    MicroAction         action;
+    CombatPolicy        policy;         // the squad policy when we decided
+    float               hp_at_decision; // health + shields, taking damage is a reason to think again
+    int                 decided_at;
+    int                 expires_at;     // game loop after which we decide again no matter what
+};
+
+// Remembers what every combat unit was told to do, so units that are busy shooting or walking somewhere don't get re-decided every frame.
+// A decision is thrown away when it expires, the squad changes policy, the unit gets hurt, its target dies, or it ran out of orders.
+class MicroStateCache
+{
+    std::unordered_map<sc2::Tag, UnitMicroState> states_;
+    size_t  decisions_;
+    size_t  reused_;
+
+public:
+
+    MicroStateCache();
+
+    // The unit's decision, if it still stands. nullptr means decide again.
+    // Callers can still throw a valid decision away, so this doesn't count as reusing it. Call CountReused when it's kept.
+    const UnitMicroState* GetValid(const sc2::Unit* unit, int game_loop, CombatPolicy policy) const;
+    void CountReused();
+
+    void Record(const sc2::Unit* unit, const sc2::Unit* target, MicroAction action, CombatPolicy policy, int game_loop, int expires_at);
+
+    // Drops units we haven't decided anything for in a while: dead, or moved to another squad.
+    void Prune(int game_loop);
+
+    // How many decisions were made and how many were kept instead, since the start of the game.
+    size_t GetNumDecisions() const;
+    size_t GetNumReused() const;
+};
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <chrono>
+
+#include "ByunJRBot.h"
+#include "common/BotAssert.h"
+#include "micro/PortfolioSearch.h"
+
+namespace
+{
+    // The enemy isn't going to play our script. These are the ways we assume they might fight back.
+    const CombatPolicy enemy_responses[] = { CombatPolicy::AttackClosest, CombatPolicy::FocusFire };
+    const size_t num_enemy_responses = sizeof(enemy_responses) / sizeof(enemy_responses[0]);
+
+    // Long enough for most fights to finish, short enough that retreating counts as getting away.
+    const float rollout_seconds = 15.0f;
+}
+
+PortfolioSearch::PortfolioSearch(ByunJRBot & bot)
+    : bot_(bot)
+    , rollouts_finished_(0)
+{
+}
+
+CombatPolicy PortfolioSearch::Search(const std::vector<const sc2::Unit*> & our_units, const std::set<const sc2::Unit*> & enemies,
+                                     const std::vector<CombatPolicy> & portfolio, const CombatPolicy fallback, const double budget_ms)
+{
+    BOT_ASSERT(!portfolio.empty(), "empty portfolio in PortfolioSearch");
+
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point deadline = clock::now() + std::chrono::microseconds(static_cast<long long>(budget_ms * 1000.0));
+
+    // Everything from the bot has to be copied out here, the threads can't touch it.
+    const UnitTypeTable & unit_types = bot_.UnitTypes();
+    setup_.Clear();
+    for (auto & unit : our_units)
+    {
+        setup_.AddOurUnit(unit, unit->pos, unit_types.Get(unit->unit_type));
+    }
+    for (auto & enemy : enemies)
+    {
+        setup_.AddEnemyUnit(enemy, enemy->pos, unit_types.Get(enemy->unit_type));
+    }
+
+    rollouts_finished_ = 0;
+    if (setup_.NumOurUnits() == 0 || setup_.NumEnemyUnits() == 0)
+    {
+        return fallback;
+    }
+
+    const size_t rollouts = portfolio.size() * num_enemy_responses;
+    simulators_.resize(rollouts);
+    scores_.assign(rollouts, 0.0f);
+    finished_.assign(rollouts, 0);
+
+    ThreadPool & pool = bot_.Threads();
+    for (size_t i = 0; i < rollouts; ++i)
+    {
+        const CombatPolicy our_policy = portfolio[i / num_enemy_responses];
+        const CombatPolicy their_policy = enemy_responses[i % num_enemy_responses];
+        pool.Add([this, i, our_policy, their_policy, deadline]()
+        {
+            if (clock::now() > deadline)
+            {
+                return;
+            }
+
+            simulators_[i] = setup_;
+            const CombatResult result = simulators_[i].Simulate(rollout_seconds, our_policy, their_policy);
+            scores_[i] = result.our_value_left - result.their_value_left;
+            finished_[i] = 1;
+        });
+    }
+    pool.Wait();
+
+    // Maximin: a policy is only as good as its worst rollout. A policy missing a rollout might have lost that one,
+    // so comparing it with policies that got every rollout would favour whatever got cut off. Those sit out.
+    CombatPolicy best_policy = fallback;
+    float best_score = 0.0f;
+    bool found = false;
+    for (size_t p = 0; p < portfolio.size(); ++p)
+    {
+        float worst = 0.0f;
+        bool all_finished = true;
+        for (size_t r = 0; r < num_enemy_responses; ++r)
+        {
+            const size_t i = p * num_enemy_responses + r;
+            if (!finished_[i])
+            {
+                all_finished = false;
+                continue;
+            }
+
+            ++rollouts_finished_;
+            worst = r == 0 ? scores_[i] : std::min(worst, scores_[i]);
+        }
+
+        if (all_finished && (!found || worst > best_score))
+        {
+            best_policy = portfolio[p];
+            best_score = worst;
+            found = true;
+        }
+    }
+
+    return best_policy;
+}
+
+size_t PortfolioSearch::GetRolloutsFinished() const
+{
+    return rollouts_finished_;
+}
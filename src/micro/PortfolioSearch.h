@@ -0,0 +1,35 @@
+#pragma once
+#include <set>
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+#include "micro/CombatSimulator.h"
+
+class ByunJRBot;
+
+// Picks how a squad should fight by simulating every policy in a portfolio against a few ways the enemy might respond.
+// The rollouts run on the bot's thread pool. Whatever hasn't started when the time budget runs out is skipped.
+// A policy is scored by its worst result over the enemy responses, and the best score wins.
+// Only policies whose rollouts all finished are compared.
+class PortfolioSearch
+{
+    ByunJRBot &                 bot_;
+
+    CombatSimulator             setup_;
+    std::vector<CombatSimulator> simulators_;  // one per rollout, so the threads never share one
+    std::vector<float>          scores_;
+    std::vector<char>           finished_;
+    size_t                      rollouts_finished_;
+
+public:
+
+    PortfolioSearch(ByunJRBot & bot);
+
+    // portfolio must not be empty. fallback is returned when no policy got all its rollouts done in time,
+    // pass the policy the units are already using so they don't switch on a guess.
+    CombatPolicy Search(const std::vector<const sc2::Unit*> & our_units, const std::set<const sc2::Unit*> & enemies,
+                        const std::vector<CombatPolicy> & portfolio, CombatPolicy fallback, double budget_ms);
+
+    // How many rollouts made it in under the budget last time.
+    size_t GetRolloutsFinished() const;
+};
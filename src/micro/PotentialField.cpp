@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cmath>
+
+#include "information/ThreatMap.h"
+#include "information/UnitArrays.h"
+#include "micro/PotentialField.h"
+#include "util/DistanceKernels.h"
+
+namespace
+{
+    // How hard each of the three pulls. The goal pull is always 1 (until the unit gets there), so these are compared to that.
+    const float threat_weight = 1.0f;
+    const float separation_weight = 0.8f;
+
+    // Friendly units closer than this push each other apart. A bit more than two marines side by side.
+    const float separation_radius = 1.25f;
+
+    // How far around each unit the threat map is looked at.
+    const float threat_lookahead = 4.0f;
+
+    // The threat push is gradient / (|gradient| + threat_dps_scale), so it never gets longer than 1.
+    // About two marines worth of dps is where it gets to half.
+    const float threat_dps_scale = 20.0f;
+
+    // Units slow down this close to the goal, instead of running past it and turning around.
+    const float arrive_distance = 1.0f;
+}
+
+void PotentialField::Clear()
+{
+    x_.clear();
+    y_.clear();
+    flying_.clear();
+    goal_x_.clear();
+    goal_y_.clear();
+}
+
+void PotentialField::Add(const sc2::Unit* unit, const sc2::Point2D & goal)
+{
+    Add(unit->pos, unit->is_flying, goal);
+}
+
+void PotentialField::Add(const sc2::Point2D & pos, const bool flying, const sc2::Point2D & goal)
+{
+    x_.push_back(pos.x);
+    y_.push_back(pos.y);
+    flying_.push_back(flying ? 1 : 0);
+    goal_x_.push_back(goal.x);
+    goal_y_.push_back(goal.y);
+}
+
+size_t PotentialField::size() const
+{
+    return x_.size();
+}
+
+bool PotentialField::empty() const
+{
+    return x_.empty();
+}
+
+void PotentialField::Compute(const UnitArrays & friendly, const ThreatMap & threats)
+{
+    Compute(friendly.X(), friendly.Y(), friendly.Flags(), friendly.size(), threats);
+}
+
+void PotentialField::Compute(const float* x, const float* y, const uint32_t* flags, const size_t n, const ThreatMap & threats)
+{
+    const size_t num_units = x_.size();
+    threat_x_.resize(num_units);
+    threat_y_.resize(num_units);
+    push_x_.assign(num_units, 0.0f);
+    push_y_.assign(num_units, 0.0f);
+    steer_x_.resize(num_units);
+    steer_y_.resize(num_units);
+
+    AddSeparation(false, x, y, flags, n);
+    AddSeparation(true, x, y, flags, n);
+
+    // The threat map is a grid lookup per sample, there's nothing to gain from doing it wide.
+    for (size_t i = 0; i < num_units; ++i)
+    {
+        const sc2::Point2D gradient = threats.GetThreatGradient(sc2::Point2D(x_[i], y_[i]), flying_[i] != 0, threat_lookahead);
+        const float scale = -1.0f / (std::sqrt(gradient.x * gradient.x + gradient.y * gradient.y) + threat_dps_scale);
+        threat_x_[i] = gradient.x * scale;
+        threat_y_[i] = gradient.y * scale;
+    }
+
+    // Plain loop over flat arrays with no branches the compiler can't turn into selects, so it gets vectorized.
+    for (size_t i = 0; i < num_units; ++i)
+    {
+        const float to_goal_x = goal_x_[i] - x_[i];
+        const float to_goal_y = goal_y_[i] - y_[i];
+        const float goal_distance = std::sqrt(to_goal_x * to_goal_x + to_goal_y * to_goal_y);
+        const float pull = 1.0f / std::max(goal_distance, arrive_distance);
+
+        const float sx = to_goal_x * pull + threat_x_[i] * threat_weight + push_x_[i] * separation_weight;
+        const float sy = to_goal_y * pull + threat_y_[i] * threat_weight + push_y_[i] * separation_weight;
+        const float length = std::sqrt(sx * sx + sy * sy);
+        const float clamp = 1.0f / std::max(length, 1.0f);
+        steer_x_[i] = sx * clamp;
+        steer_y_[i] = sy * clamp;
+    }
+}
+
+// Only friendly units around the group can push it, so those are picked out first with FindInRadius,
+// and the group is only pushed by them instead of by the whole army.
+void PotentialField::AddSeparation(const bool flying, const float* x, const float* y, const uint32_t* flags, const size_t n)
+{
+    layer_.clear();
+    layer_x_.clear();
+    layer_y_.clear();
+    sc2::Point2D center(0.0f, 0.0f);
+    for (size_t i = 0; i < x_.size(); ++i)
+    {
+        if ((flying_[i] != 0) != flying) { continue; }
+
+        layer_.push_back(static_cast<uint32_t>(i));
+        layer_x_.push_back(x_[i]);
+        layer_y_.push_back(y_[i]);
+        center.x += x_[i];
+        center.y += y_[i];
+    }
+
+    if (layer_.empty() || n == 0)
+    {
+        return;
+    }
+
+    center.x /= layer_.size();
+    center.y /= layer_.size();
+    float spread_sq = 0.0f;
+    for (size_t k = 0; k < layer_.size(); ++k)
+    {
+        const float dx = layer_x_[k] - center.x;
+        const float dy = layer_y_[k] - center.y;
+        spread_sq = std::max(spread_sq, dx * dx + dy * dy);
+    }
+
+    nearby_.resize(n);
+    const size_t found = DistanceKernels::FindInRadius(center, std::sqrt(spread_sq) + separation_radius, x, y, n, nearby_.data());
+
+    // Buildings are big and don't move. Walking around them is the game's job.
+    friend_x_.clear();
+    friend_y_.clear();
+    for (size_t f = 0; f < found; ++f)
+    {
+        const uint32_t j = nearby_[f];
+        if (flags[j] & UnitArrayFlag::Building) { continue; }
+        if (((flags[j] & UnitArrayFlag::Flying) != 0) != flying) { continue; }
+
+        friend_x_.push_back(x[j]);
+        friend_y_.push_back(y[j]);
+    }
+
+    layer_push_x_.assign(layer_.size(), 0.0f);
+    layer_push_y_.assign(layer_.size(), 0.0f);
+    DistanceKernels::Separation(layer_x_.data(), layer_y_.data(), layer_.size(),
+                                friend_x_.data(), friend_y_.data(), friend_x_.size(),
+                                separation_radius, layer_push_x_.data(), layer_push_y_.data());
+
+    for (size_t k = 0; k < layer_.size(); ++k)
+    {
+        push_x_[layer_[k]] += layer_push_x_[k];
+        push_y_[layer_[k]] += layer_push_y_[k];
+    }
+}
+
+sc2::Point2D PotentialField::GetSteering(const size_t i) const
+{
+    return sc2::Point2D(steer_x_[i], steer_y_[i]);
+}
+
+sc2::Point2D PotentialField::GetMovePosition(const size_t i, const float distance) const
+{
+    return sc2::Point2D(x_[i] + steer_x_[i] * distance, y_[i] + steer_y_[i] * distance);
+}
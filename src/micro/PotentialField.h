@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+class ThreatMap;
+class UnitArrays;
+
+// Steering for a whole group of units, worked out for all of them at once.
+// Every unit is pulled toward its goal, pushed down the threat map, and pushed away from friendly units that are too close.
+// The three add up to one direction per unit, so units walk around danger and spread out instead of bumping into each other.
+// No pathfinding though. It only looks a few tiles around each unit, so walls between the unit and its goal are still a problem.
+class PotentialField
+{
+    // The group, in flat arrays like UnitArrays.
+    std::vector<float>              x_;
+    std::vector<float>              y_;
+    std::vector<char>               flying_;
+    std::vector<float>              goal_x_;
+    std::vector<float>              goal_y_;
+    std::vector<float>              threat_x_;
+    std::vector<float>              threat_y_;
+    std::vector<float>              push_x_;
+    std::vector<float>              push_y_;
+    std::vector<float>              steer_x_;
+    std::vector<float>              steer_y_;
+
+    // Scratch for separating one layer at a time. Ground units only bump into ground units, air into air.
+    std::vector<uint32_t>           layer_;
+    std::vector<float>              layer_x_;
+    std::vector<float>              layer_y_;
+    std::vector<float>              layer_push_x_;
+    std::vector<float>              layer_push_y_;
+    std::vector<uint32_t>           nearby_;
+    std::vector<float>              friend_x_;
+    std::vector<float>              friend_y_;
+
+    void AddSeparation(bool flying, const float* x, const float* y, const uint32_t* flags, size_t n);
+    void Compute(const float* x, const float* y, const uint32_t* flags, size_t n, const ThreatMap & threats);
+
+public:
+
+    void Clear();
+    void Add(const sc2::Unit* unit, const sc2::Point2D & goal);
+    void Add(const sc2::Point2D & pos, bool flying, const sc2::Point2D & goal);
+
+    size_t size() const;
+    bool empty() const;
+
+    // friendly is everyone who can get bumped into, usually all of our units. The group itself can be in there too.
+    void Compute(const UnitArrays & friendly, const ThreatMap & threats);
+
+    // Which way unit i should go, as long as 1 when it should go full speed. (0, 0) at the goal with nothing pushing it.
+    sc2::Point2D GetSteering(size_t i) const;
+
+    // Where to send unit i to follow the steering, distance tiles ahead at full speed.
+    sc2::Point2D GetMovePosition(size_t i, float distance) const;
+};
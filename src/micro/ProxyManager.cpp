@@ -73,10 +73,9 @@ bool ProxyManager::MoveProxyWorkers()
         proxy_worker_ = bot_.InformationManager().GetBuilder(b, false);
         bot_.InformationManager().UnitInfo().SetJob(proxy_worker_, UnitMission::Proxy);
     }
-    for (const auto & unit : bot_.InformationManager().UnitInfo().GetWorkers())
+    for (const auto & unit : bot_.InformationManager().UnitInfo().GetUnitsWithMission(UnitMission::Proxy))
     {
-        if(unit->mission == UnitMission::Proxy)
-            Micro::SmartMove(unit->unit, sc2::Point2D(my_vec.x, my_vec.y), bot_);
+        Micro::SmartMove(unit->unit, sc2::Point2D(my_vec.x, my_vec.y), bot_);
     }
 
     return true;
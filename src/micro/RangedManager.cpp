@@ -1,8 +1,20 @@
+#include <algorithm>
+#include <functional>
+
 #include "ByunJRBot.h"
 #include "common/BotAssert.h"
 #include "micro/RangedManager.h"
 #include "util/Util.h"
 
+namespace
+{
+    // How far from a safe unit we go looking for workers to pick off.
+    const float harass_radius = 7.0f;
+
+    // Targets this much past our range still count as nearby, we'd only have to take a step.
+    const float reach_margin = 2.0f;
+}
+
 RangedManager::RangedManager(ByunJRBot & bot)
     : CombatMicroManager(bot)
 {
@@ -11,33 +23,72 @@ RangedManager::RangedManager(ByunJRBot & bot)
 
 void RangedManager::ExecuteMicro(const std::set<const sc2::Unit*> & targets)
 {
+    // The first policy is what we always did before, and what we fall back to when the search runs out of time.
+    std::vector<CombatPolicy> portfolio;
+    portfolio.push_back(bot_.Config().KiteWithRangedUnits ? CombatPolicy::Kite : CombatPolicy::AttackClosest);
+    portfolio.push_back(CombatPolicy::FocusFire);
+    portfolio.push_back(CombatPolicy::Flank);
+    portfolio.push_back(CombatPolicy::Retreat);
+
+    ChoosePolicy(targets, portfolio);
     AssignTargets(targets);
 }
 
-void RangedManager::AssignTargets(const std::set<const sc2::Unit*> & targets) const
+void RangedManager::AssignTargets(const std::set<const sc2::Unit*> & targets)
 {
     const std::vector<const sc2::Unit*> & ranged_units = GetUnits();
 
-    // figure out targets
-    std::vector<const sc2::Unit*> ranged_unit_targets;
+    const int game_loop = static_cast<int>(bot_.Observation()->GetGameLoop());
 
+    // Score every target once for the whole squad, instead of once per unit.
+    ScoreTargets(targets);
 
-    // Zerg eggs are a pain in the butt to kill. Don't bother.
-    for (auto & target : targets)
+    // Everyone who walks this frame walks through the same field: home when we're running, along the squad's path otherwise.
+    const bool retreating = policy_ == CombatPolicy::Retreat && !target_infos_.empty();
+    Steer(retreating);
+
+    // Focus fire goes for whatever has the least health left once the volleys already counted land.
+    const std::function<float(const sc2::Unit*)> hp_left = [this](const sc2::Unit* target)
     {
-        if (!target) { continue; }
-        if (target->unit_type == sc2::UNIT_TYPEID::ZERG_EGG) { continue; }
-        if (target->unit_type == sc2::UNIT_TYPEID::ZERG_LARVA) { continue; }
+        const auto it = target_index_.find(target);
+        return it == target_index_.end() ? 0.0f : target_infos_[it->second].hp_left;
+    };
+
+    // Units that are still busy with what they were told keep doing it.
+    // Their shots still count against their targets, so that has to be done before anyone else picks one.
+    std::vector<char> still_busy(ranged_units.size(), 0);
+    for (size_t unit_index = 0; unit_index < ranged_units.size(); ++unit_index)
+    {
+        const UnitMicroState* state = micro_states_.GetValid(ranged_units[unit_index], game_loop, policy_);
+        if (!state)
+        {
+            continue;
+        }
+
+        // We were just walking, but now there's something to shoot. Unless we're walking away from it.
+        if (!state->target)
+        {
+            still_busy[unit_index] = target_infos_.empty() || retreating;
+            continue;
+        }
 
-        ranged_unit_targets.push_back(target);
+        const auto it = target_index_.find(state->target);
+        if (it != target_index_.end() && target_infos_[it->second].hp_left > 0.0f)
+        {
+            CountVolley(ranged_units[unit_index], target_infos_[it->second]);
+            still_busy[unit_index] = 1;
+        }
     }
 
     // for each ranged_unit
-    for (auto & ranged_unit : ranged_units)
+    for (size_t unit_index = 0; unit_index < ranged_units.size(); ++unit_index)
     {
-        // Run away with the cattlebruisers!
+        const sc2::Unit* ranged_unit = ranged_units[unit_index];
+
+        // Run away with the cattlebruisers! No point jumping away if nothing around can shoot up.
         if (ranged_unit->unit_type == sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER
-            && ranged_unit->health < ranged_unit->health_max / 5)
+            && ranged_unit->health < ranged_unit->health_max / 5
+            && bot_.InformationManager().GetDPSAt(ranged_unit) > 0.0f)
         {
             bot_.Actions()->UnitCommand(ranged_unit, sc2::ABILITY_ID::EFFECT_TACTICALJUMP,
                 bot_.Bases().GetPlayerStartingBaseLocation(PlayerArrayIndex::Self)->GetPosition());
@@ -48,31 +99,71 @@ void RangedManager::AssignTargets(const std::set<const sc2::Unit*> & targets) co
         // if the order is to attack or defend
         if (order_.GetType() == SquadOrderTypes::Attack || order_.GetType() == SquadOrderTypes::Defend)
         {
-            if (!ranged_unit_targets.empty() && GetTarget(ranged_unit, ranged_unit_targets))
+            // The search thinks we lose this one whatever we do.
+            if (retreating)
+            {
+                if (still_busy[unit_index])
+                {
+                    micro_states_.CountReused();
+                }
+                else
+                {
+                    Micro::SmartMove(ranged_unit, GetSteeredPosition(unit_index), bot_);
+                    micro_states_.Record(ranged_unit, nullptr, MicroAction::Move, policy_, game_loop, GetDecisionExpiry(ranged_unit, nullptr, game_loop));
+                }
+                continue;
+            }
+
+            if (still_busy[unit_index])
             {
-                // find the best target for this meleeUnit
-                const sc2::Unit* target = GetTarget(ranged_unit, ranged_unit_targets);
+                micro_states_.CountReused();
+                continue;
+            }
 
-                // Sometimes we won't find a unit to attack. 
-                if (!target)
-                    continue;
+            // find the best target for this ranged unit
+            const sc2::Unit* target = target_infos_.empty() ? nullptr : GetTarget(ranged_unit);
 
-                if(ranged_unit->unit_type == sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER)
+            if (target)
+            {
+                const sc2::Unit* focus_target = policy_ == CombatPolicy::FocusFire ? GetFocusFireTarget(ranged_unit, hp_left) : nullptr;
+
+                MicroAction action = MicroAction::Attack;
+                if (focus_target)
+                {
+                    target = focus_target;
+                    Micro::SmartAttackUnit(ranged_unit, focus_target, bot_);
+                }
+                else if (IsFlanker(unit_index) && Util::Dist(ranged_unit->pos, target->pos) > Util::GetAttackRange(ranged_unit->unit_type, bot_) + 2.0f)
+                {
+                    action = MicroAction::Move;
+                    Micro::SmartMove(ranged_unit, GetFlankPosition(ranged_unit, unit_index, target), bot_);
+                }
+                else if(ranged_unit->unit_type == sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER)
                 {
                     Micro::SmartAttackUnit(ranged_unit, target, bot_);
                     // YAMATO THOSE GUYS WHO CAN SHOOT US!
-                    if(Util::CanAttackAir(bot_.Observation()->GetUnitTypeData()[target->unit_type].weapons))
+                    if(Util::CanAttackAir(target->unit_type, bot_))
                         bot_.Actions()->UnitCommand(ranged_unit, sc2::ABILITY_ID::EFFECT_YAMATOGUN, target);
                 }
                 // attack it
-                else if (bot_.Config().KiteWithRangedUnits)
+                else if (policy_ == CombatPolicy::Kite)
                 {
+                    action = MicroAction::Kite;
                     Micro::SmartKiteTarget(ranged_unit, target, bot_);
                 }
                 else
                 {
                     Micro::SmartAttackUnit(ranged_unit, target, bot_);
                 }
+
+                // Now that we know what the unit is doing, its shot goes against the target it's actually shooting.
+                const auto it = target_index_.find(target);
+                if (action != MicroAction::Move && it != target_index_.end())
+                {
+                    CountVolley(ranged_unit, target_infos_[it->second]);
+                }
+
+                micro_states_.Record(ranged_unit, target, action, policy_, game_loop, GetDecisionExpiry(ranged_unit, target, game_loop));
             }
             // if there are no targets
             else
@@ -81,7 +172,8 @@ void RangedManager::AssignTargets(const std::set<const sc2::Unit*> & targets) co
                 if (Util::Dist(ranged_unit->pos, order_.GetPosition()) > 4)
                 {
                     // move to it
-                    Micro::SmartMove(ranged_unit, order_.GetPosition(), bot_);
+                    MoveToOrderPosition(unit_index);
+                    micro_states_.Record(ranged_unit, nullptr, MicroAction::Move, policy_, game_loop, GetDecisionExpiry(ranged_unit, nullptr, game_loop));
                 }
             }
         }
@@ -93,97 +185,172 @@ void RangedManager::AssignTargets(const std::set<const sc2::Unit*> & targets) co
     }
 }
 
-// get a target for the ranged unit to attack
-// TODO: this is the melee targeting code, replace it with something better for ranged units
-const sc2::Unit* RangedManager::GetTarget(const sc2::Unit* ranged_unit, const std::vector<const sc2::Unit*> & targets) const
+// Everything about a target that doesn't depend on who is shooting at it, worked out once per frame.
+void RangedManager::ScoreTargets(const std::set<const sc2::Unit*> & targets)
+{
+    target_infos_.clear();
+    target_index_.clear();
+    priorities_.clear();
+
+    const UnitTypeTable & unit_types = bot_.UnitTypes();
+    const bool too_early_for_buildings = Util::GetGameTimeInSeconds(bot_) < 400;
+
+    for (auto & target : targets)
+    {
+        if (!target) { continue; }
+
+        // Zerg eggs are a pain in the butt to kill. Don't bother.
+        if (target->unit_type == sc2::UNIT_TYPEID::ZERG_EGG) { continue; }
+        if (target->unit_type == sc2::UNIT_TYPEID::ZERG_LARVA) { continue; }
+
+        const UnitTypeTraits & traits = unit_types.Get(target->unit_type);
+
+        // Don't waste time killing buildings until we have a good chance of winning the game from all the workers we have killed
+        if (traits.is_building && too_early_for_buildings) { continue; }
+
+        // If there are ranged units on high ground we can't see, we can't attack them back.
+        if (!bot_.Map().IsVisible(target->pos) && traits.is_combat_unit) { continue; }
+
+        TargetInfo info;
+        info.unit = target;
+        info.priority = GetAttackPriority(target);
+        info.hp_left = target->health + target->shield;
+        info.is_worker = traits.is_worker;
+        info.can_attack_air = traits.can_attack_air;
+
+        target_index_[target] = target_infos_.size();
+        target_infos_.push_back(info);
+        priorities_.push_back(info.priority);
+    }
+
+    std::sort(priorities_.begin(), priorities_.end(), std::greater<int>());
+    priorities_.erase(std::unique(priorities_.begin(), priorities_.end()), priorities_.end());
+}
+
+// Picks a target for the ranged unit out of the scored ones.
+// Targets that already have enough damage coming to kill them are skipped, so the rest of the squad shoots something else.
+// The volley isn't counted here, the unit might end up doing something else. AssignTargets counts it once it knows.
+const sc2::Unit* RangedManager::GetTarget(const sc2::Unit* ranged_unit)
 {
     BOT_ASSERT(ranged_unit, "null ranged unit in getTarget");
 
-    int lowest_health = std::numeric_limits<int>::max();
-    int high_priority = std::numeric_limits<int>::max();
-    double closest_dist = std::numeric_limits<double>::max();
-    const sc2::Unit* best_target = nullptr;
+    const UnitTypeTraits & traits = bot_.UnitTypes().Get(ranged_unit->unit_type);
+    const bool is_battlecruiser = ranged_unit->unit_type == sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER;
+
+    // If our reaper is currently safe, go kill some workers. Battlecruisers go after whatever can shoot them instead.
+    const bool safe = bot_.InformationManager().IsSafe(ranged_unit);
+
+    // Only the grid cells around the unit are looked at, not every target.
+    const float search_radius = std::max(traits.max_range + ranged_unit->radius + reach_margin, harass_radius);
+    const std::vector<const sc2::Unit*> nearby = bot_.InformationManager().UnitInfo().GetUnitGrid(PlayerArrayIndex::Enemy).GetInRadius(ranged_unit->pos, search_radius);
+
+    TargetInfo* best_harass = nullptr;
+    TargetInfo* best = nullptr;
+    bool best_in_range = false;
+    float best_distance = 0.0f;
 
-    // If our reaper is currently safe, go kill some workers.
-    if (bot_.InformationManager().GetDPSMap()[ranged_unit->pos.y][ranged_unit->pos.x] < 12)
+    for (auto & enemy : nearby)
     {
-        for(auto & target_unit : targets)
+        const auto it = target_index_.find(enemy);
+        if (it == target_index_.end()) { continue; }
+
+        TargetInfo & info = target_infos_[it->second];
+
+        // Enough damage is already on its way to kill it.
+        if (info.hp_left <= 0.0f) { continue; }
+
+        // Don't bother attacking units that we can not hit.
+        if (enemy->is_flying ? !traits.can_attack_air : !traits.can_attack_ground) { continue; }
+
+        const float distance = Util::Dist(ranged_unit->pos, enemy->pos);
+
+        if (safe && distance <= harass_radius && (is_battlecruiser ? info.can_attack_air : info.is_worker))
         {
-            if(Util::IsWorker(target_unit))
+            if (!best_harass || info.hp_left < best_harass->hp_left)
             {
-                const float distance = Util::Dist(ranged_unit->pos, target_unit->pos);
-
-                // Only look for workers that are close to the reaper. 
-                if (distance > 7) continue;
-                if (!best_target || target_unit->health < lowest_health)
-                {
-                    lowest_health = target_unit->health;
-                    best_target = target_unit;
-                }
+                best_harass = &info;
             }
         }
-    }
 
-    if (bot_.InformationManager().GetDPSMap()[ranged_unit->pos.y][ranged_unit->pos.x] < 12)
-    {
-        for (auto & target_unit : targets)
+        // Highest priority first. Then finish off whatever we can already shoot that has the least health left, and otherwise go for the closest.
+        const float range = (enemy->is_flying ? traits.air_range : traits.ground_range) + ranged_unit->radius + enemy->radius;
+        const bool in_range = distance <= range;
+        bool better = !best || info.priority > best->priority;
+        if (best && info.priority == best->priority)
         {
-            if (ranged_unit->unit_type == sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER)
+            if (in_range != best_in_range)
             {
-                const float distance = Util::Dist(ranged_unit->pos, target_unit->pos);
-
-                // Only look for workers that are close to the battlecruiser. 
-                if (distance > 7) continue;
-                // Prioritise the units that can attack us. Otherwise we can simply use the generic code to find a target. 
-                if (!Util::CanAttackAir(bot_.Observation()->GetUnitTypeData()[target_unit->unit_type].weapons))
-                    continue;
-                if (!best_target || target_unit->health+target_unit->shield < lowest_health)
-                {
-                    lowest_health = target_unit->health+target_unit->shield;
-                    best_target = target_unit;
-                }
+                better = in_range;
+            }
+            else
+            {
+                better = in_range ? info.hp_left < best->hp_left : distance < best_distance;
             }
         }
+
+        if (better)
+        {
+            best = &info;
+            best_in_range = in_range;
+            best_distance = distance;
+        }
     }
-    // The reaper is safe and has a low health worker it wants to attack. 
-    if (best_target) return best_target;
 
-    // for each target possiblity
-    for (auto & target_unit : targets)
+    if (best_harass)
     {
-        BOT_ASSERT(target_unit, "null target unit in getTarget");
+        best = best_harass;
+    }
 
-        const int priority = GetAttackPriority(ranged_unit, target_unit);
-        const float distance = Util::Dist(ranged_unit->pos, target_unit->pos);
-        int f = bot_.Observation()->GetGameLoop();
+    if (best)
+    {
+        return best->unit;
+    }
 
-        // Don't waste time killing buildings until we have a good chance of winning the game from all the workers we have killed
-        if(Util::IsBuilding(target_unit->unit_type) && Util::GetGameTimeInSeconds(bot_) < 400)
-            continue;
+    // Nothing close by. Walk to the closest target of the highest priority there is, like before.
+    const UnitGrid & enemy_grid = bot_.InformationManager().UnitInfo().GetUnitGrid(PlayerArrayIndex::Enemy);
+    for (const int priority : priorities_)
+    {
+        const sc2::Unit* closest = enemy_grid.GetClosest(ranged_unit->pos, [this, &traits, priority](const sc2::Unit* enemy)
+        {
+            const auto it = target_index_.find(enemy);
+            if (it == target_index_.end())
+            {
+                return false;
+            }
 
-        // Don't bother attacking units that we can not hit. 
-        if (target_unit->is_flying && !Util::CanAttackAir(bot_.Observation()->GetUnitTypeData()[ranged_unit->unit_type].weapons))
-            continue;
+            const TargetInfo & info = target_infos_[it->second];
+            return info.priority == priority && info.hp_left > 0.0f && (enemy->is_flying ? traits.can_attack_air : traits.can_attack_ground);
+        });
 
-        // If there are ranged units on high ground we can't see, we can't attack them back.
-        if(!bot_.Map().IsVisible(target_unit->pos) && Util::IsCombatUnit(target_unit))
-            continue;
-        
-        if (!best_target || (priority > high_priority) || (priority == high_priority && distance < closest_dist))
+        if (closest)
         {
-            closest_dist = distance;
-            high_priority = priority;
-            best_target = target_unit;
+            return closest;
         }
     }
 
-    return best_target;
+    return nullptr;
+}
+
+// Takes the volley the ranged unit is about to fire off the target's health left.
+// Only if we're about to fire though. A unit that still has to walk there, or is waiting on its weapon, won't be shooting this frame.
+void RangedManager::CountVolley(const sc2::Unit* ranged_unit, TargetInfo & target) const
+{
+    if (ranged_unit->weapon_cooldown > 0.0f)
+    {
+        return;
+    }
+
+    const UnitTypeTraits & traits = bot_.UnitTypes().Get(ranged_unit->unit_type);
+    const float range = (target.unit->is_flying ? traits.air_range : traits.ground_range) + ranged_unit->radius + target.unit->radius;
+    if (Util::Dist(ranged_unit->pos, target.unit->pos) <= range)
+    {
+        target.hp_left -= traits.max_damage;
+    }
 }
 
 // get the attack priority of a type in relation to a zergling
-int RangedManager::GetAttackPriority(const sc2::Unit* attacker, const sc2::Unit* unit_tag) const
+int RangedManager::GetAttackPriority(const sc2::Unit* unit) const
 {
-    auto unit = unit_tag;
     BOT_ASSERT(unit, "null unit in getAttackPriority");
 
     if (Util::IsCombatUnit(unit))
@@ -198,4 +365,3 @@ int RangedManager::GetAttackPriority(const sc2::Unit* attacker, const sc2::Unit*
 
     return 1;
 }
-
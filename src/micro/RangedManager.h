@@ -1,15 +1,33 @@
 #pragma once
+#include <unordered_map>
+
 #include "micro/CombatMicroManager.h"
 
 class ByunJRBot;
 
 class RangedManager: public CombatMicroManager
 {
+    struct TargetInfo
+    {
+        const sc2::Unit*    unit;
+        int                 priority;
+        float               hp_left;        // health + shields, minus the damage the squad already has on the way this frame
+        bool                is_worker;
+        bool                can_attack_air;
+    };
+
+    std::vector<TargetInfo>                         target_infos_;
+    std::unordered_map<const sc2::Unit*, size_t>    target_index_;
+    std::vector<int>                                priorities_;    // every priority among the targets, highest first
+
+    void    ScoreTargets(const std::set<const sc2::Unit*> & targets);
+    void    CountVolley(const sc2::Unit* ranged_unit, TargetInfo & target) const;
+
 public:
     
     RangedManager(ByunJRBot & bot);
     void    ExecuteMicro(const std::set<const sc2::Unit*> & targets) override;
-    void    AssignTargets(const std::set<const sc2::Unit*> & targets) const;
-    int     GetAttackPriority(const sc2::Unit* ranged_unit, const sc2::Unit* target) const;
-    const sc2::Unit* GetTarget(const sc2::Unit* ranged_unit, const std::vector<const sc2::Unit*> & targets) const;
+    void    AssignTargets(const std::set<const sc2::Unit*> & targets);
+    int     GetAttackPriority(const sc2::Unit* target) const;
+    const sc2::Unit* GetTarget(const sc2::Unit* ranged_unit);
 };
@@ -41,8 +41,9 @@ void ScoutManager::DrawScoutInformation() const
 
 void ScoutManager::MoveScouts()
 {
-    // Setup shorthand for bot_.InformationManager().UnitInfo().GetScouts(),
-    const std::set<const UnitInfo*> & scout_units = bot_.InformationManager().UnitInfo().GetScouts();
+    // A copy, not a reference. Scouts that find the enemy base get their job changed inside the loop.
+    // Changing jobs only moves units between groups, not in the slot map, so the pointers stay good for the rest of the loop.
+    const std::vector<const UnitInfo*> scout_units = bot_.InformationManager().UnitInfo().GetScouts().GetUnits();
 
     // No need to print an error message. Sometimes we don't need any scouts for our current strategy.
     if (scout_units.size() == 0) { return; }
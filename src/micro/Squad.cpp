@@ -1,17 +1,43 @@
+#include <sstream>
+
 #include "ByunJRBot.h"
 #include "common/BotAssert.h"
 #include "common/Common.h"
 #include "micro/Squad.h"
 #include "util/Util.h"
 
+namespace
+{
+    // How often the squad simulates the fight it's in, in game loops. The simulator is cheap, but not free.
+    const int regroup_check_interval = 8;
+
+    // Once we've switched between attacking and retreating, stick with it for a bit so units don't dance back and forth.
+    const int regroup_switch_delay = 45;
+
+    // While retreating we only turn back around if we'd win by this much. In between, we hold whatever we were doing.
+    const float regroup_attack_margin = 0.2f;
+
+    // A retreating squad that has lost contact keeps retreating this long (5 seconds), so it doesn't turn straight back into the enemy.
+    const int regroup_disengage_delay = 112;
+
+    const float regroup_enemy_radius = 20.0f;
+    const float regroup_simulation_seconds = 20.0f;
+
+    // How far from the regroup position an enemy army has to be for the formation to face it.
+    const float formation_enemy_radius = 30.0f;
+}
+
 Squad::Squad(ByunJRBot & bot)
     : bot_(bot)
     , last_retreat_switch_(0)
     , last_retreat_switch_val_(false)
+    , last_regroup_check_(0)
+    , last_contact_(0)
     , priority_(0)
     , name_("Default")
     , melee_manager_(bot)
     , ranged_manager_(bot)
+    , squad_path_(bot)
 {
 
 }
@@ -22,9 +48,12 @@ Squad::Squad(const std::string & name, const SquadOrder & order, const size_t pr
     , order_(order)
     , last_retreat_switch_(0)
     , last_retreat_switch_val_(false)
+    , last_regroup_check_(0)
+    , last_contact_(0)
     , priority_(priority)
     , melee_manager_(bot)
     , ranged_manager_(bot)
+    , squad_path_(bot)
 {
 }
 
@@ -43,13 +72,17 @@ void Squad::OnFrame()
 
         bot_.DebugHelper().DrawSphere(regroup_position, 3, sc2::Colors::Purple);
 
-        melee_manager_.Regroup(regroup_position);
-        ranged_manager_.Regroup(regroup_position);
+        // One formation for the whole squad, melee and ranged together.
+        UpdateFormation(regroup_position);
+        melee_manager_.Regroup(formation_);
+        ranged_manager_.Regroup(formation_);
     }
     else // otherwise, execute micro
     {
-        melee_manager_.Execute(order_);
-        ranged_manager_.Execute(order_);
+        // One path for the whole squad, melee and ranged together.
+        squad_path_.Update(units_, order_.GetPosition());
+        melee_manager_.Execute(order_, squad_path_);
+        ranged_manager_.Execute(order_, squad_path_);
 
         //_detectorManager.setUnitClosestToEnemy(unitClosestToEnemy());
         //_detectorManager.execute(_order);
@@ -146,10 +179,79 @@ void Squad::AddUnitsToMicroManagers()
     //m_tankManager.setUnits(tankUnits);
 }
 
-// TODO: calculates whether or not to regroup
-bool Squad::NeedsToRegroup() const
+// Simulates the squad units that are near enemies against the enemies near them, and retreats if we'd lose.
+bool Squad::NeedsToRegroup()
 {
-    return false;
+    const int game_loop = static_cast<int>(bot_.Observation()->GetGameLoop());
+    if (game_loop - last_regroup_check_ < regroup_check_interval || game_loop - last_retreat_switch_ < regroup_switch_delay)
+    {
+        return last_retreat_switch_val_;
+    }
+    last_regroup_check_ = game_loop;
+
+    const UnitTypeTable & unit_types = bot_.UnitTypes();
+    const UnitGrid & enemy_grid = bot_.InformationManager().UnitInfo().GetUnitGrid(PlayerArrayIndex::Enemy);
+    std::set<const sc2::Unit*> enemies;
+
+    simulator_.Clear();
+    for (auto & unit : units_)
+    {
+        if (!near_enemy_.at(unit->tag))
+        {
+            continue;
+        }
+
+        simulator_.AddOurUnit(unit, unit->pos, unit_types.Get(unit->unit_type));
+        for (auto & enemy : enemy_grid.GetInRadius(unit->pos, regroup_enemy_radius))
+        {
+            if (enemies.insert(enemy).second)
+            {
+                simulator_.AddEnemyUnit(enemy, enemy->pos, unit_types.Get(enemy->unit_type));
+            }
+        }
+    }
+
+    bool retreat = last_retreat_switch_val_;
+    if (simulator_.NumOurUnits() == 0 || simulator_.NumEnemyUnits() == 0)
+    {
+        // Running away is what broke contact, so keep going for a bit before we call it over.
+        if (retreat && game_loop - last_contact_ < regroup_disengage_delay)
+        {
+            regroup_status_ = "Retreat, lost contact";
+        }
+        else
+        {
+            retreat = false;
+            regroup_status_ = "No fight";
+        }
+    }
+    else
+    {
+        last_contact_ = game_loop;
+        const CombatResult result = simulator_.Simulate(regroup_simulation_seconds);
+        if (!result.WeWin())
+        {
+            retreat = true;
+            regroup_status_ = "Retreat";
+        }
+        else if (result.our_value_left > result.their_value_left + regroup_attack_margin)
+        {
+            retreat = false;
+            regroup_status_ = "Attack";
+        }
+        else
+        {
+            regroup_status_ = "Hold";
+        }
+    }
+
+    if (retreat != last_retreat_switch_val_)
+    {
+        last_retreat_switch_ = game_loop;
+        last_retreat_switch_val_ = retreat;
+    }
+
+    return retreat;
 }
 
 void Squad::SetSquadOrder(const SquadOrder& so)
@@ -171,15 +273,7 @@ bool Squad::IsUnitNearEnemy(const sc2::Unit* unit) const
 {
     BOT_ASSERT(unit, "null unit in squad");
 
-    for (auto & unit : bot_.Observation()->GetUnits())
-    {
-        if ((Util::GetPlayer(unit) == PlayerArrayIndex::Enemy) && (Util::Dist(unit->pos, unit->pos) < 20))
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return bot_.InformationManager().UnitInfo().GetUnitGrid(PlayerArrayIndex::Enemy).IsAnyInRadius(unit->pos, 20);
 }
 
 sc2::Point2D Squad::CalcCenter() const
@@ -200,8 +294,69 @@ sc2::Point2D Squad::CalcCenter() const
     return sc2::Point2D(sum.x / units_.size(), sum.y / units_.size());
 }
 
+// Lines the squad up in a concave at the regroup position, facing the strongest enemy army around.
+// With no army around it faces where the squad was told to go, which is where the enemy will come from.
+void Squad::UpdateFormation(const sc2::Point2D & regroup_position)
+{
+    sc2::Point2D facing = order_.GetPosition();
+    std::vector<const UnitCluster*> enemy_clusters;
+    bot_.InformationManager().UnitInfo().GetUnitClusters(PlayerArrayIndex::Enemy).GetClustersInRadius(regroup_position, formation_enemy_radius, enemy_clusters);
+    float strongest = 0.0f;
+    for (auto & cluster : enemy_clusters)
+    {
+        if (cluster->num_combat > 0 && cluster->strength > strongest)
+        {
+            strongest = cluster->strength;
+            facing = cluster->center;
+        }
+    }
+
+    const MapTools & map = bot_.Map();
+    const std::vector<const sc2::Unit*> units(units_.begin(), units_.end());
+    formation_.Update(units, regroup_position, facing, [&map, &regroup_position](const sc2::Point2D & slot)
+    {
+        const int x = static_cast<int>(slot.x);
+        const int y = static_cast<int>(slot.y);
+        return map.IsOnMap(x, y) && map.IsWalkable(x, y)
+            && map.IsConnected(x, y, static_cast<int>(regroup_position.x), static_cast<int>(regroup_position.y));
+    });
+
+    for (auto & slot : formation_.GetSlots())
+    {
+        bot_.DebugHelper().DrawSphere(slot, 0.3f, sc2::Colors::Purple);
+    }
+}
+
 sc2::Point2D Squad::CalcRegroupPosition() const
 {
+    // Regroup on the biggest bunch of our units that isn't fighting, so the rest come to them instead of everyone walking to one unit.
+    const UnitClusters & our_clusters = bot_.InformationManager().UnitInfo().GetUnitClusters(PlayerArrayIndex::Self);
+    std::map<const UnitCluster*, int> squad_units_in_cluster;
+    for (auto & unit : units_)
+    {
+        const UnitCluster* cluster = our_clusters.GetCluster(unit);
+        if (cluster && !near_enemy_.at(unit->tag))
+        {
+            ++squad_units_in_cluster[cluster];
+        }
+    }
+
+    const UnitCluster* biggest = nullptr;
+    int biggest_count = 0;
+    for (auto & cluster_count : squad_units_in_cluster)
+    {
+        if (cluster_count.second > biggest_count)
+        {
+            biggest = cluster_count.first;
+            biggest_count = cluster_count.second;
+        }
+    }
+
+    if (biggest && biggest_count > 1)
+    {
+        return biggest->center;
+    }
+
     sc2::Point2D regroup(0.0f,0.0f);
 
     float min_dist = std::numeric_limits<float>::max();
@@ -292,4 +447,18 @@ void Squad::RemoveUnit(const sc2::Unit* u)
 const std::string & Squad::GetName() const
 {
     return name_;
-}
\ No newline at end of file
+}
+
+std::string Squad::GetStatus() const
+{
+    // How many micro decisions were kept instead of worked out again. The higher the better.
+    const size_t decisions = melee_manager_.GetMicroStates().GetNumDecisions() + ranged_manager_.GetMicroStates().GetNumDecisions();
+    const size_t reused = melee_manager_.GetMicroStates().GetNumReused() + ranged_manager_.GetMicroStates().GetNumReused();
+    const size_t reused_percent = decisions + reused > 0 ? 100 * reused / (decisions + reused) : 0;
+
+    std::stringstream ss;
+    ss << regroup_status_ << ", melee " << GetCombatPolicyName(melee_manager_.GetPolicy())
+       << ", ranged " << GetCombatPolicyName(ranged_manager_.GetPolicy())
+       << ", " << reused_percent << "% of micro decisions reused";
+    return ss.str();
+}
@@ -1,7 +1,10 @@
 #pragma once
+#include "micro/CombatSimulator.h"
+#include "micro/Formation.h"
 #include "micro/MeleeManager.h"
 #include "micro/RangedManager.h"
 #include "micro/SquadOrder.h"
+#include "micro/SquadPath.h"
 
 class ByunJRBot;
 
@@ -14,11 +17,16 @@ class Squad
     std::string                 regroup_status_;
     int                         last_retreat_switch_;
     bool                        last_retreat_switch_val_;
+    int                         last_regroup_check_;
+    int                         last_contact_;
     size_t                      priority_;
 
     SquadOrder                  order_;
     MeleeManager                melee_manager_;
     RangedManager               ranged_manager_;
+    CombatSimulator             simulator_;
+    Formation                   formation_;
+    SquadPath                   squad_path_;
 
     std::map<sc2::Tag, bool>    near_enemy_;
 
@@ -30,7 +38,8 @@ class Squad
     void SetAllUnits();
 
     bool IsUnitNearEnemy(const sc2::Unit* unit) const;
-    bool NeedsToRegroup() const;
+    bool NeedsToRegroup();
+    void UpdateFormation(const sc2::Point2D & regroup_position);
     int  SquadUnitsNear(const sc2::Point2D & pos) const;
 
 public:
@@ -49,6 +58,9 @@ public:
     void SetPriority(const size_t & priority);
     const std::string & GetName() const;
 
+    // What the squad is up to, for the debug display.
+    std::string GetStatus() const;
+
     sc2::Point2D CalcCenter() const;
     sc2::Point2D CalcRegroupPosition() const;
 
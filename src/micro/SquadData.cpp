@@ -104,6 +104,7 @@ void SquadData::DrawSquadInformation()
 
         ss << squad.GetName() << " " << units.size() << " (";
         ss << static_cast<int>(order.GetPosition().x) << ", " << static_cast<int>(order.GetPosition().y) << ")\n";
+        ss << "    " << squad.GetStatus() << "\n";
 
         bot_.DebugHelper().DrawSphere(order.GetPosition(), 5, sc2::Colors::Red);
         bot_.DebugHelper().DrawText(order.GetPosition(), squad.GetName(), sc2::Colors::Red);
@@ -0,0 +1,235 @@
+#include <cmath>
+#include <iterator>
+
+#include "ByunJRBot.h"
+#include "ai/Pathfinding.h"
+#include "micro/SquadPath.h"
+#include "util/Util.h"
+
+namespace
+{
+    // Anything closer than this to where we were going is still the same target.
+    const float target_tolerance = 1.0f;
+
+    // The leader is done with a waypoint this close to it. Everyone is aiming around the waypoint anyway, nobody has to get right on it.
+    const float waypoint_reached_distance = 3.0f;
+
+    // Units keep where they stood in the squad when the path was found, but no further out than this, so stragglers close up on the way.
+    const float max_offset = 4.0f;
+
+    // The cost map changes whenever anything moves. The squad only searches again when what's left of its path
+    // costs this much more than it did when it was found, so it doesn't turn around every time an enemy takes a step.
+    const float reroute_cost_ratio = 1.5f;
+    const int reroute_min_cost_rise = 50;
+
+    // A follower whose place is somewhere the leader can't walk gets pulled back toward the waypoint, this many times per tile.
+    const int follow_clamp_steps_per_tile = 2;
+}
+
+SquadPath::SquadPath(ByunJRBot & bot)
+    : bot_(bot)
+    , has_path_(false)
+    , leader_(nullptr)
+    , leader_sector_(0)
+    , searches_(0)
+{
+}
+
+void SquadPath::Update(const std::set<const sc2::Unit*> & units, const sc2::Point2D & target)
+{
+    own_path_.clear();
+
+    // Flying units don't need a path, and can't lead one.
+    sc2::Point2D center(0.0f, 0.0f);
+    int num_ground = 0;
+    for (auto & unit : units)
+    {
+        if (unit->is_flying) { continue; }
+
+        center.x += unit->pos.x;
+        center.y += unit->pos.y;
+        ++num_ground;
+    }
+
+    if (num_ground == 0)
+    {
+        has_path_ = false;
+        leader_ = nullptr;
+        offsets_.clear();
+        return;
+    }
+    center.x /= num_ground;
+    center.y /= num_ground;
+
+    ChooseLeader(units, center);
+
+    const vvi & cost_map = bot_.InformationManager().GetDPSMap();
+    const uint32_t cost_version = bot_.InformationManager().GetDPSMapVersion();
+    if (has_path_)
+    {
+        const size_t last = path_.waypoints.size() - 1;
+        while (path_.next < last && Util::Dist(leader_->pos, path_.waypoints[path_.next]) < waypoint_reached_distance)
+        {
+            ++path_.next;
+        }
+    }
+
+    if (!has_path_ || Util::Dist(target, path_.target) > target_tolerance || !PathCache::IsNearRoute(path_, leader_->pos)
+        || IsRouteWorse(cost_map, cost_version))
+    {
+        Search(target);
+    }
+
+    if (!has_path_)
+    {
+        return;
+    }
+
+    // Sector 0 is the tiles that aren't walkable. When the leader is on the edge of one, go by the waypoint it's walking to.
+    leader_sector_ = bot_.Map().GetSectorNumber(sc2::Point2DI(leader_->pos.x, leader_->pos.y));
+    if (leader_sector_ == 0)
+    {
+        const sc2::Point2D & waypoint = path_.waypoints[path_.next];
+        leader_sector_ = bot_.Map().GetSectorNumber(sc2::Point2DI(waypoint.x, waypoint.y));
+    }
+
+    // Units that joined since the path was found get their place in the squad from where they are now.
+    for (auto it = offsets_.begin(); it != offsets_.end(); )
+    {
+        it = units.count(it->first) ? std::next(it) : offsets_.erase(it);
+    }
+
+    for (auto & unit : units)
+    {
+        if (!offsets_.count(unit))
+        {
+            sc2::Point2D offset(unit->pos.x - center.x, unit->pos.y - center.y);
+            const float length = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+            if (length > max_offset)
+            {
+                offset.x *= max_offset / length;
+                offset.y *= max_offset / length;
+            }
+            offsets_[unit] = offset;
+        }
+
+        // Units stand on the edges of unwalkable tiles all the time, so sector 0 doesn't count.
+        if (!unit->is_flying)
+        {
+            const int sector = bot_.Map().GetSectorNumber(sc2::Point2DI(unit->pos.x, unit->pos.y));
+            if (sector != 0 && leader_sector_ != 0 && sector != leader_sector_)
+            {
+                own_path_.insert(unit);
+            }
+        }
+    }
+}
+
+// Sticks with the same leader for as long as it's around, so the path doesn't start over every time the middle of the squad shifts.
+void SquadPath::ChooseLeader(const std::set<const sc2::Unit*> & units, const sc2::Point2D & center)
+{
+    if (leader_ && units.count(leader_) && !leader_->is_flying)
+    {
+        return;
+    }
+
+    leader_ = nullptr;
+    float closest = 0.0f;
+    for (auto & unit : units)
+    {
+        if (unit->is_flying) { continue; }
+
+        const float distance = Util::DistSq(unit->pos, center);
+        if (!leader_ || distance < closest)
+        {
+            leader_ = unit;
+            closest = distance;
+        }
+    }
+}
+
+void SquadPath::Search(const sc2::Point2D & target)
+{
+    // Everyone gets their place in the squad again, from where they stand now.
+    offsets_.clear();
+
+    if (sc2::Point2DI(leader_->pos.x, leader_->pos.y) == sc2::Point2DI(target.x, target.y))
+    {
+        has_path_ = false;
+        return;
+    }
+
+    const vvi & cost_map = bot_.InformationManager().GetDPSMap();
+    Pathfinding p;
+    const std::vector<sc2::Point2D> tile_path = p.Djikstra(sc2::Point2DI(leader_->pos.x, leader_->pos.y),
+        sc2::Point2DI(target.x, target.y), cost_map);
+    PathCache::Compress(leader_->pos, target, tile_path, cost_map, bot_.InformationManager().GetDPSMapVersion(), path_);
+    has_path_ = true;
+    ++searches_;
+}
+
+// A cheaper route might have opened up too, but it's not worth a search. The one we have is still fine.
+bool SquadPath::IsRouteWorse(const vvi & cost_map, const uint32_t cost_version)
+{
+    if (cost_version == path_.cost_version)
+    {
+        return false;
+    }
+    path_.cost_version = cost_version;
+
+    // Compared with when the path was found, not the last check, so danger that creeps in a bit at a time still counts.
+    int cost_now = 0;
+    int cost_then = 0;
+    PathCache::GetRemainingCost(path_, cost_map, cost_now, cost_then);
+    return cost_now > cost_then * reroute_cost_ratio + reroute_min_cost_rise;
+}
+
+bool SquadPath::IsInLeaderSector(const sc2::Point2D & pos) const
+{
+    return leader_sector_ == 0 || bot_.Map().GetSectorNumber(sc2::Point2DI(pos.x, pos.y)) == leader_sector_;
+}
+
+bool SquadPath::GetFollowPosition(const sc2::Unit* unit, sc2::Point2D & position) const
+{
+    if (!has_path_ || own_path_.count(unit))
+    {
+        return false;
+    }
+
+    const auto it = offsets_.find(unit);
+    if (it == offsets_.end())
+    {
+        return false;
+    }
+
+    // The unit's place next to the waypoint can be up a cliff or inside a wall. Slide it in toward the waypoint until the leader could walk there.
+    const sc2::Point2D & waypoint = path_.waypoints[path_.next];
+    const sc2::Point2D & offset = it->second;
+    const int steps = static_cast<int>(std::ceil(std::sqrt(offset.x * offset.x + offset.y * offset.y) * follow_clamp_steps_per_tile));
+    for (int k = steps; k > 0; --k)
+    {
+        const float t = static_cast<float>(k) / steps;
+        position = sc2::Point2D(waypoint.x + offset.x * t, waypoint.y + offset.y * t);
+        if (IsInLeaderSector(position))
+        {
+            return true;
+        }
+    }
+    position = waypoint;
+    return true;
+}
+
+bool SquadPath::NeedsOwnPath(const sc2::Unit* unit) const
+{
+    return own_path_.count(unit) > 0;
+}
+
+const sc2::Unit* SquadPath::GetLeader() const
+{
+    return leader_;
+}
+
+size_t SquadPath::GetNumSearches() const
+{
+    return searches_;
+}
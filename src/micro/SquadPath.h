@@ -0,0 +1,46 @@
+#pragma once
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <sc2api/sc2_api.h>
+
+#include "ai/PathCache.h"
+
+class ByunJRBot;
+
+// One path for a whole squad. A leader in the middle of the squad gets the path, and everyone else heads for the leader's
+// next waypoint plus where they stand in the squad, so the squad keeps its shape and the path is searched once instead of once per unit.
+// Units that can't walk to where the leader is (different sector, like across a cliff) still need a path of their own.
+class SquadPath
+{
+    ByunJRBot &                                         bot_;
+    UnitPath                                            path_;
+    bool                                                has_path_;
+    const sc2::Unit*                                    leader_;
+    int                                                 leader_sector_;
+    std::unordered_map<const sc2::Unit*, sc2::Point2D>  offsets_;       // from the leader's waypoint to the unit's
+    std::unordered_set<const sc2::Unit*>                own_path_;
+    size_t                                              searches_;
+
+    void ChooseLeader(const std::set<const sc2::Unit*> & units, const sc2::Point2D & center);
+    void Search(const sc2::Point2D & target);
+    bool IsRouteWorse(const vvi & cost_map, uint32_t cost_version);
+    bool IsInLeaderSector(const sc2::Point2D & pos) const;
+
+public:
+
+    SquadPath(ByunJRBot & bot);
+
+    // Call once per frame, before any unit follows the path.
+    void Update(const std::set<const sc2::Unit*> & units, const sc2::Point2D & target);
+
+    // Where the unit should head to follow the squad. False when there's no path, or the unit needs one of its own.
+    // Always somewhere the leader can walk to, even if the unit's place in the squad would put it on a cliff.
+    bool GetFollowPosition(const sc2::Unit* unit, sc2::Point2D & position) const;
+    bool NeedsOwnPath(const sc2::Unit* unit) const;
+
+    const sc2::Unit* GetLeader() const;
+
+    // How many times the squad had to search for a path, since the start of the game.
+    size_t GetNumSearches() const;
+};
@@ -0,0 +1,226 @@
+#include <cmath>
+
+#include "util/DistanceKernels.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define DISTANCE_KERNELS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define DISTANCE_KERNELS_SSE2
+#endif
+
+// Every kernel does the wide part in blocks of `width` and finishes the last few with the scalar code,
+// so the distance checks have to agree with the scalar code exactly. Squares are always (dx * dx + dy * dy) in that order.
+
+namespace
+{
+    float DistanceSqScalar(const float px, const float py, const float x, const float y)
+    {
+        const float dx = x - px;
+        const float dy = y - py;
+        return dx * dx + dy * dy;
+    }
+
+    void SeparationScalar(const float ax, const float ay, const float bx, const float by, const float radius, float & out_x, float & out_y)
+    {
+        const float dx = ax - bx;
+        const float dy = ay - by;
+        const float d_sq = dx * dx + dy * dy;
+        if (d_sq > 0.0f && d_sq < radius * radius)
+        {
+            const float d = std::sqrt(d_sq);
+            const float push = (radius - d) / (radius * d);
+            out_x += dx * push;
+            out_y += dy * push;
+        }
+    }
+
+#if defined(DISTANCE_KERNELS_AVX2)
+    const size_t width = 8;
+
+    __m256 DistanceSqWide(const __m256 px, const __m256 py, const float* x, const float* y)
+    {
+        const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x), px);
+        const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y), py);
+        return _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    }
+#elif defined(DISTANCE_KERNELS_SSE2)
+    const size_t width = 4;
+
+    __m128 DistanceSqWide(const __m128 px, const __m128 py, const float* x, const float* y)
+    {
+        const __m128 dx = _mm_sub_ps(_mm_loadu_ps(x), px);
+        const __m128 dy = _mm_sub_ps(_mm_loadu_ps(y), py);
+        return _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    }
+#else
+    const size_t width = 1;
+#endif
+}
+
+const char* DistanceKernels::InstructionSet()
+{
+#if defined(DISTANCE_KERNELS_AVX2)
+    return "AVX2";
+#elif defined(DISTANCE_KERNELS_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+size_t DistanceKernels::FindInRadius(const sc2::Point2D & p, const float radius, const float* x, const float* y, const size_t n, uint32_t* indices)
+{
+    const float radius_sq = radius * radius;
+    size_t found = 0;
+    size_t i = 0;
+#if defined(DISTANCE_KERNELS_AVX2)
+    const __m256 px = _mm256_set1_ps(p.x);
+    const __m256 py = _mm256_set1_ps(p.y);
+    const __m256 r = _mm256_set1_ps(radius_sq);
+    for (; i + width <= n; i += width)
+    {
+        int bits = _mm256_movemask_ps(_mm256_cmp_ps(DistanceSqWide(px, py, x + i, y + i), r, _CMP_LT_OQ));
+        for (size_t lane = 0; bits != 0; ++lane, bits >>= 1)
+        {
+            if (bits & 1) indices[found++] = static_cast<uint32_t>(i + lane);
+        }
+    }
+#elif defined(DISTANCE_KERNELS_SSE2)
+    const __m128 px = _mm_set1_ps(p.x);
+    const __m128 py = _mm_set1_ps(p.y);
+    const __m128 r = _mm_set1_ps(radius_sq);
+    for (; i + width <= n; i += width)
+    {
+        int bits = _mm_movemask_ps(_mm_cmplt_ps(DistanceSqWide(px, py, x + i, y + i), r));
+        for (size_t lane = 0; bits != 0; ++lane, bits >>= 1)
+        {
+            if (bits & 1) indices[found++] = static_cast<uint32_t>(i + lane);
+        }
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (DistanceSqScalar(p.x, p.y, x[i], y[i]) < radius_sq)
+        {
+            indices[found++] = static_cast<uint32_t>(i);
+        }
+    }
+    return found;
+}
+
+// The lanes add up in a different order than a plain loop would, so the last bit of the float can differ from the scalar sum.
+float DistanceKernels::SumInRange(const sc2::Point2D & p, const float* x, const float* y, const float* range, const float* value, const size_t n, const float margin)
+{
+    float total = 0.0f;
+    size_t i = 0;
+#if defined(DISTANCE_KERNELS_AVX2)
+    const __m256 px = _mm256_set1_ps(p.x);
+    const __m256 py = _mm256_set1_ps(p.y);
+    const __m256 m = _mm256_set1_ps(margin);
+    __m256 sum = _mm256_setzero_ps();
+    for (; i + width <= n; i += width)
+    {
+        const __m256 reach = _mm256_add_ps(_mm256_loadu_ps(range + i), m);
+        const __m256 in_range = _mm256_cmp_ps(DistanceSqWide(px, py, x + i, y + i), _mm256_mul_ps(reach, reach), _CMP_LT_OQ);
+        sum = _mm256_add_ps(sum, _mm256_and_ps(in_range, _mm256_loadu_ps(value + i)));
+    }
+    float lanes[width];
+    _mm256_storeu_ps(lanes, sum);
+    for (size_t lane = 0; lane < width; ++lane) total += lanes[lane];
+#elif defined(DISTANCE_KERNELS_SSE2)
+    const __m128 px = _mm_set1_ps(p.x);
+    const __m128 py = _mm_set1_ps(p.y);
+    const __m128 m = _mm_set1_ps(margin);
+    __m128 sum = _mm_setzero_ps();
+    for (; i + width <= n; i += width)
+    {
+        const __m128 reach = _mm_add_ps(_mm_loadu_ps(range + i), m);
+        const __m128 in_range = _mm_cmplt_ps(DistanceSqWide(px, py, x + i, y + i), _mm_mul_ps(reach, reach));
+        sum = _mm_add_ps(sum, _mm_and_ps(in_range, _mm_loadu_ps(value + i)));
+    }
+    float lanes[width];
+    _mm_storeu_ps(lanes, sum);
+    for (size_t lane = 0; lane < width; ++lane) total += lanes[lane];
+#endif
+    for (; i < n; ++i)
+    {
+        const float reach = range[i] + margin;
+        if (DistanceSqScalar(p.x, p.y, x[i], y[i]) < reach * reach)
+        {
+            total += value[i];
+        }
+    }
+    return total;
+}
+
+// Same as SumInRange, the lanes add up in a different order so the last bit can differ from the scalar sum.
+void DistanceKernels::Separation(const float* ax, const float* ay, const size_t n,
+                                 const float* bx, const float* by, const size_t m,
+                                 const float radius, float* out_x, float* out_y)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        float sum_x = 0.0f;
+        float sum_y = 0.0f;
+        size_t j = 0;
+#if defined(DISTANCE_KERNELS_AVX2)
+        const __m256 px = _mm256_set1_ps(ax[i]);
+        const __m256 py = _mm256_set1_ps(ay[i]);
+        const __m256 r = _mm256_set1_ps(radius);
+        const __m256 r_sq = _mm256_mul_ps(r, r);
+        const __m256 zero = _mm256_setzero_ps();
+        __m256 wide_x = zero;
+        __m256 wide_y = zero;
+        for (; j + width <= m; j += width)
+        {
+            const __m256 dx = _mm256_sub_ps(px, _mm256_loadu_ps(bx + j));
+            const __m256 dy = _mm256_sub_ps(py, _mm256_loadu_ps(by + j));
+            const __m256 d_sq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            const __m256 close = _mm256_and_ps(_mm256_cmp_ps(d_sq, zero, _CMP_GT_OQ), _mm256_cmp_ps(d_sq, r_sq, _CMP_LT_OQ));
+            const __m256 d = _mm256_sqrt_ps(d_sq);
+            // Lanes on top of each other divide by 0. The mask throws that away.
+            const __m256 push = _mm256_and_ps(close, _mm256_div_ps(_mm256_sub_ps(r, d), _mm256_mul_ps(r, d)));
+            wide_x = _mm256_add_ps(wide_x, _mm256_mul_ps(dx, push));
+            wide_y = _mm256_add_ps(wide_y, _mm256_mul_ps(dy, push));
+        }
+        float lanes_x[width];
+        float lanes_y[width];
+        _mm256_storeu_ps(lanes_x, wide_x);
+        _mm256_storeu_ps(lanes_y, wide_y);
+        for (size_t lane = 0; lane < width; ++lane) { sum_x += lanes_x[lane]; sum_y += lanes_y[lane]; }
+#elif defined(DISTANCE_KERNELS_SSE2)
+        const __m128 px = _mm_set1_ps(ax[i]);
+        const __m128 py = _mm_set1_ps(ay[i]);
+        const __m128 r = _mm_set1_ps(radius);
+        const __m128 r_sq = _mm_mul_ps(r, r);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 wide_x = zero;
+        __m128 wide_y = zero;
+        for (; j + width <= m; j += width)
+        {
+            const __m128 dx = _mm_sub_ps(px, _mm_loadu_ps(bx + j));
+            const __m128 dy = _mm_sub_ps(py, _mm_loadu_ps(by + j));
+            const __m128 d_sq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            const __m128 close = _mm_and_ps(_mm_cmpgt_ps(d_sq, zero), _mm_cmplt_ps(d_sq, r_sq));
+            const __m128 d = _mm_sqrt_ps(d_sq);
+            // Lanes on top of each other divide by 0. The mask throws that away.
+            const __m128 push = _mm_and_ps(close, _mm_div_ps(_mm_sub_ps(r, d), _mm_mul_ps(r, d)));
+            wide_x = _mm_add_ps(wide_x, _mm_mul_ps(dx, push));
+            wide_y = _mm_add_ps(wide_y, _mm_mul_ps(dy, push));
+        }
+        float lanes_x[width];
+        float lanes_y[width];
+        _mm_storeu_ps(lanes_x, wide_x);
+        _mm_storeu_ps(lanes_y, wide_y);
+        for (size_t lane = 0; lane < width; ++lane) { sum_x += lanes_x[lane]; sum_y += lanes_y[lane]; }
+#endif
+        for (; j < m; ++j)
+        {
+            SeparationScalar(ax[i], ay[i], bx[j], by[j], radius, sum_x, sum_y);
+        }
+        out_x[i] += sum_x;
+        out_y[i] += sum_y;
+    }
+}
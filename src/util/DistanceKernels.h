@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+// Distance checks over whole arrays of positions at once, for use with UnitArrays.
+// Built with AVX2 when the compiler is allowed to use it, SSE2 on any x64 build, plain loops otherwise.
+// The distance checks, and the indices they give, are exactly the same whichever version is used.
+// The sums (SumInRange, Separation) add the lanes up in a different order, so they can differ from the plain loops in the last bit.
+namespace DistanceKernels
+{
+    // Which version got compiled in. "AVX2", "SSE2" or "scalar".
+    const char* InstructionSet();
+
+    // Writes the index of every position strictly closer than radius to p into indices (which needs room for n).
+    // Returns how many were written. Indices come out in increasing order.
+    size_t FindInRadius(const sc2::Point2D & p, float radius, const float* x, const float* y, size_t n, uint32_t* indices);
+
+    // Sum of value[i] over every i whose range[i] + margin reaches p.
+    float SumInRange(const sc2::Point2D & p, const float* x, const float* y, const float* range, const float* value, size_t n, float margin);
+
+    // Pushes every a[i] away from every b[j] strictly closer than radius, and adds the push onto (out_x[i], out_y[i]).
+    // A push is (a[i] - b[j]) / distance * (1 - distance / radius): length 1 right on top of b[j], fading to 0 at radius.
+    // Points exactly on top of each other don't push, so a and b can hold the same units.
+    void Separation(const float* ax, const float* ay, size_t n,
+                    const float* bx, const float* by, size_t m,
+                    float radius, float* out_x, float* out_y);
+}
@@ -30,6 +30,30 @@ const std::vector<sc2::Point2DI>& DistanceMap::GetSortedTiles() const
     return sorted_tile_positions_;
 }
 
+sc2::Point2DI DistanceMap::GetTileTowardStart(const sc2::Point2DI& tile, const int steps) const
+{
+    if (tile.x < 0 || tile.y < 0 || tile.x >= width_ || tile.y >= height_ || GetDistance(tile) <= 0)
+    {
+        return tile;
+    }
+
+    // The BFS gave every reachable tile a neighbour one closer, so there's always a step to take.
+    sc2::Point2DI current = tile;
+    for (int step = 0; step < steps && GetDistance(current) > 0; ++step)
+    {
+        for (size_t a = 0; a < LegalActions; ++a)
+        {
+            const sc2::Point2DI next(current.x + actionX[a], current.y + actionY[a]);
+            if (next.x >= 0 && next.y >= 0 && next.x < width_ && next.y < height_ && GetDistance(next) == GetDistance(current) - 1)
+            {
+                current = next;
+                break;
+            }
+        }
+    }
+    return current;
+}
+
 // Computes dist[x][y] = ground distance from (startX, startY) to (x,y)
 // Uses BFS, since the map is quite large and DFS may cause a stack overflow
 void DistanceMap::ComputeDistanceMap(ByunJRBot& bot, const sc2::Point2DI & start_tile)
@@ -18,6 +18,9 @@ public:
 
     // given a position, get the position we should move to to minimize distance
     const std::vector<sc2::Point2DI>& GetSortedTiles() const;
+    // Walks up to steps tiles downhill from tile, one tile closer to the start tile every step, so it follows the ground
+    // around cliffs and walls. Returns tile itself if the start tile can't be reached from it.
+    sc2::Point2DI GetTileTowardStart(const sc2::Point2DI& tile, int steps) const;
     const sc2::Point2DI& GetStartTile() const;
 
     void Draw(ByunJRBot& bot) const;
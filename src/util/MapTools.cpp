@@ -1,3 +1,4 @@
+#include <cstdlib>
 #include <sstream>
 #include <fstream>
 
@@ -18,10 +19,19 @@ MapTools::MapTools(ByunJRBot& bot)
     , true_map_height_  (0)
     , max_z_    (0.0f)
     , frame_   (0)
+    , wall_ready_(false)
 {
 
 }
 
+MapTools::~MapTools()
+{
+    if (wall_thread_.joinable())
+    {
+        wall_thread_.join();
+    }
+}
+
 void MapTools::OnStart()
 {
     true_map_width_  = bot_.Observation()->GetGameInfo().width;
@@ -60,6 +70,7 @@ void MapTools::OnStart()
     }
 
     ComputeConnectivity();
+    ComputeMainRampWall();
 }
 
 void MapTools::OnFrame()
@@ -179,6 +190,58 @@ int MapTools::GetGroundDistance(const sc2::Point2D& src, const sc2::Point2D& des
     );
 }
 
+int MapTools::GetLocalGroundDistance(const sc2::Point2D& src, const sc2::Point2D& dest, const int max_distance) const
+{
+    const sc2::Point2DI start(static_cast<int>(src.x), static_cast<int>(src.y));
+    const sc2::Point2DI goal(static_cast<int>(dest.x), static_cast<int>(dest.y));
+    if (start == goal)
+    {
+        return 0;
+    }
+    if (std::abs(goal.x - start.x) > max_distance || std::abs(goal.y - start.y) > max_distance)
+    {
+        return -1;
+    }
+
+    // Same BFS as DistanceMap, on a small square centered on start.
+    const int side = 2 * max_distance + 1;
+    local_distance_.assign(side * side, -1);
+    local_fringe_.clear();
+    local_fringe_.push_back(start);
+    local_distance_[max_distance * side + max_distance] = 0;
+
+    for (size_t fringe_index = 0; fringe_index < local_fringe_.size(); ++fringe_index)
+    {
+        const sc2::Point2DI tile = local_fringe_[fringe_index];
+        const int distance = local_distance_[(tile.x - start.x + max_distance) * side + tile.y - start.y + max_distance];
+
+        for (size_t a = 0; a < LegalActions; ++a)
+        {
+            const sc2::Point2DI next_tile(tile.x + actionX[a], tile.y + actionY[a]);
+            const int local_x = next_tile.x - start.x + max_distance;
+            const int local_y = next_tile.y - start.y + max_distance;
+            if (local_x < 0 || local_y < 0 || local_x >= side || local_y >= side || local_distance_[local_x * side + local_y] != -1)
+            {
+                continue;
+            }
+
+            // The target can be standing right on the edge of something unwalkable, so check for it first.
+            if (next_tile == goal)
+            {
+                return distance + 1;
+            }
+
+            if (IsWalkable(next_tile))
+            {
+                local_distance_[local_x * side + local_y] = distance + 1;
+                local_fringe_.push_back(next_tile);
+            }
+        }
+    }
+
+    return -1;
+}
+
 const DistanceMap& MapTools::GetDistanceMap(const sc2::Point2DI& tile) const
 {
     const std::pair<int, int> int_tile(tile.x, tile.y);
@@ -460,51 +523,111 @@ bool MapTools::IsAnyTileAdjacentToTileType(const sc2::Point2DI p, const MapTileT
     return false;
 }
 
+// Returns the next piece of the ramp wall of this type that we haven't started building yet, or (0, 0) if the wall is done.
 sc2::Point2DI MapTools::GetNextCoordinateToWallWithBuilding(const sc2::UnitTypeID building_type) const
 {
-    sc2::Point2D closest_point(0, 0);
-    double closest_distance = std::numeric_limits<double>::max();
+    if (!wall_ready_)
+    {
+        return sc2::Point2DI(0, 0);
+    }
+
+    for (const WallPiece & piece : main_ramp_wall_)
+    {
+        if (piece.type == building_type && !bot_.InformationManager().BuildingPlacer().IsReserved(piece.position.x, piece.position.y))
+        {
+            return piece.position;
+        }
+    }
+    return sc2::Point2DI(0, 0);
+}
+
+const std::vector<WallPiece> & MapTools::GetMainRampWall() const
+{
+    static const std::vector<WallPiece> no_wall;
+    return wall_ready_ ? main_ramp_wall_ : no_wall;
+}
 
-    // Get the closest ramp to our starting base. 
-    const sc2::Point2D base_location = bot_.Bases().GetPlayerStartingBaseLocation(PlayerArrayIndex::Self)->GetPosition();
+std::string MapTools::GetWallDataFileName() const
+{
+    return "data/ByunJR/" + bot_.Config().MapName + "WallData.txt";
+}
+
+// Walls are stored per start location, since every start location has its own ramp.
+// Format used on every line on the file:
+// STARTX STARTY UNITTYPE XCOORDINATE YCOORDINATE
+// A UNITTYPE of 0 means the ramp can't be walled off, so we don't bother searching again.
+void MapTools::ComputeMainRampWall()
+{
+    if (wall_thread_.joinable())
+    {
+        wall_thread_.join();
+    }
 
-    const float base_height = TerrainHeight(base_location.x, base_location.y);
+    wall_ready_ = false;
+    main_ramp_wall_.clear();
+    const sc2::Point2DI start_tile(static_cast<int>(bot_.GetStartLocation().x), static_cast<int>(bot_.GetStartLocation().y));
 
-    // No need to iterate through the edges of the map, as the edge can never be part of our wall. 
-    // The smallest building is width 2, so shrink the iteration dimensions by that amount. 
-    for (int y = 2; y < (true_map_height_ - 2); ++y)
+    std::ifstream wall_data(GetWallDataFileName());
+    std::string line;
+    bool found_in_file = false;
+    while (wall_data.is_open() && std::getline(wall_data, line))
     {
-        for (int x = 2; x < (true_map_width_ - 2); ++x)
+        std::stringstream ss(line);
+        int start_x, start_y, type, x, y;
+        if (!(ss >> start_x >> start_y >> type >> x >> y) || start_x != start_tile.x || start_y != start_tile.y)
         {
-            // If we can walk on it, but not build on it, it is most likely a ramp.
-            // TODO: That is not actually correct, come up with a beter way to detect ramps. 
-            if (IsAnyTileAdjacentToTileType(sc2::Point2DI(x,y),MapTileType::Ramp, sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT)
-             && bot_.Query()->Placement(Util::UnitTypeIDToAbilityID(building_type), sc2::Point2D(static_cast<float>(x), static_cast<float>(y))))
-            {
-                // The first depot in a wall has to be next to, well, a wall. 
-                // This allows the depot wall to be built correctly on AbyssalReefLE.
-                if (bot_.Config().MapName == "AbyssalReefLE" &&
-                    bot_.InformationManager().UnitInfo().GetNumDepots(PlayerArrayIndex::Self) < 2
-                 && !(IsTileCornerOfTileType( sc2::Point2DI(x, y), MapTileType::CantWalk) || IsTileCornerReserved(sc2::Point2DI(x, y)))
-                 || TerrainHeight(x, y) < 10.5)
-                    continue;
-
-                // Don't wall of at Proxima Station's pocket expansion.
-                if (bot_.Config().MapName == "ProximaStationLE" 
-                    && bot_.InformationManager().UnitInfo().GetNumDepots(PlayerArrayIndex::Self) < 3
-                 && ((y < 49 || y > 119) || TerrainHeight(x, y) < 10.5))
-                    continue;
-
-                const sc2::Point2D point(x, y);
-                const double distance = Util::DistSq(point, base_location);
-                if (distance < closest_distance)
-                {
-                    closest_point = point;
-                    closest_point.x;
-                    closest_distance = distance;
-                }
-            }
+            continue;
+        }
+
+        found_in_file = true;
+        if (type != 0)
+        {
+            const WallPiece piece = { sc2::UnitTypeID(static_cast<uint32_t>(type)), sc2::Point2DI(x, y) };
+            main_ramp_wall_.push_back(piece);
         }
     }
-    return sc2::Point2DI(closest_point.x, closest_point.y);
-}
\ No newline at end of file
+    wall_data.close();
+
+    if (found_in_file)
+    {
+        wall_ready_ = true;
+        return;
+    }
+
+    // Not on disk yet. Search on another thread, so the first game on a new map doesn't stall on it.
+    // The map grids don't change after OnStart, so the thread can read them while the game goes on.
+    wall_thread_ = std::thread(&MapTools::SolveMainRampWall, this, start_tile,
+        Util::GetUnitTypeWidth(sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT, bot_), GetWallDataFileName());
+}
+
+// Only depots. BuildingManager only ever sends depots to the wall, a barracks in it would be proxied instead and leave a hole.
+// Depots can be lowered to let our own units through anyway.
+void MapTools::SolveMainRampWall(const sc2::Point2DI start_tile, const int depot_size, const std::string file_name)
+{
+    RampWallSolver solver(walkable_, buildable_, terrain_height_, start_tile);
+    solver.AddPieceType(sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT, depot_size);
+    std::vector<WallPiece> wall = solver.Solve(4);
+
+    if (wall.empty())
+    {
+        std::cout << "Unable to find a wall for the main ramp in " << file_name << std::endl;
+    }
+
+    std::stringstream buffer;
+    for (const WallPiece & piece : wall)
+    {
+        buffer << start_tile.x << " " << start_tile.y << " " << static_cast<uint32_t>(piece.type) << " " << piece.position.x << " " << piece.position.y << std::endl;
+    }
+    if (wall.empty())
+    {
+        buffer << start_tile.x << " " << start_tile.y << " 0 0 0" << std::endl;
+    }
+
+    // Append, the other start locations on this map may already be in the file.
+    std::ofstream outfile(file_name, std::ios_base::app);
+    outfile << buffer.str();
+    outfile.close();
+
+    main_ramp_wall_.swap(wall);
+    wall_ready_ = true;
+}
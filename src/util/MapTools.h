@@ -1,8 +1,11 @@
 #pragma once
+#include <atomic>
+#include <thread>
 #include <vector>
 #include <sc2api/sc2_api.h>
 
 #include "util/DistanceMap.h"
+#include "util/RampWallSolver.h"
 
 class ByunJRBot;
 
@@ -20,14 +23,25 @@ class MapTools
     // a cache of already computed distance maps, which is mutable since it only acts as a cache
     mutable std::map<std::pair<int, int>, DistanceMap>   all_maps_;   
 
+    // scratch for GetLocalGroundDistance, kept around so it doesn't allocate every call
+    mutable std::vector<int>                              local_distance_;
+    mutable std::vector<sc2::Point2DI>                    local_fringe_;
+
     std::vector<std::vector<bool>>  walkable_;          // whether a tile is buildable (includes static resources)
     std::vector<std::vector<bool>>  buildable_;         // whether a tile is buildable (includes static resources)
     std::vector<std::vector<bool>>  depot_buildable_;   // whether a depot is buildable on a tile (illegal within 3 tiles of static resource)
     std::vector<std::vector<int>>   last_seen_;         // the last time any of our units has seen this position on the map
     std::vector<std::vector<int>>   sector_number_;     // connectivity sector number, two tiles are ground connected if they have the same number
     std::vector<std::vector<float>> terrain_height_;    // height of the map at x+0.5, y+0.5
+
+    std::vector<WallPiece>          main_ramp_wall_;    // buildings that seal off the ramp out of our main, loaded from disk when possible
+    std::thread                     wall_thread_;       // solves the wall when it isn't on disk yet
+    std::atomic<bool>               wall_ready_;
     
     void ComputeConnectivity();
+    void ComputeMainRampWall();
+    void SolveMainRampWall(sc2::Point2DI start_tile, int depot_size, std::string file_name);
+    std::string GetWallDataFileName() const;
         
     void PrintMap() const;
 
@@ -44,6 +58,7 @@ class MapTools
 public:
 
     MapTools(ByunJRBot& bot);
+    ~MapTools();
 
     void    OnStart();
     void    OnFrame();
@@ -75,6 +90,9 @@ public:
     const   DistanceMap& GetDistanceMap(const sc2::Point2DI& tile) const;
     int     GetGroundDistance(const sc2::Point2DI& src, const sc2::Point2DI& dest) const;
     int     GetGroundDistance(const sc2::Point2D& src, const sc2::Point2D& dest) const;
+    // Same as GetGroundDistance, but only searches the square max_distance tiles around src, and doesn't touch the distance map cache.
+    // -1 if dest can't be reached without leaving the square. Cheap enough to call every frame for every unit.
+    int     GetLocalGroundDistance(const sc2::Point2D& src, const sc2::Point2D& dest, int max_distance) const;
     bool    IsConnected(int x1, int y1, int x2, int y2) const;
     bool    IsConnected(const sc2::Point2DI& from, const sc2::Point2DI& to) const;
     bool    IsWalkable(const sc2::Point2DI& pos) const;
@@ -93,7 +111,9 @@ public:
     bool IsTileCornerReserved(const sc2::Point2DI p) const;;
     bool IsAnyTileAdjacentToTileType(const sc2::Point2DI p, const MapTileType tile_type,
                                      sc2::UnitTypeID building_type) const;
+    // Both are empty (or (0, 0)) until the wall has been loaded or solved, which can take a moment on a map we haven't seen before.
     sc2::Point2DI GetNextCoordinateToWallWithBuilding(sc2::UnitTypeID building_type) const;
+    const std::vector<WallPiece> & GetMainRampWall() const;
 
     // returns a list of all tiles on the map, sorted by 4-direcitonal walk distance from the given position
     const std::vector<sc2::Point2DI>& GetClosestTilesTo(const sc2::Point2DI& pos) const;
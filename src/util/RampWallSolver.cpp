@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#include "util/RampWallSolver.h"
+
+namespace
+{
+    const int dx4[4] = {1, -1, 0, 0};
+    const int dy4[4] = {0, 0, 1, -1};
+
+    // How much room to leave around the ramp when looking for wall positions.
+    const int window_margin = 4;
+
+    // Levels in starcraft are about 2 apart. Anything in between is the ramp itself.
+    const float level_difference = 2.0f;
+
+    // Give up eventually, a map that can't be walled in this many tries probably can't be walled at all.
+    // Counts every node including the full walls that get a flood fill, per pass, so startup stays bounded.
+    const int max_nodes_searched = 500000;
+}
+
+RampWallSolver::RampWallSolver(const vvb & walkable, const vvb & buildable, const vvf & terrain_height, const sc2::Point2DI & start_tile)
+    : walkable_(walkable)
+    , buildable_(buildable)
+    , terrain_height_(terrain_height)
+    , start_tile_(start_tile)
+    , width_(static_cast<int>(walkable.size()))
+    , height_(walkable.empty() ? 0 : static_cast<int>(walkable[0].size()))
+    , main_height_(0.0f)
+    , window_x1_(0)
+    , window_y1_(0)
+    , window_x2_(0)
+    , window_y2_(0)
+    , nodes_searched_(0)
+{
+
+}
+
+void RampWallSolver::AddPieceType(const sc2::UnitTypeID type, const int size)
+{
+    piece_types_.push_back(type);
+    piece_sizes_.push_back(size);
+}
+
+// If we can walk on it, but not build on it, it's a ramp (or some decoration, FindMainRamp sorts that out).
+bool RampWallSolver::IsRamp(const int x, const int y) const
+{
+    return walkable_[x][y] && !buildable_[x][y];
+}
+
+// The main ramp is the closest group of ramp tiles, by ground distance from our start, that actually leads down.
+bool RampWallSolver::FindMainRamp()
+{
+    if (start_tile_.x < 0 || start_tile_.y < 0 || start_tile_.x >= width_ || start_tile_.y >= height_)
+    {
+        return false;
+    }
+
+    main_height_ = terrain_height_[start_tile_.x][start_tile_.y];
+
+    vvb visited(width_, std::vector<bool>(height_, false));
+    vvb in_component(width_, std::vector<bool>(height_, false));
+    std::queue<sc2::Point2DI> fringe;
+    fringe.push(start_tile_);
+    visited[start_tile_.x][start_tile_.y] = true;
+
+    while (!fringe.empty())
+    {
+        const sc2::Point2DI tile = fringe.front();
+        fringe.pop();
+
+        if (IsRamp(tile.x, tile.y) && !in_component[tile.x][tile.y])
+        {
+            // Flood fill the ramp, without leaking onto the level below it.
+            std::vector<sc2::Point2DI> component;
+            std::queue<sc2::Point2DI> ramp_fringe;
+            ramp_fringe.push(tile);
+            in_component[tile.x][tile.y] = true;
+            float lowest = terrain_height_[tile.x][tile.y];
+
+            while (!ramp_fringe.empty())
+            {
+                const sc2::Point2DI r = ramp_fringe.front();
+                ramp_fringe.pop();
+                component.push_back(r);
+                lowest = std::min(lowest, terrain_height_[r.x][r.y]);
+
+                for (int ox = -1; ox <= 1; ++ox)
+                {
+                    for (int oy = -1; oy <= 1; ++oy)
+                    {
+                        const int nx = r.x + ox;
+                        const int ny = r.y + oy;
+                        if (nx < 0 || ny < 0 || nx >= width_ || ny >= height_ || in_component[nx][ny] || !IsRamp(nx, ny))
+                        {
+                            continue;
+                        }
+
+                        const float h = terrain_height_[nx][ny];
+                        if (h < main_height_ - level_difference + 0.2f || h > main_height_ + 0.5f)
+                        {
+                            continue;
+                        }
+
+                        in_component[nx][ny] = true;
+                        ramp_fringe.push(sc2::Point2DI(nx, ny));
+                    }
+                }
+            }
+
+            if (lowest < main_height_ - level_difference / 2.0f)
+            {
+                ramp_ = vvb(width_, std::vector<bool>(height_, false));
+                window_x1_ = width_;
+                window_y1_ = height_;
+                window_x2_ = 0;
+                window_y2_ = 0;
+                for (const sc2::Point2DI & r : component)
+                {
+                    ramp_[r.x][r.y] = true;
+                    window_x1_ = std::min(window_x1_, r.x);
+                    window_y1_ = std::min(window_y1_, r.y);
+                    window_x2_ = std::max(window_x2_, r.x + 1);
+                    window_y2_ = std::max(window_y2_, r.y + 1);
+                }
+
+                window_x1_ = std::max(window_x1_ - window_margin, 0);
+                window_y1_ = std::max(window_y1_ - window_margin, 0);
+                window_x2_ = std::min(window_x2_ + window_margin, width_);
+                window_y2_ = std::min(window_y2_ + window_margin, height_);
+                return true;
+            }
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const int nx = tile.x + dx4[i];
+            const int ny = tile.y + dy4[i];
+            if (nx < 0 || ny < 0 || nx >= width_ || ny >= height_ || visited[nx][ny] || !walkable_[nx][ny])
+            {
+                continue;
+            }
+
+            visited[nx][ny] = true;
+            fringe.push(sc2::Point2DI(nx, ny));
+        }
+    }
+
+    return false;
+}
+
+// Every spot on the high ground, right next to the ramp, that a piece of the wall fits in.
+void RampWallSolver::FindCandidates()
+{
+    candidates_.clear();
+    seeds_.clear();
+    target_ = vvb(width_, std::vector<bool>(height_, false));
+
+    for (int x = window_x1_; x < window_x2_; ++x)
+    {
+        for (int y = window_y1_; y < window_y2_; ++y)
+        {
+            if (!walkable_[x][y])
+            {
+                continue;
+            }
+
+            const float h = terrain_height_[x][y];
+            const bool on_border = x == window_x1_ || y == window_y1_ || x == window_x2_ - 1 || y == window_y2_ - 1;
+            if (on_border && !ramp_[x][y] && h > main_height_ - 0.5f)
+            {
+                seeds_.push_back(sc2::Point2DI(x, y));
+            }
+            if (h < main_height_ - level_difference / 2.0f)
+            {
+                target_[x][y] = true;
+            }
+        }
+    }
+
+    for (size_t type = 0; type < piece_types_.size(); ++type)
+    {
+        const int size = piece_sizes_[type];
+        for (int cx = window_x1_; cx < window_x2_; ++cx)
+        {
+            for (int cy = window_y1_; cy < window_y2_; ++cy)
+            {
+                Candidate c;
+                c.piece_type = static_cast<int>(type);
+                c.position = sc2::Point2DI(cx, cy);
+                c.x1 = cx - size / 2;
+                c.y1 = cy - size / 2;
+                c.x2 = c.x1 + size;
+                c.y2 = c.y1 + size;
+
+                if (c.x1 < window_x1_ || c.y1 < window_y1_ || c.x2 > window_x2_ || c.y2 > window_y2_)
+                {
+                    continue;
+                }
+
+                bool fits = true;
+                bool touches_ramp = false;
+                for (int x = c.x1 - 1; x <= c.x2 && fits; ++x)
+                {
+                    for (int y = c.y1 - 1; y <= c.y2 && fits; ++y)
+                    {
+                        if (x < 0 || y < 0 || x >= width_ || y >= height_)
+                        {
+                            continue;
+                        }
+
+                        const bool inside = x >= c.x1 && x < c.x2 && y >= c.y1 && y < c.y2;
+                        if (inside && (!buildable_[x][y] || terrain_height_[x][y] < main_height_ - 0.5f))
+                        {
+                            fits = false;
+                        }
+                        else if (!inside && ramp_[x][y])
+                        {
+                            touches_ramp = true;
+                        }
+                    }
+                }
+
+                if (fits && touches_ramp)
+                {
+                    candidates_.push_back(c);
+                }
+            }
+        }
+    }
+}
+
+// Can anything get from the top of the ramp to the bottom? The fill never leaves the window, so neither does visited_.
+bool RampWallSolver::IsSealed()
+{
+    const int window_width = window_x2_ - window_x1_;
+    visited_.assign(window_width * (window_y2_ - window_y1_), 0);
+    fringe_.clear();
+    for (const sc2::Point2DI & seed : seeds_)
+    {
+        if (!blocked_[seed.x][seed.y])
+        {
+            visited_[(seed.y - window_y1_) * window_width + seed.x - window_x1_] = 1;
+            fringe_.push_back(seed);
+        }
+    }
+
+    // Depth first is as good as breadth first for just finding out whether the bottom can be reached.
+    while (!fringe_.empty())
+    {
+        const sc2::Point2DI tile = fringe_.back();
+        fringe_.pop_back();
+
+        if (target_[tile.x][tile.y])
+        {
+            return false;
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const int nx = tile.x + dx4[i];
+            const int ny = tile.y + dy4[i];
+            if (nx < window_x1_ || ny < window_y1_ || nx >= window_x2_ || ny >= window_y2_)
+            {
+                continue;
+            }
+
+            char & visited = visited_[(ny - window_y1_) * window_width + nx - window_x1_];
+            if (visited || !walkable_[nx][ny] || blocked_[nx][ny])
+            {
+                continue;
+            }
+
+            visited = 1;
+            fringe_.push_back(sc2::Point2DI(nx, ny));
+        }
+    }
+
+    return true;
+}
+
+bool RampWallSolver::Overlaps(const Candidate & c) const
+{
+    for (int x = c.x1; x < c.x2; ++x)
+    {
+        for (int y = c.y1; y < c.y2; ++y)
+        {
+            if (blocked_[x][y])
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void RampWallSolver::SetBlocked(const Candidate & c, const bool blocked)
+{
+    for (int x = c.x1; x < c.x2; ++x)
+    {
+        for (int y = c.y1; y < c.y2; ++y)
+        {
+            blocked_[x][y] = blocked;
+        }
+    }
+}
+
+// Plain backtracking. Candidates are only ever tried in increasing order so every set is only looked at once.
+// Pieces of any type other than the first one can only be used type_limited times.
+bool RampWallSolver::Search(const size_t first, const int pieces_left, const int max_of_type, const int type_limited)
+{
+    // Every full wall gets a flood fill, so those count too.
+    if (++nodes_searched_ > max_nodes_searched)
+    {
+        return false;
+    }
+
+    if (pieces_left == 0)
+    {
+        return IsSealed();
+    }
+
+    for (size_t i = first; i < candidates_.size(); ++i)
+    {
+        const Candidate & c = candidates_[i];
+        if (c.piece_type != 0 && type_limited >= max_of_type)
+        {
+            continue;
+        }
+
+        if (Overlaps(c))
+        {
+            continue;
+        }
+
+        SetBlocked(c, true);
+        chosen_.push_back(static_cast<int>(i));
+
+        if (Search(i + 1, pieces_left - 1, max_of_type, type_limited + (c.piece_type != 0 ? 1 : 0)))
+        {
+            return true;
+        }
+
+        chosen_.pop_back();
+        SetBlocked(c, false);
+    }
+
+    return false;
+}
+
+std::vector<WallPiece> RampWallSolver::Solve(const int max_pieces)
+{
+    std::vector<WallPiece> wall;
+    if (piece_types_.empty() || !FindMainRamp())
+    {
+        return wall;
+    }
+
+    FindCandidates();
+    blocked_ = vvb(width_, std::vector<bool>(height_, false));
+
+    // If it's already sealed there is no ramp to wall off.
+    if (seeds_.empty() || IsSealed())
+    {
+        return wall;
+    }
+
+    // Try with only the preferred piece first, then allow one of the others, if there are any.
+    // Fewest pieces wins within each pass.
+    const int max_other_pieces = piece_types_.size() > 1 ? 1 : 0;
+    for (int max_of_other_types = 0; max_of_other_types <= max_other_pieces; ++max_of_other_types)
+    {
+        for (int pieces = 1; pieces <= max_pieces; ++pieces)
+        {
+            nodes_searched_ = 0;
+            chosen_.clear();
+            if (Search(0, pieces, max_of_other_types, 0))
+            {
+                for (const int i : chosen_)
+                {
+                    const WallPiece piece = { piece_types_[candidates_[i].piece_type], candidates_[i].position };
+                    wall.push_back(piece);
+                }
+                return wall;
+            }
+        }
+    }
+
+    return wall;
+}
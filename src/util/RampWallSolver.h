@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include <sc2api/sc2_api.h>
+
+#include "common/Common.h"
+
+struct WallPiece
+{
+    sc2::UnitTypeID type;
+    sc2::Point2DI   position;   // center of the building, same as what gets sent with the build command
+};
+
+// Finds the smallest set of buildings that completely seals the ramp out of the main base.
+// Only looks at the map grids, so it has no idea about units or creep. That's fine, it runs once per map and gets cached.
+class RampWallSolver
+{
+    struct Candidate
+    {
+        int                 piece_type;
+        sc2::Point2DI       position;
+        int                 x1, y1, x2, y2;     // footprint, [x1, x2) x [y1, y2)
+    };
+
+    const vvb &                 walkable_;
+    const vvb &                 buildable_;
+    const vvf &                 terrain_height_;
+    const sc2::Point2DI         start_tile_;
+    int                         width_;
+    int                         height_;
+    float                       main_height_;
+
+    std::vector<sc2::UnitTypeID> piece_types_;
+    std::vector<int>             piece_sizes_;
+
+    // Everything happens inside a small window around the ramp.
+    int                         window_x1_, window_y1_, window_x2_, window_y2_;
+    vvb                         ramp_;
+    vvb                         blocked_;           // tiles covered by the pieces placed so far
+    std::vector<sc2::Point2DI>  seeds_;             // main base side of the window
+    vvb                         target_;            // the low ground side
+    std::vector<Candidate>      candidates_;
+    std::vector<int>            chosen_;
+    int                         nodes_searched_;
+
+    // Scratch for IsSealed, only as big as the window and kept around so the search doesn't allocate.
+    std::vector<char>           visited_;
+    std::vector<sc2::Point2DI>  fringe_;
+
+    bool IsRamp(int x, int y) const;
+    bool FindMainRamp();
+    void FindCandidates();
+    bool IsSealed();
+    bool Overlaps(const Candidate & c) const;
+    void SetBlocked(const Candidate & c, bool blocked);
+    bool Search(size_t first, int pieces_left, int max_of_type, int type_limited);
+
+public:
+
+    RampWallSolver(const vvb & walkable, const vvb & buildable, const vvf & terrain_height, const sc2::Point2DI & start_tile);
+
+    // Every type of building that is allowed in the wall, and how many tiles wide (and tall) it is.
+    // Pieces added first are preferred. Only one of each piece after the first is allowed in a wall.
+    void AddPieceType(sc2::UnitTypeID type, int size);
+
+    // Returns an empty vector if the ramp can't be sealed with at most max_pieces buildings.
+    std::vector<WallPiece> Solve(int max_pieces);
+};
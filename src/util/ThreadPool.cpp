@@ -0,0 +1,83 @@
+#include <algorithm>
+
+#include "util/ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : running_(0)
+    , stopping_(false)
+{
+    if (num_threads == 0)
+    {
+        const size_t cores = std::thread::hardware_concurrency();
+        num_threads = std::max<size_t>(cores, 2) - 1;
+    }
+
+    for (size_t i = 0; i < num_threads; ++i)
+    {
+        workers_.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    job_added_.notify_all();
+
+    for (auto & worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::NumThreads() const
+{
+    return workers_.size();
+}
+
+void ThreadPool::Add(const std::function<void()> & job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(job);
+    }
+    job_added_.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_finished_.wait(lock, [this] { return jobs_.empty() && running_ == 0; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_added_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+
+            // Finish whatever is queued before stopping, someone might be waiting on it.
+            if (jobs_.empty())
+            {
+                return;
+            }
+
+            job = jobs_.front();
+            jobs_.pop_front();
+            ++running_;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --running_;
+        }
+        job_finished_.notify_all();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A few worker threads that are started once and kept for the whole game, for running lots of short jobs in parallel.
+// Jobs must not touch the bot or the API. Copy whatever they need on the main thread first.
+class ThreadPool
+{
+    std::vector<std::thread>            workers_;
+    std::deque<std::function<void()>>   jobs_;
+    std::mutex                          mutex_;
+    std::condition_variable             job_added_;
+    std::condition_variable             job_finished_;
+    size_t                              running_;
+    bool                                stopping_;
+
+    void WorkerLoop();
+
+public:
+
+    // 0 threads means one less than the number of cores, so the main thread still has one to itself.
+    explicit ThreadPool(size_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    size_t NumThreads() const;
+
+    void Add(const std::function<void()> & job);
+
+    // Blocks until every job added so far has finished.
+    void Wait();
+};
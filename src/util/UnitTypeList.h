@@ -0,0 +1,159 @@
+#pragma once
+#include <cstdint>
+
+// Everything Util knows about a unit type that isn't in the game data, in one place.
+// Util.cpp turns this list into a dense array indexed by UnitTypeID, so every lookup is a single array read.
+// Add new types here instead of writing another switch, that way the different lookups can't disagree with each other.
+//
+// UNIT_TYPE(unit type, ability that makes it, what makes it, flags)
+// Types that aren't in the list have no ability, no builder and no flags.
+// Flying buildings are left out on purpose, there is no point in treating them like the building they are supposed to be.
+
+namespace UnitTypeFlag
+{
+    enum : uint32_t
+    {
+        None            = 0,
+        Building        = 1 << 0,
+        TownHall        = 1 << 1,
+        Refinery        = 1 << 2,
+        Worker          = 1 << 3,
+        SupplyProvider  = 1 << 4,
+        Detector        = 1 << 5,
+        Mineral         = 1 << 6,
+        Geyser          = 1 << 7,
+        NotCombat       = 1 << 8,   // not a building, worker or supply provider, but still can't fight (eggs, larva)
+    };
+}
+
+#define UNIT_TYPE_LIST(UNIT_TYPE) \
+    UNIT_TYPE(NEUTRAL_BATTLESTATIONMINERALFIELD,    INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_BATTLESTATIONMINERALFIELD750, INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_LABMINERALFIELD,              INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_LABMINERALFIELD750,           INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_MINERALFIELD,                 INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_MINERALFIELD750,              INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_PROTOSSVESPENEGEYSER,         INVALID,                 INVALID,                  Geyser)                    \
+    UNIT_TYPE(NEUTRAL_PURIFIERMINERALFIELD,         INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_PURIFIERMINERALFIELD750,      INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_PURIFIERRICHMINERALFIELD,     INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_PURIFIERRICHMINERALFIELD750,  INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_PURIFIERVESPENEGEYSER,        INVALID,                 INVALID,                  Geyser)                    \
+    UNIT_TYPE(NEUTRAL_RICHMINERALFIELD,             INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_RICHMINERALFIELD750,          INVALID,                 INVALID,                  Mineral)                   \
+    UNIT_TYPE(NEUTRAL_RICHVESPENEGEYSER,            INVALID,                 INVALID,                  Geyser)                    \
+    UNIT_TYPE(NEUTRAL_SHAKURASVESPENEGEYSER,        INVALID,                 INVALID,                  Geyser)                    \
+    UNIT_TYPE(NEUTRAL_SPACEPLATFORMGEYSER,          INVALID,                 INVALID,                  Geyser)                    \
+    UNIT_TYPE(NEUTRAL_VESPENEGEYSER,                INVALID,                 INVALID,                  Geyser)                    \
+                                                                                                                                  \
+    UNIT_TYPE(TERRAN_ARMORY,                        BUILD_ARMORY,            TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_BANSHEE,                       TRAIN_BANSHEE,           TERRAN_STARPORT,          None)                      \
+    UNIT_TYPE(TERRAN_BARRACKS,                      BUILD_BARRACKS,          TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_BARRACKSREACTOR,               BUILD_REACTOR_BARRACKS,  TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_BARRACKSTECHLAB,               BUILD_TECHLAB,           TERRAN_BARRACKS,          Building)                  \
+    UNIT_TYPE(TERRAN_BATTLECRUISER,                 TRAIN_BATTLECRUISER,     TERRAN_STARPORT,          None)                      \
+    UNIT_TYPE(TERRAN_BUNKER,                        BUILD_BUNKER,            TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_COMMANDCENTER,                 BUILD_COMMANDCENTER,     TERRAN_SCV,               Building | TownHall)       \
+    UNIT_TYPE(TERRAN_CYCLONE,                       TRAIN_CYCLONE,           TERRAN_FACTORY,           None)                      \
+    UNIT_TYPE(TERRAN_ENGINEERINGBAY,                BUILD_ENGINEERINGBAY,    TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_FACTORY,                       BUILD_FACTORY,           TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_FACTORYREACTOR,                BUILD_REACTOR_FACTORY,   TERRAN_FACTORY,           Building)                  \
+    UNIT_TYPE(TERRAN_FACTORYTECHLAB,                BUILD_TECHLAB,           TERRAN_FACTORY,           Building)                  \
+    UNIT_TYPE(TERRAN_FUSIONCORE,                    BUILD_FUSIONCORE,        TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_GHOST,                         TRAIN_GHOST,             TERRAN_BARRACKS,          None)                      \
+    UNIT_TYPE(TERRAN_GHOSTACADEMY,                  BUILD_GHOSTACADEMY,      TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_HELLION,                       TRAIN_HELLION,           TERRAN_FACTORY,           None)                      \
+    UNIT_TYPE(TERRAN_LIBERATOR,                     TRAIN_LIBERATOR,         TERRAN_STARPORT,          None)                      \
+    UNIT_TYPE(TERRAN_MARAUDER,                      TRAIN_MARAUDER,          TERRAN_BARRACKS,          None)                      \
+    UNIT_TYPE(TERRAN_MARINE,                        TRAIN_MARINE,            TERRAN_BARRACKS,          None)                      \
+    UNIT_TYPE(TERRAN_MEDIVAC,                       TRAIN_MEDIVAC,           TERRAN_STARPORT,          None)                      \
+    UNIT_TYPE(TERRAN_MISSILETURRET,                 BUILD_MISSILETURRET,     TERRAN_SCV,               Building | Detector)       \
+    UNIT_TYPE(TERRAN_NUKE,                          BUILD_NUKE,              TERRAN_GHOSTACADEMY,      None)                      \
+    UNIT_TYPE(TERRAN_ORBITALCOMMAND,                MORPH_ORBITALCOMMAND,    TERRAN_COMMANDCENTER,     Building | TownHall)       \
+    UNIT_TYPE(TERRAN_PLANETARYFORTRESS,             MORPH_PLANETARYFORTRESS, TERRAN_COMMANDCENTER,     Building | TownHall)       \
+    UNIT_TYPE(TERRAN_RAVEN,                         TRAIN_RAVEN,             TERRAN_STARPORT,          Detector)                  \
+    UNIT_TYPE(TERRAN_REAPER,                        TRAIN_REAPER,            TERRAN_BARRACKS,          None)                      \
+    UNIT_TYPE(TERRAN_REFINERY,                      BUILD_REFINERY,          TERRAN_SCV,               Building | Refinery)       \
+    UNIT_TYPE(TERRAN_SCV,                           TRAIN_SCV,               TERRAN_COMMANDCENTER,     Worker)                    \
+    UNIT_TYPE(TERRAN_SENSORTOWER,                   BUILD_SENSORTOWER,       TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_SIEGETANK,                     TRAIN_SIEGETANK,         TERRAN_FACTORY,           None)                      \
+    UNIT_TYPE(TERRAN_STARPORT,                      BUILD_STARPORT,          TERRAN_SCV,               Building)                  \
+    UNIT_TYPE(TERRAN_STARPORTREACTOR,               BUILD_REACTOR_STARPORT,  TERRAN_STARPORT,          Building)                  \
+    UNIT_TYPE(TERRAN_STARPORTTECHLAB,               BUILD_TECHLAB,           TERRAN_STARPORT,          Building)                  \
+    UNIT_TYPE(TERRAN_SUPPLYDEPOT,                   BUILD_SUPPLYDEPOT,       TERRAN_SCV,               Building | SupplyProvider) \
+    UNIT_TYPE(TERRAN_SUPPLYDEPOTLOWERED,            INVALID,                 INVALID,                  SupplyProvider)            \
+    UNIT_TYPE(TERRAN_TECHLAB,                       BUILD_TECHLAB,           INVALID,                  None)                      \
+    UNIT_TYPE(TERRAN_THOR,                          TRAIN_THOR,              TERRAN_FACTORY,           None)                      \
+    UNIT_TYPE(TERRAN_VIKINGFIGHTER,                 TRAIN_VIKINGFIGHTER,     TERRAN_STARPORT,          None)                      \
+    UNIT_TYPE(TERRAN_WIDOWMINE,                     TRAIN_WIDOWMINE,         TERRAN_FACTORY,           None)                      \
+                                                                                                                                  \
+    UNIT_TYPE(PROTOSS_ADEPT,                        TRAIN_ADEPT,             PROTOSS_GATEWAY,          None)                      \
+    UNIT_TYPE(PROTOSS_ASSIMILATOR,                  BUILD_ASSIMILATOR,       PROTOSS_PROBE,            Building | Refinery)       \
+    UNIT_TYPE(PROTOSS_CARRIER,                      TRAIN_CARRIER,           PROTOSS_STARGATE,         None)                      \
+    UNIT_TYPE(PROTOSS_COLOSSUS,                     TRAIN_COLOSSUS,          PROTOSS_ROBOTICSFACILITY, None)                      \
+    UNIT_TYPE(PROTOSS_CYBERNETICSCORE,              BUILD_CYBERNETICSCORE,   PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_DARKSHRINE,                   BUILD_DARKSHRINE,        PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_DARKTEMPLAR,                  TRAIN_DARKTEMPLAR,       PROTOSS_GATEWAY,          None)                      \
+    UNIT_TYPE(PROTOSS_DISRUPTOR,                    TRAIN_DISRUPTOR,         PROTOSS_ROBOTICSFACILITY, None)                      \
+    UNIT_TYPE(PROTOSS_FLEETBEACON,                  BUILD_FLEETBEACON,       PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_FORGE,                        BUILD_FORGE,             PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_GATEWAY,                      BUILD_GATEWAY,           PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_HIGHTEMPLAR,                  TRAIN_HIGHTEMPLAR,       PROTOSS_GATEWAY,          None)                      \
+    UNIT_TYPE(PROTOSS_IMMORTAL,                     TRAIN_IMMORTAL,          PROTOSS_ROBOTICSFACILITY, None)                      \
+    UNIT_TYPE(PROTOSS_INTERCEPTOR,                  BUILD_INTERCEPTORS,      PROTOSS_CARRIER,          None)                      \
+    UNIT_TYPE(PROTOSS_MOTHERSHIPCORE,               TRAIN_MOTHERSHIPCORE,    PROTOSS_NEXUS,            None)                      \
+    UNIT_TYPE(PROTOSS_NEXUS,                        BUILD_NEXUS,             PROTOSS_PROBE,            Building | TownHall)       \
+    UNIT_TYPE(PROTOSS_OBSERVER,                     TRAIN_OBSERVER,          PROTOSS_ROBOTICSFACILITY, Detector)                  \
+    UNIT_TYPE(PROTOSS_ORACLE,                       TRAIN_ORACLE,            PROTOSS_STARGATE,         None)                      \
+    UNIT_TYPE(PROTOSS_ORACLESTASISTRAP,             BUILD_STASISTRAP,        PROTOSS_ORACLE,           None)                      \
+    UNIT_TYPE(PROTOSS_PHOENIX,                      TRAIN_PHOENIX,           PROTOSS_STARGATE,         None)                      \
+    UNIT_TYPE(PROTOSS_PHOTONCANNON,                 BUILD_PHOTONCANNON,      PROTOSS_PROBE,            Building | Detector)       \
+    UNIT_TYPE(PROTOSS_PROBE,                        TRAIN_PROBE,             PROTOSS_NEXUS,            Worker)                    \
+    UNIT_TYPE(PROTOSS_PYLON,                        BUILD_PYLON,             PROTOSS_PROBE,            Building | SupplyProvider) \
+    UNIT_TYPE(PROTOSS_PYLONOVERCHARGED,             INVALID,                 INVALID,                  SupplyProvider)            \
+    UNIT_TYPE(PROTOSS_ROBOTICSBAY,                  BUILD_ROBOTICSBAY,       PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_ROBOTICSFACILITY,             BUILD_ROBOTICSFACILITY,  PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_SENTRY,                       TRAIN_SENTRY,            PROTOSS_GATEWAY,          None)                      \
+    UNIT_TYPE(PROTOSS_STALKER,                      TRAIN_STALKER,           PROTOSS_GATEWAY,          None)                      \
+    UNIT_TYPE(PROTOSS_STARGATE,                     BUILD_STARGATE,          PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_TEMPEST,                      TRAIN_TEMPEST,           PROTOSS_STARGATE,         None)                      \
+    UNIT_TYPE(PROTOSS_TEMPLARARCHIVE,               BUILD_TEMPLARARCHIVE,    PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_TWILIGHTCOUNCIL,              BUILD_TWILIGHTCOUNCIL,   PROTOSS_PROBE,            Building)                  \
+    UNIT_TYPE(PROTOSS_VOIDRAY,                      TRAIN_VOIDRAY,           PROTOSS_STARGATE,         None)                      \
+    UNIT_TYPE(PROTOSS_WARPPRISM,                    TRAIN_WARPPRISM,         PROTOSS_ROBOTICSFACILITY, None)                      \
+    UNIT_TYPE(PROTOSS_ZEALOT,                       TRAIN_ZEALOT,            PROTOSS_GATEWAY,          None)                      \
+                                                                                                                                  \
+    UNIT_TYPE(ZERG_BANELING,                        TRAIN_BANELING,          ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_BANELINGNEST,                    BUILD_BANELINGNEST,      ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_CORRUPTOR,                       TRAIN_CORRUPTOR,         ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_DRONE,                           TRAIN_DRONE,             ZERG_LARVA,               Worker)                    \
+    UNIT_TYPE(ZERG_DRONEBURROWED,                   INVALID,                 INVALID,                  Worker)                    \
+    UNIT_TYPE(ZERG_EGG,                             INVALID,                 INVALID,                  NotCombat)                 \
+    UNIT_TYPE(ZERG_EVOLUTIONCHAMBER,                BUILD_EVOLUTIONCHAMBER,  ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_EXTRACTOR,                       BUILD_EXTRACTOR,         ZERG_DRONE,               Building | Refinery)       \
+    UNIT_TYPE(ZERG_GREATERSPIRE,                    MORPH_GREATERSPIRE,      ZERG_SPIRE,               Building)                  \
+    UNIT_TYPE(ZERG_HATCHERY,                        BUILD_HATCHERY,          ZERG_DRONE,               Building | TownHall)       \
+    UNIT_TYPE(ZERG_HIVE,                            MORPH_HIVE,              ZERG_LAIR,                Building | TownHall)       \
+    UNIT_TYPE(ZERG_HYDRALISK,                       TRAIN_HYDRALISK,         ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_HYDRALISKDEN,                    BUILD_HYDRALISKDEN,      ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_INFESTATIONPIT,                  BUILD_INFESTATIONPIT,    ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_INFESTOR,                        TRAIN_INFESTOR,          ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_LAIR,                            MORPH_LAIR,              ZERG_HATCHERY,            Building | TownHall)       \
+    UNIT_TYPE(ZERG_LARVA,                           INVALID,                 INVALID,                  NotCombat)                 \
+    UNIT_TYPE(ZERG_MUTALISK,                        TRAIN_MUTALISK,          ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_NYDUSCANAL,                      BUILD_NYDUSWORM,         ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_NYDUSNETWORK,                    BUILD_NYDUSNETWORK,      ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_OVERLORD,                        TRAIN_OVERLORD,          ZERG_LARVA,               SupplyProvider)            \
+    UNIT_TYPE(ZERG_OVERSEER,                        INVALID,                 INVALID,                  Detector)                  \
+    UNIT_TYPE(ZERG_QUEEN,                           TRAIN_QUEEN,             ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_ROACH,                           TRAIN_ROACH,             ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_ROACHWARREN,                     BUILD_ROACHWARREN,       ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_SPAWNINGPOOL,                    BUILD_SPAWNINGPOOL,      ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_SPINECRAWLER,                    BUILD_SPINECRAWLER,      ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_SPIRE,                           BUILD_SPIRE,             ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_SPORECRAWLER,                    BUILD_SPORECRAWLER,      ZERG_DRONE,               Building | Detector)       \
+    UNIT_TYPE(ZERG_SWARMHOSTMP,                     TRAIN_SWARMHOST,         ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_ULTRALISK,                       TRAIN_ULTRALISK,         ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_ULTRALISKCAVERN,                 BUILD_ULTRALISKCAVERN,   ZERG_DRONE,               Building)                  \
+    UNIT_TYPE(ZERG_VIPER,                           TRAIN_VIPER,             ZERG_LARVA,               None)                      \
+    UNIT_TYPE(ZERG_ZERGLING,                        TRAIN_ZERGLING,          ZERG_LARVA,               None)
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <sc2api/sc2_api.h>
 #include <sc2utils/sc2_manage_process.h>
@@ -5,6 +7,80 @@
 #include "ByunJRBot.h"
 #include "common/BotAssert.h"
 #include "util/Util.h"
+#include "util/UnitTypeList.h"
+
+namespace
+{
+    struct UnitTypeRow
+    {
+        sc2::UNIT_TYPEID    type;
+        sc2::ABILITY_ID     build_ability;
+        sc2::UNIT_TYPEID    builder;
+        uint32_t            flags;
+    };
+}
+
+// The flags in the list aren't qualified, so expand it where they are in scope.
+namespace UnitTypeFlag
+{
+    #define UNIT_TYPE_ROW(type, ability, builder, flags) { sc2::UNIT_TYPEID::type, sc2::ABILITY_ID::ability, sc2::UNIT_TYPEID::builder, flags },
+    constexpr UnitTypeRow unit_type_rows[] = { UNIT_TYPE_LIST(UNIT_TYPE_ROW) };
+    #undef UNIT_TYPE_ROW
+}
+
+namespace
+{
+    using UnitTypeFlag::unit_type_rows;
+
+    constexpr size_t num_unit_type_rows = sizeof(unit_type_rows) / sizeof(unit_type_rows[0]);
+
+    constexpr uint32_t MaxUnitTypeID(const size_t i = 0, const uint32_t highest = 0)
+    {
+        return i == num_unit_type_rows ? highest
+             : MaxUnitTypeID(i + 1, static_cast<uint32_t>(unit_type_rows[i].type) > highest ? static_cast<uint32_t>(unit_type_rows[i].type) : highest);
+    }
+
+    // Eggs and larva are the only things that aren't combat units for some other reason.
+    const uint32_t non_combat_flags = UnitTypeFlag::Building | UnitTypeFlag::Worker | UnitTypeFlag::SupplyProvider | UnitTypeFlag::NotCombat;
+
+    struct UnitTypeLookup
+    {
+        sc2::AbilityID      build_ability;
+        sc2::UnitTypeID     builder;
+        uint32_t            flags;
+    };
+
+    typedef std::array<UnitTypeLookup, MaxUnitTypeID() + 1> UnitTypeLookupTable;
+
+    UnitTypeLookupTable BuildUnitTypeLookup()
+    {
+        UnitTypeLookupTable table;
+        for (UnitTypeLookup & lookup : table)
+        {
+            lookup.build_ability = 0;
+            lookup.builder = 0;
+            lookup.flags = UnitTypeFlag::None;
+        }
+
+        for (const UnitTypeRow & row : unit_type_rows)
+        {
+            UnitTypeLookup & lookup = table[static_cast<uint32_t>(row.type)];
+            lookup.build_ability = row.build_ability;
+            lookup.builder = row.builder;
+            lookup.flags = row.flags;
+        }
+        return table;
+    }
+
+    const UnitTypeLookupTable unit_type_lookup = BuildUnitTypeLookup();
+    const UnitTypeLookup unknown_unit_type = { 0, 0, UnitTypeFlag::None };
+
+    const UnitTypeLookup & Lookup(const sc2::UnitTypeID & type)
+    {
+        const uint32_t index = type;
+        return index < unit_type_lookup.size() ? unit_type_lookup[index] : unknown_unit_type;
+    }
+}
 
 Util::IsUnit::IsUnit(sc2::UNIT_TYPEID type) 
     : type(type) 
@@ -13,20 +89,7 @@ Util::IsUnit::IsUnit(sc2::UNIT_TYPEID type)
 
 bool Util::IsTownHallType(const sc2::UnitTypeID & type)
 {
-    switch (type.ToType()) 
-    {
-        case sc2::UNIT_TYPEID::ZERG_HATCHERY                : return true;
-        case sc2::UNIT_TYPEID::ZERG_LAIR                    : return true;
-        case sc2::UNIT_TYPEID::ZERG_HIVE                    : return true;
-        case sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER         : return true;
-        case sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND        : return true;
-        // There is no point in treating flying buildings like the building type they are supposed to be. 
-        // You can't train units from a flying building. 
-        // case sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMANDFLYING  : return true;
-        case sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS     : return true;
-        case sc2::UNIT_TYPEID::PROTOSS_NEXUS                : return true;
-        default: return false;
-    }
+    return (Lookup(type).flags & UnitTypeFlag::TownHall) != 0;
 }
 
 bool Util::IsTownHall(const sc2::Unit* unit)
@@ -41,47 +104,17 @@ bool Util::IsRefinery(const sc2::Unit* unit)
 
 bool Util::IsRefineryType(const sc2::UnitTypeID & type)
 {
-    switch (type.ToType()) 
-    {
-        case sc2::UNIT_TYPEID::TERRAN_REFINERY      : return true;
-        case sc2::UNIT_TYPEID::PROTOSS_ASSIMILATOR  : return true;
-        case sc2::UNIT_TYPEID::ZERG_EXTRACTOR       : return true;
-        default: return false;
-    }
+    return (Lookup(type).flags & UnitTypeFlag::Refinery) != 0;
 }
 
 bool Util::IsGeyser(const sc2::Unit* unit)
 {
-    switch (unit->unit_type.ToType()) 
-    {
-        case sc2::UNIT_TYPEID::NEUTRAL_VESPENEGEYSER        : return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_PROTOSSVESPENEGEYSER : return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_SPACEPLATFORMGEYSER  : return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_PURIFIERVESPENEGEYSER: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_SHAKURASVESPENEGEYSER: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_RICHVESPENEGEYSER: return true;
-        default: return false;
-    }
+    return (Lookup(unit->unit_type).flags & UnitTypeFlag::Geyser) != 0;
 }
 
 bool Util::IsMineral(const sc2::Unit* unit)
 {
-    switch (unit->unit_type.ToType()) 
-    {
-        case sc2::UNIT_TYPEID::NEUTRAL_MINERALFIELD         : return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_MINERALFIELD750      : return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_RICHMINERALFIELD     : return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_RICHMINERALFIELD750: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_PURIFIERMINERALFIELD: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_PURIFIERMINERALFIELD750: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_PURIFIERRICHMINERALFIELD: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_PURIFIERRICHMINERALFIELD750: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_LABMINERALFIELD: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_LABMINERALFIELD750: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_BATTLESTATIONMINERALFIELD: return true;
-        case sc2::UNIT_TYPEID::NEUTRAL_BATTLESTATIONMINERALFIELD750: return true;
-        default: return false;
-    }
+    return (Lookup(unit->unit_type).flags & UnitTypeFlag::Mineral) != 0;
 }
 
 bool Util::IsWorker(const sc2::Unit* unit)
@@ -91,14 +124,7 @@ bool Util::IsWorker(const sc2::Unit* unit)
 
 bool Util::IsWorkerType(const sc2::UnitTypeID & unit)
 {
-    switch (unit.ToType()) 
-    {
-        case sc2::UNIT_TYPEID::TERRAN_SCV           : return true;
-        case sc2::UNIT_TYPEID::PROTOSS_PROBE        : return true;
-        case sc2::UNIT_TYPEID::ZERG_DRONE           : return true;
-        case sc2::UNIT_TYPEID::ZERG_DRONEBURROWED   : return true;
-        default: return false;
-    }
+    return (Lookup(unit).flags & UnitTypeFlag::Worker) != 0;
 }
 
 sc2::UnitTypeID Util::GetSupplyProvider(const sc2::Race & race)
@@ -135,22 +161,22 @@ bool Util::IsIdle(const sc2::Unit* unit)
 
 int Util::GetUnitTypeMineralPrice(const sc2::UnitTypeID type, const ByunJRBot & bot)
 {
-    return bot.Observation()->GetUnitTypeData()[type].mineral_cost;
+    return bot.UnitTypes().Get(type).mineral_cost;
 }
 
 int Util::GetUnitTypeGasPrice(const sc2::UnitTypeID type, const ByunJRBot & bot)
 {
-    return bot.Observation()->GetUnitTypeData()[type].vespene_cost;
+    return bot.UnitTypes().Get(type).gas_cost;
 }
 
 int Util::GetUnitTypeWidth(const sc2::UnitTypeID type, const ByunJRBot & bot)
 {
-    return static_cast<int>(2 * bot.Observation()->GetAbilityData()[UnitTypeIDToAbilityID(type)].footprint_radius);
+    return bot.UnitTypes().Get(type).width;
 }
 
 int Util::GetUnitTypeHeight(const sc2::UnitTypeID type, const ByunJRBot & bot)
 {
-    return static_cast<int>(2 * bot.Observation()->GetAbilityData()[UnitTypeIDToAbilityID(type)].footprint_radius);
+    return bot.UnitTypes().Get(type).height;
 }
 
 
@@ -180,55 +206,36 @@ bool Util::IsDetector(const sc2::Unit* unit)
 
 float Util::GetAttackRange(const sc2::UnitTypeID & type, ByunJRBot & bot)
 {
-    auto & weapons = bot.Observation()->GetUnitTypeData()[type].weapons;
-    
-    if (weapons.empty())
-    {
-        return 0.0f;
-    }
-
-    float max_range = 0.0f;
-    for (auto & weapon : weapons)
-    {
-        if (weapon.range > max_range)
-        {
-            max_range = weapon.range;
-        }
-    }
-
-    return max_range;
+    return bot.UnitTypes().Get(type).max_range;
 }
 
 float Util::GetAttackDamage(const sc2::UnitTypeID & type, ByunJRBot & bot)
 {
-    auto & weapons = bot.Observation()->GetUnitTypeData()[type].weapons;
+    return bot.UnitTypes().Get(type).max_damage;
+}
 
-    if (weapons.empty())
-    {
-        return 0.0f;
-    }
+// Only the weapons that can hit the target count. Some units (thors, vikings) have a different weapon for air and ground.
+float Util::GetAttackRange(const sc2::UnitTypeID & type, const bool target_is_flying, ByunJRBot & bot)
+{
+    const UnitTypeTraits & traits = bot.UnitTypes().Get(type);
+    return target_is_flying ? traits.air_range : traits.ground_range;
+}
 
-    float max_damage = 0.0f;
-    for (auto & weapon : weapons)
-    {
-        max_damage = weapon.damage_ * weapon.attacks;
-    }
+// Damage per second against a target with no armor. Speed is the time between attacks.
+float Util::GetDPS(const sc2::UnitTypeID & type, const bool target_is_flying, ByunJRBot & bot)
+{
+    const UnitTypeTraits & traits = bot.UnitTypes().Get(type);
+    return target_is_flying ? traits.air_dps : traits.ground_dps;
+}
 
-    return max_damage;
+bool Util::CanAttackAir(const sc2::UnitTypeID & type, const ByunJRBot & bot)
+{
+    return bot.UnitTypes().Get(type).can_attack_air;
 }
 
 bool Util::IsDetectorType(const sc2::UnitTypeID & type)
 {
-    switch (type.ToType())
-    {
-    case sc2::UNIT_TYPEID::PROTOSS_OBSERVER: return true;
-    case sc2::UNIT_TYPEID::TERRAN_RAVEN: return true;
-    case sc2::UNIT_TYPEID::ZERG_OVERSEER: return true;
-    case sc2::UNIT_TYPEID::TERRAN_MISSILETURRET: return true;
-    case sc2::UNIT_TYPEID::ZERG_SPORECRAWLER: return true;
-    case sc2::UNIT_TYPEID::PROTOSS_PHOTONCANNON: return true;
-    default: return false;
-    }
+    return (Lookup(type).flags & UnitTypeFlag::Detector) != 0;
 }
 
 PlayerArrayIndex Util::GetPlayer(const sc2::Unit* unit)
@@ -254,14 +261,7 @@ PlayerArrayIndex Util::GetPlayer(const sc2::Unit* unit)
 
 bool Util::IsCombatUnitType(const sc2::UnitTypeID type)
 {
-    if (IsWorkerType(type)) { return false; }
-    if (IsSupplyProviderType(type)) { return false; }
-    if (IsBuilding(type)) { return false; }
-
-    if (type == sc2::UNIT_TYPEID::ZERG_EGG) { return false; }
-    if (type == sc2::UNIT_TYPEID::ZERG_LARVA) { return false; }
-
-    return true;
+    return (Lookup(type).flags & non_combat_flags) == 0;
 }
 
 bool Util::IsCombatUnit(const sc2::Unit* unit)
@@ -271,15 +271,7 @@ bool Util::IsCombatUnit(const sc2::Unit* unit)
 
 bool Util::IsSupplyProviderType(const sc2::UnitTypeID type)
 {
-    switch (type.ToType()) 
-    {
-        case sc2::UNIT_TYPEID::ZERG_OVERLORD                : return true;
-        case sc2::UNIT_TYPEID::PROTOSS_PYLON                : return true;
-        case sc2::UNIT_TYPEID::PROTOSS_PYLONOVERCHARGED     : return true;
-        case sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT           : return true;
-        case sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED    : return true;
-        default: return false;
-    }
+    return (Lookup(type).flags & UnitTypeFlag::SupplyProvider) != 0;
 }
 
 bool Util::IsSupplyProvider(const sc2::Unit* unit)
@@ -386,130 +378,13 @@ sc2::Race Util::GetRaceFromString(const std::string & race_in)
 
 sc2::UnitTypeID Util::WhatBuilds(const sc2::UnitTypeID & type)
 {
-    switch (type.ToType()) 
-    {
-        case sc2::UNIT_TYPEID::PROTOSS_ASSIMILATOR:         return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_CYBERNETICSCORE:     return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_DARKSHRINE:          return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_PYLON:               return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_NEXUS:               return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_FLEETBEACON:         return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_FORGE:               return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_GATEWAY:             return sc2::UNIT_TYPEID::PROTOSS_PROBE;  
-        case sc2::UNIT_TYPEID::PROTOSS_STARGATE:            return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_PHOTONCANNON:        return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_ROBOTICSBAY:         return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_ROBOTICSFACILITY:    return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_TEMPLARARCHIVE:      return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_TWILIGHTCOUNCIL:     return sc2::UNIT_TYPEID::PROTOSS_PROBE; 
-        case sc2::UNIT_TYPEID::PROTOSS_PROBE:               return sc2::UNIT_TYPEID::PROTOSS_NEXUS; 
-        case sc2::UNIT_TYPEID::PROTOSS_MOTHERSHIPCORE:      return sc2::UNIT_TYPEID::PROTOSS_NEXUS; 
-        case sc2::UNIT_TYPEID::PROTOSS_ZEALOT:              return sc2::UNIT_TYPEID::PROTOSS_GATEWAY; 
-        case sc2::UNIT_TYPEID::PROTOSS_SENTRY:              return sc2::UNIT_TYPEID::PROTOSS_GATEWAY;  
-        case sc2::UNIT_TYPEID::PROTOSS_STALKER:             return sc2::UNIT_TYPEID::PROTOSS_GATEWAY; 
-        case sc2::UNIT_TYPEID::PROTOSS_HIGHTEMPLAR:         return sc2::UNIT_TYPEID::PROTOSS_GATEWAY; 
-        case sc2::UNIT_TYPEID::PROTOSS_DARKTEMPLAR:         return sc2::UNIT_TYPEID::PROTOSS_GATEWAY; 
-        case sc2::UNIT_TYPEID::PROTOSS_ADEPT:               return sc2::UNIT_TYPEID::PROTOSS_GATEWAY; 
-        case sc2::UNIT_TYPEID::PROTOSS_COLOSSUS:            return sc2::UNIT_TYPEID::PROTOSS_ROBOTICSFACILITY; 
-        case sc2::UNIT_TYPEID::PROTOSS_DISRUPTOR:           return sc2::UNIT_TYPEID::PROTOSS_ROBOTICSFACILITY; 
-        case sc2::UNIT_TYPEID::PROTOSS_WARPPRISM:           return sc2::UNIT_TYPEID::PROTOSS_ROBOTICSFACILITY; 
-        case sc2::UNIT_TYPEID::PROTOSS_OBSERVER:            return sc2::UNIT_TYPEID::PROTOSS_ROBOTICSFACILITY;
-        case sc2::UNIT_TYPEID::PROTOSS_IMMORTAL:            return sc2::UNIT_TYPEID::PROTOSS_ROBOTICSFACILITY;
-        case sc2::UNIT_TYPEID::PROTOSS_CARRIER:             return sc2::UNIT_TYPEID::PROTOSS_STARGATE;  
-        case sc2::UNIT_TYPEID::PROTOSS_ORACLE:              return sc2::UNIT_TYPEID::PROTOSS_STARGATE; 
-        case sc2::UNIT_TYPEID::PROTOSS_PHOENIX:             return sc2::UNIT_TYPEID::PROTOSS_STARGATE; 
-        case sc2::UNIT_TYPEID::PROTOSS_VOIDRAY:             return sc2::UNIT_TYPEID::PROTOSS_STARGATE;  
-        case sc2::UNIT_TYPEID::PROTOSS_TEMPEST:             return sc2::UNIT_TYPEID::PROTOSS_STARGATE;
-        case sc2::UNIT_TYPEID::PROTOSS_INTERCEPTOR:         return sc2::UNIT_TYPEID::PROTOSS_CARRIER; 
-        case sc2::UNIT_TYPEID::PROTOSS_ORACLESTASISTRAP:    return sc2::UNIT_TYPEID::PROTOSS_ORACLE; 
-        case sc2::UNIT_TYPEID::TERRAN_ARMORY:               return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_BARRACKS:             return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_BARRACKSREACTOR:      return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_REFINERY:             return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_SENSORTOWER:          return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_FACTORY:              return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_FUSIONCORE:           return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_STARPORT:             return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT:          return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_GHOSTACADEMY:         return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_BUNKER:               return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER:        return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_ENGINEERINGBAY:       return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_MISSILETURRET:        return sc2::UNIT_TYPEID::TERRAN_SCV; 
-        case sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND:       return sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER; 
-        case sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS:    return sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER;
-        case sc2::UNIT_TYPEID::TERRAN_SCV:                  return sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER; 
-        case sc2::UNIT_TYPEID::TERRAN_BARRACKSTECHLAB:      return sc2::UNIT_TYPEID::TERRAN_BARRACKS; 
-        case sc2::UNIT_TYPEID::TERRAN_GHOST:                return sc2::UNIT_TYPEID::TERRAN_BARRACKS; 
-        case sc2::UNIT_TYPEID::TERRAN_MARAUDER:             return sc2::UNIT_TYPEID::TERRAN_BARRACKS; 
-        case sc2::UNIT_TYPEID::TERRAN_MARINE:               return sc2::UNIT_TYPEID::TERRAN_BARRACKS;
-        case sc2::UNIT_TYPEID::TERRAN_REAPER:               return sc2::UNIT_TYPEID::TERRAN_BARRACKS;
-        case sc2::UNIT_TYPEID::TERRAN_FACTORYREACTOR:       return sc2::UNIT_TYPEID::TERRAN_FACTORY; 
-        case sc2::UNIT_TYPEID::TERRAN_FACTORYTECHLAB:       return sc2::UNIT_TYPEID::TERRAN_FACTORY; 
-        case sc2::UNIT_TYPEID::TERRAN_HELLION:              return sc2::UNIT_TYPEID::TERRAN_FACTORY; 
-        case sc2::UNIT_TYPEID::TERRAN_CYCLONE:              return sc2::UNIT_TYPEID::TERRAN_FACTORY;  
-        case sc2::UNIT_TYPEID::TERRAN_SIEGETANK:            return sc2::UNIT_TYPEID::TERRAN_FACTORY; 
-        case sc2::UNIT_TYPEID::TERRAN_THOR:                 return sc2::UNIT_TYPEID::TERRAN_FACTORY;  
-        case sc2::UNIT_TYPEID::TERRAN_WIDOWMINE:            return sc2::UNIT_TYPEID::TERRAN_FACTORY; 
-        case sc2::UNIT_TYPEID::TERRAN_NUKE:                 return sc2::UNIT_TYPEID::TERRAN_GHOSTACADEMY; 
-        case sc2::UNIT_TYPEID::TERRAN_STARPORTREACTOR:      return sc2::UNIT_TYPEID::TERRAN_STARPORT; 
-        case sc2::UNIT_TYPEID::TERRAN_STARPORTTECHLAB:      return sc2::UNIT_TYPEID::TERRAN_STARPORT; 
-        case sc2::UNIT_TYPEID::TERRAN_BANSHEE:              return sc2::UNIT_TYPEID::TERRAN_STARPORT; 
-        case sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER:        return sc2::UNIT_TYPEID::TERRAN_STARPORT; 
-        case sc2::UNIT_TYPEID::TERRAN_LIBERATOR:            return sc2::UNIT_TYPEID::TERRAN_STARPORT; 
-        case sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER:        return sc2::UNIT_TYPEID::TERRAN_STARPORT; 
-        case sc2::UNIT_TYPEID::TERRAN_RAVEN:                return sc2::UNIT_TYPEID::TERRAN_STARPORT; 
-        case sc2::UNIT_TYPEID::TERRAN_MEDIVAC:              return sc2::UNIT_TYPEID::TERRAN_STARPORT; 
-        case sc2::UNIT_TYPEID::ZERG_HATCHERY:               return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_EVOLUTIONCHAMBER:       return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_EXTRACTOR:              return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_BANELINGNEST:           return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_HYDRALISKDEN:           return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_INFESTATIONPIT:         return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_NYDUSCANAL:             return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_NYDUSNETWORK:           return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_ROACHWARREN:            return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_SPAWNINGPOOL:           return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_SPINECRAWLER:           return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_SPIRE:                  return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_SPORECRAWLER:           return sc2::UNIT_TYPEID::ZERG_DRONE;
-        case sc2::UNIT_TYPEID::ZERG_ULTRALISKCAVERN:        return sc2::UNIT_TYPEID::ZERG_DRONE; 
-        case sc2::UNIT_TYPEID::ZERG_OVERLORD:               return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_BANELING:               return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_CORRUPTOR:              return sc2::UNIT_TYPEID::ZERG_LARVA;
-        case sc2::UNIT_TYPEID::ZERG_DRONE:                  return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_HYDRALISK:              return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_INFESTOR:               return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_MUTALISK:               return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_QUEEN:                  return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_ROACH:                  return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_SWARMHOSTMP:            return sc2::UNIT_TYPEID::ZERG_LARVA;
-        case sc2::UNIT_TYPEID::ZERG_ULTRALISK:              return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_VIPER:                  return sc2::UNIT_TYPEID::ZERG_LARVA; 
-        case sc2::UNIT_TYPEID::ZERG_ZERGLING:               return sc2::UNIT_TYPEID::ZERG_LARVA;
-        case sc2::UNIT_TYPEID::ZERG_LAIR:                   return sc2::UNIT_TYPEID::ZERG_HATCHERY;
-        case sc2::UNIT_TYPEID::ZERG_HIVE:                   return sc2::UNIT_TYPEID::ZERG_LAIR;  
-        case sc2::UNIT_TYPEID::ZERG_GREATERSPIRE:           return sc2::UNIT_TYPEID::ZERG_SPIRE; 
-       
-        default: return 0;
-    }
+    return Lookup(type).builder;
 }
 
 int Util::EnemyDPSInRange(const sc2::Point3D unit_pos, ByunJRBot & bot)
 {
-    float total_dps = 0;
-    for (auto & enemyunit : bot.InformationManager().UnitInfo().GetUnits(PlayerArrayIndex::Enemy))
-    {
-        double dist = Util::Dist(enemyunit->pos, unit_pos);
-        double range = GetAttackRange(enemyunit->unit_type, bot);
-        // if we are in range, the dps that is coming at us increases.
-        if (dist < range+0.5f)
-        {
-            total_dps += GetAttackDamage(enemyunit->unit_type, bot);
-        }
-    }
-
-    return total_dps;
+    // if we are in range, the dps that is coming at us increases.
+    return static_cast<int>(bot.InformationManager().UnitInfo().GetUnitArrays(PlayerArrayIndex::Enemy).DamageInRange(unit_pos, 0.5f));
 }
 
 sc2::UnitTypeID Util::GetUnitTypeIDFromName(const sc2::ObservationInterface * obs, const std::string & name)
@@ -561,125 +436,10 @@ bool Util::IsMorphCommand(const sc2::AbilityID & ability)
 
 sc2::AbilityID Util::UnitTypeIDToAbilityID(const sc2::UnitTypeID & id)
 {
-    switch (id.ToType()) 
-    {
-        case sc2::UNIT_TYPEID::TERRAN_ARMORY: return sc2::ABILITY_ID::BUILD_ARMORY; 
-        case sc2::UNIT_TYPEID::PROTOSS_ASSIMILATOR: return sc2::ABILITY_ID::BUILD_ASSIMILATOR; 
-        case sc2::UNIT_TYPEID::ZERG_BANELINGNEST: return sc2::ABILITY_ID::BUILD_BANELINGNEST; 
-        case sc2::UNIT_TYPEID::TERRAN_BARRACKS: return sc2::ABILITY_ID::BUILD_BARRACKS; 
-        case sc2::UNIT_TYPEID::TERRAN_BARRACKSREACTOR: return sc2::ABILITY_ID::BUILD_REACTOR_BARRACKS; 
-        case sc2::UNIT_TYPEID::TERRAN_BARRACKSTECHLAB: return sc2::ABILITY_ID::BUILD_TECHLAB;
-        case sc2::UNIT_TYPEID::TERRAN_TECHLAB: return sc2::ABILITY_ID::BUILD_TECHLAB;
-        case sc2::UNIT_TYPEID::TERRAN_BUNKER: return sc2::ABILITY_ID::BUILD_BUNKER; 
-        case sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER: return sc2::ABILITY_ID::BUILD_COMMANDCENTER; 
-        case sc2::UNIT_TYPEID::PROTOSS_CYBERNETICSCORE: return sc2::ABILITY_ID::BUILD_CYBERNETICSCORE; 
-        case sc2::UNIT_TYPEID::PROTOSS_DARKSHRINE: return sc2::ABILITY_ID::BUILD_DARKSHRINE; 
-        case sc2::UNIT_TYPEID::TERRAN_ENGINEERINGBAY: return sc2::ABILITY_ID::BUILD_ENGINEERINGBAY; 
-        case sc2::UNIT_TYPEID::ZERG_EVOLUTIONCHAMBER: return sc2::ABILITY_ID::BUILD_EVOLUTIONCHAMBER; 
-        case sc2::UNIT_TYPEID::ZERG_EXTRACTOR: return sc2::ABILITY_ID::BUILD_EXTRACTOR; 
-        case sc2::UNIT_TYPEID::TERRAN_FACTORY: return sc2::ABILITY_ID::BUILD_FACTORY; 
-        case sc2::UNIT_TYPEID::TERRAN_FACTORYREACTOR: return sc2::ABILITY_ID::BUILD_REACTOR_FACTORY; 
-        case sc2::UNIT_TYPEID::TERRAN_FACTORYTECHLAB: return sc2::ABILITY_ID::BUILD_TECHLAB;
-        case sc2::UNIT_TYPEID::PROTOSS_FLEETBEACON: return sc2::ABILITY_ID::BUILD_FLEETBEACON; 
-        case sc2::UNIT_TYPEID::PROTOSS_FORGE: return sc2::ABILITY_ID::BUILD_FORGE; 
-        case sc2::UNIT_TYPEID::TERRAN_FUSIONCORE: return sc2::ABILITY_ID::BUILD_FUSIONCORE; 
-        case sc2::UNIT_TYPEID::PROTOSS_GATEWAY: return sc2::ABILITY_ID::BUILD_GATEWAY; 
-        case sc2::UNIT_TYPEID::TERRAN_GHOSTACADEMY: return sc2::ABILITY_ID::BUILD_GHOSTACADEMY; 
-        case sc2::UNIT_TYPEID::ZERG_HATCHERY: return sc2::ABILITY_ID::BUILD_HATCHERY; 
-        case sc2::UNIT_TYPEID::ZERG_HYDRALISKDEN: return sc2::ABILITY_ID::BUILD_HYDRALISKDEN; 
-        case sc2::UNIT_TYPEID::ZERG_INFESTATIONPIT: return sc2::ABILITY_ID::BUILD_INFESTATIONPIT; 
-        case sc2::UNIT_TYPEID::PROTOSS_INTERCEPTOR: return sc2::ABILITY_ID::BUILD_INTERCEPTORS; 
-        case sc2::UNIT_TYPEID::TERRAN_MISSILETURRET: return sc2::ABILITY_ID::BUILD_MISSILETURRET; 
-        case sc2::UNIT_TYPEID::PROTOSS_NEXUS: return sc2::ABILITY_ID::BUILD_NEXUS; 
-        case sc2::UNIT_TYPEID::TERRAN_NUKE: return sc2::ABILITY_ID::BUILD_NUKE; 
-        case sc2::UNIT_TYPEID::ZERG_NYDUSCANAL: return sc2::ABILITY_ID::BUILD_NYDUSWORM; 
-        case sc2::UNIT_TYPEID::ZERG_NYDUSNETWORK: return sc2::ABILITY_ID::BUILD_NYDUSNETWORK; 
-        case sc2::UNIT_TYPEID::PROTOSS_ORACLESTASISTRAP: return sc2::ABILITY_ID::BUILD_STASISTRAP; 
-        case sc2::UNIT_TYPEID::PROTOSS_PHOTONCANNON: return sc2::ABILITY_ID::BUILD_PHOTONCANNON; 
-        case sc2::UNIT_TYPEID::PROTOSS_PYLON: return sc2::ABILITY_ID::BUILD_PYLON; 
-        //return sc2::ABILITY_ID::BUILD_QUEEN_CREEPTUMOR; case sc2::UNIT_TYPEID::ZERG_CREEPTUMORQUEEN: 
-        case sc2::UNIT_TYPEID::TERRAN_REFINERY: return sc2::ABILITY_ID::BUILD_REFINERY; 
-        case sc2::UNIT_TYPEID::ZERG_ROACHWARREN: return sc2::ABILITY_ID::BUILD_ROACHWARREN; 
-        case sc2::UNIT_TYPEID::PROTOSS_ROBOTICSBAY: return sc2::ABILITY_ID::BUILD_ROBOTICSBAY; 
-        case sc2::UNIT_TYPEID::PROTOSS_ROBOTICSFACILITY: return sc2::ABILITY_ID::BUILD_ROBOTICSFACILITY; 
-        case sc2::UNIT_TYPEID::TERRAN_SENSORTOWER: return sc2::ABILITY_ID::BUILD_SENSORTOWER; 
-        case sc2::UNIT_TYPEID::ZERG_SPAWNINGPOOL: return sc2::ABILITY_ID::BUILD_SPAWNINGPOOL; 
-        case sc2::UNIT_TYPEID::ZERG_SPINECRAWLER: return sc2::ABILITY_ID::BUILD_SPINECRAWLER; 
-        case sc2::UNIT_TYPEID::ZERG_SPIRE: return sc2::ABILITY_ID::BUILD_SPIRE; 
-        case sc2::UNIT_TYPEID::ZERG_SPORECRAWLER: return sc2::ABILITY_ID::BUILD_SPORECRAWLER; 
-        case sc2::UNIT_TYPEID::PROTOSS_STARGATE: return sc2::ABILITY_ID::BUILD_STARGATE; 
-        case sc2::UNIT_TYPEID::TERRAN_STARPORT: return sc2::ABILITY_ID::BUILD_STARPORT; 
-        case sc2::UNIT_TYPEID::TERRAN_STARPORTREACTOR: return sc2::ABILITY_ID::BUILD_REACTOR_STARPORT; 
-        case sc2::UNIT_TYPEID::TERRAN_STARPORTTECHLAB: return sc2::ABILITY_ID::BUILD_TECHLAB;
-        case sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT: return sc2::ABILITY_ID::BUILD_SUPPLYDEPOT; 
-        case sc2::UNIT_TYPEID::PROTOSS_TEMPLARARCHIVE: return sc2::ABILITY_ID::BUILD_TEMPLARARCHIVE; 
-        case sc2::UNIT_TYPEID::PROTOSS_TWILIGHTCOUNCIL: return sc2::ABILITY_ID::BUILD_TWILIGHTCOUNCIL; 
-        case sc2::UNIT_TYPEID::ZERG_ULTRALISKCAVERN: return sc2::ABILITY_ID::BUILD_ULTRALISKCAVERN; 
-        case sc2::UNIT_TYPEID::ZERG_HIVE: return sc2::ABILITY_ID::MORPH_HIVE; 
-        case sc2::UNIT_TYPEID::ZERG_LAIR: return sc2::ABILITY_ID::MORPH_LAIR; 
-        case sc2::UNIT_TYPEID::ZERG_GREATERSPIRE: return sc2::ABILITY_ID::MORPH_GREATERSPIRE; 
-        case sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND: return sc2::ABILITY_ID::MORPH_ORBITALCOMMAND; 
-        case sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS: return sc2::ABILITY_ID::MORPH_PLANETARYFORTRESS; 
-        case sc2::UNIT_TYPEID::ZERG_OVERLORD: return sc2::ABILITY_ID::TRAIN_OVERLORD; 
-        /*case sc2::UNIT_TYPEID::PROTOSS_DARKTEMPLAR: return sc2::ABILITY_ID::TRAINWARP_DARKTEMPLAR; 
-        case sc2::UNIT_TYPEID::PROTOSS_HIGHTEMPLAR: return sc2::ABILITY_ID::TRAINWARP_HIGHTEMPLAR; 
-        case sc2::UNIT_TYPEID::PROTOSS_SENTRY: return sc2::ABILITY_ID::TRAINWARP_SENTRY; 
-        case sc2::UNIT_TYPEID::PROTOSS_STALKER: return sc2::ABILITY_ID::TRAINWARP_STALKER; 
-        case sc2::UNIT_TYPEID::PROTOSS_ADEPT: return sc2::ABILITY_ID::TRAINWARP_WARPINADEPT; 
-        case sc2::UNIT_TYPEID::PROTOSS_ZEALOT: return sc2::ABILITY_ID::TRAINWARP_ZEALOT; */
-        case sc2::UNIT_TYPEID::ZERG_BANELING: return sc2::ABILITY_ID::TRAIN_BANELING; 
-        case sc2::UNIT_TYPEID::TERRAN_BANSHEE: return sc2::ABILITY_ID::TRAIN_BANSHEE; 
-        case sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER: return sc2::ABILITY_ID::TRAIN_BATTLECRUISER; 
-        case sc2::UNIT_TYPEID::TERRAN_CYCLONE: return sc2::ABILITY_ID::TRAIN_CYCLONE; 
-        case sc2::UNIT_TYPEID::PROTOSS_CARRIER: return sc2::ABILITY_ID::TRAIN_CARRIER; 
-        case sc2::UNIT_TYPEID::PROTOSS_COLOSSUS: return sc2::ABILITY_ID::TRAIN_COLOSSUS; 
-        case sc2::UNIT_TYPEID::ZERG_CORRUPTOR: return sc2::ABILITY_ID::TRAIN_CORRUPTOR;
-        case sc2::UNIT_TYPEID::PROTOSS_DARKTEMPLAR: return sc2::ABILITY_ID::TRAIN_DARKTEMPLAR; 
-        case sc2::UNIT_TYPEID::ZERG_DRONE: return sc2::ABILITY_ID::TRAIN_DRONE; 
-        case sc2::UNIT_TYPEID::TERRAN_GHOST: return sc2::ABILITY_ID::TRAIN_GHOST; 
-        case sc2::UNIT_TYPEID::TERRAN_HELLION: return sc2::ABILITY_ID::TRAIN_HELLION; 
-        //case sc2::UNIT_TYPEID::TERRAN_HELLION: return sc2::ABILITY_ID::TRAIN_HELLIONTANK; 
-        case sc2::UNIT_TYPEID::PROTOSS_HIGHTEMPLAR: return sc2::ABILITY_ID::TRAIN_HIGHTEMPLAR; 
-        case sc2::UNIT_TYPEID::ZERG_HYDRALISK: return sc2::ABILITY_ID::TRAIN_HYDRALISK; 
-        case sc2::UNIT_TYPEID::PROTOSS_IMMORTAL: return sc2::ABILITY_ID::TRAIN_IMMORTAL;
-        case sc2::UNIT_TYPEID::ZERG_INFESTOR: return sc2::ABILITY_ID::TRAIN_INFESTOR; 
-        case sc2::UNIT_TYPEID::TERRAN_LIBERATOR: return sc2::ABILITY_ID::TRAIN_LIBERATOR; 
-        case sc2::UNIT_TYPEID::TERRAN_MARAUDER: return sc2::ABILITY_ID::TRAIN_MARAUDER; 
-        case sc2::UNIT_TYPEID::TERRAN_MARINE: return sc2::ABILITY_ID::TRAIN_MARINE; 
-        case sc2::UNIT_TYPEID::TERRAN_MEDIVAC: return sc2::ABILITY_ID::TRAIN_MEDIVAC; 
-        case sc2::UNIT_TYPEID::PROTOSS_MOTHERSHIPCORE: return sc2::ABILITY_ID::TRAIN_MOTHERSHIPCORE; 
-        case sc2::UNIT_TYPEID::ZERG_MUTALISK: return sc2::ABILITY_ID::TRAIN_MUTALISK; 
-        case sc2::UNIT_TYPEID::PROTOSS_OBSERVER: return sc2::ABILITY_ID::TRAIN_OBSERVER; 
-        case sc2::UNIT_TYPEID::PROTOSS_ORACLE: return sc2::ABILITY_ID::TRAIN_ORACLE; 
-        case sc2::UNIT_TYPEID::PROTOSS_PHOENIX: return sc2::ABILITY_ID::TRAIN_PHOENIX; 
-        case sc2::UNIT_TYPEID::PROTOSS_PROBE: return sc2::ABILITY_ID::TRAIN_PROBE; 
-        case sc2::UNIT_TYPEID::ZERG_QUEEN: return sc2::ABILITY_ID::TRAIN_QUEEN; 
-        case sc2::UNIT_TYPEID::TERRAN_RAVEN: return sc2::ABILITY_ID::TRAIN_RAVEN; 
-        case sc2::UNIT_TYPEID::TERRAN_REAPER: return sc2::ABILITY_ID::TRAIN_REAPER;
-        case sc2::UNIT_TYPEID::ZERG_ROACH: return sc2::ABILITY_ID::TRAIN_ROACH; 
-        case sc2::UNIT_TYPEID::TERRAN_SCV: return sc2::ABILITY_ID::TRAIN_SCV; 
-        case sc2::UNIT_TYPEID::PROTOSS_SENTRY: return sc2::ABILITY_ID::TRAIN_SENTRY; 
-        case sc2::UNIT_TYPEID::TERRAN_SIEGETANK: return sc2::ABILITY_ID::TRAIN_SIEGETANK; 
-        case sc2::UNIT_TYPEID::PROTOSS_STALKER: return sc2::ABILITY_ID::TRAIN_STALKER; 
-        case sc2::UNIT_TYPEID::ZERG_SWARMHOSTMP: return sc2::ABILITY_ID::TRAIN_SWARMHOST; 
-        case sc2::UNIT_TYPEID::PROTOSS_TEMPEST: return sc2::ABILITY_ID::TRAIN_TEMPEST; 
-        case sc2::UNIT_TYPEID::TERRAN_THOR: return sc2::ABILITY_ID::TRAIN_THOR; 
-        case sc2::UNIT_TYPEID::ZERG_ULTRALISK: return sc2::ABILITY_ID::TRAIN_ULTRALISK; 
-        case sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER: return sc2::ABILITY_ID::TRAIN_VIKINGFIGHTER; 
-        case sc2::UNIT_TYPEID::ZERG_VIPER: return sc2::ABILITY_ID::TRAIN_VIPER; 
-        case sc2::UNIT_TYPEID::PROTOSS_VOIDRAY: return sc2::ABILITY_ID::TRAIN_VOIDRAY; 
-        case sc2::UNIT_TYPEID::PROTOSS_ADEPT: return sc2::ABILITY_ID::TRAIN_ADEPT; 
-        case sc2::UNIT_TYPEID::PROTOSS_DISRUPTOR: return sc2::ABILITY_ID::TRAIN_DISRUPTOR; 
-        case sc2::UNIT_TYPEID::PROTOSS_WARPPRISM: return sc2::ABILITY_ID::TRAIN_WARPPRISM; 
-        case sc2::UNIT_TYPEID::TERRAN_WIDOWMINE: return sc2::ABILITY_ID::TRAIN_WIDOWMINE; 
-        case sc2::UNIT_TYPEID::PROTOSS_ZEALOT: return sc2::ABILITY_ID::TRAIN_ZEALOT; 
-        case sc2::UNIT_TYPEID::ZERG_ZERGLING: return sc2::ABILITY_ID::TRAIN_ZERGLING; 
-
-        default: return 0;
-    }
+    return Lookup(id).build_ability;
 }
 
-bool Util::CanAttackAir(std::vector<sc2::Weapon> weapons)
+bool Util::CanAttackAir(const std::vector<sc2::Weapon> & weapons)
 {
     for(auto const &  w : weapons)
     {
@@ -695,63 +455,7 @@ int Util::GetGameTimeInSeconds(const sc2::Agent& bot)
 
 bool Util::IsBuilding(const sc2::UnitTypeID & type)
 {
-    switch (type.ToType()) 
-    {
-        case sc2::UNIT_TYPEID::TERRAN_ARMORY:           return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_ASSIMILATOR:     return true; 
-        case sc2::UNIT_TYPEID::ZERG_BANELINGNEST:       return true; 
-        case sc2::UNIT_TYPEID::TERRAN_BARRACKS:         return true; 
-        case sc2::UNIT_TYPEID::TERRAN_BARRACKSREACTOR:  return true; 
-        case sc2::UNIT_TYPEID::TERRAN_BARRACKSTECHLAB:  return true; 
-        case sc2::UNIT_TYPEID::TERRAN_BUNKER:           return true; 
-        case sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER:    return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_CYBERNETICSCORE: return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_DARKSHRINE:      return true; 
-        case sc2::UNIT_TYPEID::TERRAN_ENGINEERINGBAY:   return true; 
-        case sc2::UNIT_TYPEID::ZERG_EVOLUTIONCHAMBER:   return true; 
-        case sc2::UNIT_TYPEID::ZERG_EXTRACTOR:          return true; 
-        case sc2::UNIT_TYPEID::TERRAN_FACTORY:          return true; 
-        case sc2::UNIT_TYPEID::TERRAN_FACTORYREACTOR:   return true; 
-        case sc2::UNIT_TYPEID::TERRAN_FACTORYTECHLAB:   return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_FLEETBEACON:     return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_FORGE:           return true; 
-        case sc2::UNIT_TYPEID::TERRAN_FUSIONCORE:       return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_GATEWAY:         return true; 
-        case sc2::UNIT_TYPEID::TERRAN_GHOSTACADEMY:     return true; 
-        case sc2::UNIT_TYPEID::ZERG_HATCHERY:           return true; 
-        case sc2::UNIT_TYPEID::ZERG_HYDRALISKDEN:       return true; 
-        case sc2::UNIT_TYPEID::ZERG_INFESTATIONPIT:     return true; 
-        case sc2::UNIT_TYPEID::TERRAN_MISSILETURRET:    return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_NEXUS:           return true; 
-        case sc2::UNIT_TYPEID::ZERG_NYDUSCANAL:         return true; 
-        case sc2::UNIT_TYPEID::ZERG_NYDUSNETWORK:       return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_PHOTONCANNON:    return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_PYLON:           return true; 
-        case sc2::UNIT_TYPEID::TERRAN_REFINERY:         return true; 
-        case sc2::UNIT_TYPEID::ZERG_ROACHWARREN:        return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_ROBOTICSBAY:     return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_ROBOTICSFACILITY: return true; 
-        case sc2::UNIT_TYPEID::TERRAN_SENSORTOWER:      return true; 
-        case sc2::UNIT_TYPEID::ZERG_SPAWNINGPOOL:       return true; 
-        case sc2::UNIT_TYPEID::ZERG_SPINECRAWLER:       return true; 
-        case sc2::UNIT_TYPEID::ZERG_SPIRE:              return true; 
-        case sc2::UNIT_TYPEID::ZERG_SPORECRAWLER:       return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_STARGATE:        return true; 
-        case sc2::UNIT_TYPEID::TERRAN_STARPORT:         return true; 
-        case sc2::UNIT_TYPEID::TERRAN_STARPORTREACTOR:  return true; 
-        case sc2::UNIT_TYPEID::TERRAN_STARPORTTECHLAB:  return true; 
-        case sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT:      return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_TEMPLARARCHIVE:  return true; 
-        case sc2::UNIT_TYPEID::PROTOSS_TWILIGHTCOUNCIL: return true; 
-        case sc2::UNIT_TYPEID::ZERG_ULTRALISKCAVERN:    return true; 
-        case sc2::UNIT_TYPEID::ZERG_HIVE:               return true; 
-        case sc2::UNIT_TYPEID::ZERG_LAIR:               return true; 
-        case sc2::UNIT_TYPEID::ZERG_GREATERSPIRE:       return true; 
-        case sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND:   return true; 
-        case sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS: return true;  
-
-        default: return false;
-    }
+    return (Lookup(type).flags & UnitTypeFlag::Building) != 0;
 }
 
 // checks where a given unit can make a given unit type now
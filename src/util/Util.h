@@ -33,6 +33,8 @@ namespace Util
     bool IsCompleted(const sc2::Unit* unit);
     float GetAttackRange(const sc2::UnitTypeID & type, ByunJRBot & bot);
     float GetAttackDamage(const sc2::UnitTypeID & type, ByunJRBot & bot);
+    float GetAttackRange(const sc2::UnitTypeID & type, bool target_is_flying, ByunJRBot & bot);
+    float GetDPS(const sc2::UnitTypeID & type, bool target_is_flying, ByunJRBot & bot);
     
     bool UnitCanBuildTypeNow(const sc2::Unit* unit, const sc2::UnitTypeID & type, ByunJRBot & bot);
     sc2::UnitTypeID WhatBuilds(const sc2::UnitTypeID & type);
@@ -61,6 +63,7 @@ namespace Util
     bool    IsBuilding(const sc2::UnitTypeID & type);
     bool    IsMorphCommand(const sc2::AbilityID & ability);
     sc2::AbilityID  UnitTypeIDToAbilityID(const sc2::UnitTypeID & id);
-    bool CanAttackAir(std::vector<sc2::Weapon> weapons);
+    bool CanAttackAir(const std::vector<sc2::Weapon> & weapons);
+    bool CanAttackAir(const sc2::UnitTypeID & type, const ByunJRBot & bot);
     int  GetGameTimeInSeconds(const sc2::Agent& bot);
 };